@@ -123,7 +123,7 @@ Void TAppDecTop::decode()
   Bool openedReconFile = false; // reconstruction file not yet opened. (must be performed after SPS is seen)
   Bool loopFiltered = false;
 
-  while (!!bitstreamFile)
+  while (!bytestream.isEndOfStream())
   {
     /* location serves to work around a design fault in the decoder, whereby
      * the process of reading a new slice that is the first slice of a new frame
@@ -131,10 +131,8 @@ Void TAppDecTop::decode()
      * nal unit. */
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
     TComCodingStatistics::TComCodingStatisticsData backupStats(TComCodingStatistics::GetStatistics());
-    streampos location = bitstreamFile.tellg() - streampos(bytestream.GetNumBufferedBytes());
-#else
-    streampos location = bitstreamFile.tellg();
 #endif
+    const Int64 location = bytestream.getPosition();
     AnnexBStats stats = AnnexBStats();
 
     vector<uint8_t> nalUnit;
@@ -164,31 +162,25 @@ Void TAppDecTop::decode()
         bNewPicture = m_cTDecTop.decode(nalu, m_iSkipFrame, m_iPOCLastDisplay);
         if (bNewPicture)
         {
-          bitstreamFile.clear();
-          /* location points to the current nalunit payload[1] due to the
-           * need for the annexB parser to read three extra bytes.
-           * [1] except for the first NAL unit in the file
-           *     (but bNewPicture doesn't happen then) */
+          /* location is the start of the current nal unit (including any
+           * leading zero bytes and its start code prefix); this is normally
+           * still held in the bytestream buffer, so no file seek is needed */
+          bytestream.setPosition(location);
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
-          bitstreamFile.seekg(location);
-          bytestream.reset();
           TComCodingStatistics::SetStatistics(backupStats);
-#else
-          bitstreamFile.seekg(location-streamoff(3));
-          bytestream.reset();
 #endif
         }
       }
     }
 
 #if FIX_OUTPUT_ORDER_BEHAVIOR
-    if ( (bNewPicture || !bitstreamFile || nalu.m_nalUnitType == NAL_UNIT_EOS) &&
+    if ( (bNewPicture || bytestream.isEndOfStream() || nalu.m_nalUnitType == NAL_UNIT_EOS) &&
         !m_cTDecTop.getFirstSliceInSequence () )
 #else
-    if (bNewPicture || !bitstreamFile || nalu.m_nalUnitType == NAL_UNIT_EOS)
+    if (bNewPicture || bytestream.isEndOfStream() || nalu.m_nalUnitType == NAL_UNIT_EOS)
 #endif
     {
-      if (!loopFiltered || bitstreamFile)
+      if (!loopFiltered || !bytestream.isEndOfStream())
       {
         m_cTDecTop.executeLoopFilters(poc, pcListPic);
       }
@@ -201,7 +193,7 @@ Void TAppDecTop::decode()
 #endif
     }
 #if FIX_OUTPUT_ORDER_BEHAVIOR
-    else if ( (bNewPicture || !bitstreamFile || nalu.m_nalUnitType == NAL_UNIT_EOS ) &&
+    else if ( (bNewPicture || bytestream.isEndOfStream() || nalu.m_nalUnitType == NAL_UNIT_EOS ) &&
               m_cTDecTop.getFirstSliceInSequence () ) 
     {
       m_cTDecTop.setFirstSliceInPicture (true);
@@ -308,6 +300,7 @@ Void TAppDecTop::xInitDecLib()
   // initialize decoder class
   m_cTDecTop.init();
   m_cTDecTop.setDecodedPictureHashSEIEnabled(m_decodedPictureHashSEIEnabled);
+  m_cTDecTop.setParallelPictureHash(m_bParallelPictureHash);
 #if RExt__O0043_BEST_EFFORT_DECODING
   m_cTDecTop.setForceDecodeBitDepth(m_forceDecodeBitDepth);
 #endif
@@ -594,8 +587,7 @@ Void TAppDecTop::xFlushOutput( TComList<TComPic*>* pcListPic )
 #if !DYN_REF_FREE
         if(pcPicTop)
         {
-          pcPicTop->destroy();
-          delete pcPicTop;
+          m_cTDecTop.releasePicBuffer(pcPicTop);
           pcPicTop = NULL;
         }
 #endif
@@ -603,8 +595,7 @@ Void TAppDecTop::xFlushOutput( TComList<TComPic*>* pcListPic )
     }
     if(pcPicBottom)
     {
-      pcPicBottom->destroy();
-      delete pcPicBottom;
+      m_cTDecTop.releasePicBuffer(pcPicBottom);
       pcPicBottom = NULL;
     }
   }
@@ -654,8 +645,7 @@ Void TAppDecTop::xFlushOutput( TComList<TComPic*>* pcListPic )
   #if !DYN_REF_FREE
       if(pcPic != NULL)
       {
-        pcPic->destroy();
-        delete pcPic;
+        m_cTDecTop.releasePicBuffer(pcPic);
         pcPic = NULL;
       }
   #endif
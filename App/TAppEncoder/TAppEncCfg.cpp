@@ -100,6 +100,8 @@ enum ExtendedProfileName // this is used for determining profile strings, where
 TAppEncCfg::TAppEncCfg()
 : m_pchInputFile()
 , m_pchBitstreamFile()
+, m_pchAnalysisSaveFile()
+, m_pchAnalysisLoadFile()
 , m_pchReconFile()
 , m_inputColourSpaceConvert(IPCOLOURSPACE_UNCHANGED)
 , m_snrInternalColourSpace(false)
@@ -137,6 +139,8 @@ TAppEncCfg::~TAppEncCfg()
 
   free(m_pchInputFile);
   free(m_pchBitstreamFile);
+  free(m_pchAnalysisSaveFile);
+  free(m_pchAnalysisLoadFile);
   free(m_pchReconFile);
   free(m_pchdQPFile);
   free(m_scalingListFile);
@@ -393,6 +397,8 @@ struct SMultiValueInput
     : minValIncl(minValue), maxValIncl(maxValue), minNumValuesIncl(minNumberValues), maxNumValuesIncl(maxNumberValues), values()  { }
   SMultiValueInput(const T &minValue, const T &maxValue, std::size_t minNumberValues, std::size_t maxNumberValues, const T* defValues, const UInt numDefValues)
     : minValIncl(minValue), maxValIncl(maxValue), minNumValuesIncl(minNumberValues), maxNumValuesIncl(maxNumberValues), values(defValues, defValues+numDefValues)  { }
+  SMultiValueInput(const SMultiValueInput<T> &other)
+    : minValIncl(other.minValIncl), maxValIncl(other.maxValIncl), minNumValuesIncl(other.minNumValuesIncl), maxNumValuesIncl(other.maxNumValuesIncl), values(other.values)  { }
   SMultiValueInput<T> &operator=(const std::vector<T> &userValues) { values=userValues; return *this; }
   SMultiValueInput<T> &operator=(const SMultiValueInput<T> &userValues) { values=userValues.values; return *this; }
 };
@@ -606,6 +612,8 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
 
   string cfg_InputFile;
   string cfg_BitstreamFile;
+  string cfg_AnalysisSaveFile;
+  string cfg_AnalysisLoadFile;
   string cfg_ReconFile;
   string cfg_dQPFile;
   string cfg_ScalingListFile;
@@ -623,6 +631,7 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   SMultiValueInput<Int>  cfg_startOfCodedInterval            (std::numeric_limits<Int>::min(), std::numeric_limits<Int>::max(), 0, 1<<16);
   SMultiValueInput<Int>  cfg_codedPivotValue                 (std::numeric_limits<Int>::min(), std::numeric_limits<Int>::max(), 0, 1<<16);
   SMultiValueInput<Int>  cfg_targetPivotValue                (std::numeric_limits<Int>::min(), std::numeric_limits<Int>::max(), 0, 1<<16);
+  SMultiValueInput<Int>  cfg_multiRateQPOffsets              (-MAX_QP, MAX_QP, 0, MAX_MULTI_RATE_RUNGS);
 
   const UInt defaultInputKneeCodes[3]  = { 600, 800, 900 };
   const UInt defaultOutputKneeCodes[3] = { 100, 250, 450 };
@@ -655,8 +664,14 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   ("c",    po::parseConfigFile, "configuration file name")
 
   // File, I/O and source parameters
-  ("InputFile,i",                                     cfg_InputFile,                               string(""), "Original YUV input file name")
+  ("InputFile,i",                                     cfg_InputFile,                               string(""), "Original YUV input file name, - reads from the standard input")
+  ("InputQueueDepth",                                 m_iInputQueueDepth,                                   0, "Number of source pictures read ahead on a separate thread (0: read each picture when it is encoded)")
   ("BitstreamFile,b",                                 cfg_BitstreamFile,                           string(""), "Bitstream output file name")
+  ("StreamAccessUnits",                               m_bStreamAccessUnits,                             false, "Write each access unit to the bitstream file as soon as it is encoded instead of once per GOP")
+  ("MultiRateQPOffsets",                              cfg_multiRateQPOffsets,                cfg_multiRateQPOffsets, "QP offsets of additional bitstreams (BitstreamFile with suffix _r1, _r2, ...) encoded in the same run, searching around the CU decisions of the main bitstream")
+  ("AnalysisSaveFile",                                cfg_AnalysisSaveFile,                        string(""), "Analysis file the final CU decisions of each picture are saved to")
+  ("AnalysisLoadFile",                                cfg_AnalysisLoadFile,                        string(""), "Analysis file saved by an earlier encode of the same source with the same picture and CTU size, whose CU decisions are used")
+  ("AnalysisReuseLevel",                              m_analysisReuseLevel,                                 0, "Use of the CU decisions of AnalysisLoadFile or of the main multi-rate bitstream: 0: search around them, 1: code them")
   ("ReconFile,o",                                     cfg_ReconFile,                               string(""), "Reconstructed YUV output file name")
   ("SourceWidth,-wdt",                                m_iSourceWidth,                                       0, "Source picture width")
   ("SourceHeight,-hgt",                               m_iSourceHeight,                                      0, "Source picture height")
@@ -677,6 +692,8 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   ("MSEBasedSequencePSNR",                            m_printMSEBasedSequencePSNR,                      false, "0 (default) emit sequence PSNR only as a linear average of the frame PSNRs, 1 = also emit a sequence PSNR based on an average of the frame MSEs")
   ("PrintFrameMSE",                                   m_printFrameMSE,                                  false, "0 (default) emit only bit count and PSNRs for each frame, 1 = also emit MSE values")
   ("PrintSequenceMSE",                                m_printSequenceMSE,                               false, "0 (default) emit only bit rate and PSNRs for the whole sequence, 1 = also emit MSE values")
+  ("PrintSSIM",                                       m_printSSIM,                                      false, "0 (default) emit only PSNR based quality, 1 = also calculate and emit the SSIM of each frame and the sequence")
+  ("ParallelQualityMetrics",                          m_bParallelQualityMetrics,                        false, "Calculate the PSNR/SSIM of each colour plane on a separate thread")
   ("ChromaFormatIDC,-cf",                             tmpChromaFormat,                                      0, "ChromaFormatIDC (400|420|422|444 or set 0 (default) for same as InputChromaFormat)")
   ("ConformanceMode",                                 m_conformanceWindowMode,                              0, "Deprecated alias of ConformanceWindowMode")
   ("ConformanceWindowMode",                           m_conformanceWindowMode,                              0, "Window conformance mode (0: no window, 1:automatic padding, 2:padding, 3:conformance")
@@ -734,13 +751,19 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   ("DecodingRefreshType,-dr",                         m_iDecodingRefreshType,                               0, "Intra refresh type (0:none 1:CRA 2:IDR)")
 #endif
   ("GOPSize,g",                                       m_iGOPSize,                                           1, "GOP size of temporal structure")
+  ("SceneCutDetection",                               m_sceneCutDetection,                              false, "Insert an IRAP picture and restart the GOP at detected scene cuts")
+  ("SceneCutThreshold",                               m_sceneCutThreshold,                                 20, "Increase of the mean 8x8 luma block difference (in 8-bit sample units) that signals a scene cut")
 
   // motion search options
   ("FastSearch",                                      m_iFastSearch,                                        1, "0:Full search  1:Diamond  2:PMVFAST")
   ("SearchRange,-sr",                                 m_iSearchRange,                                      96, "Motion search range")
   ("BipredSearchRange",                               m_bipredSearchRange,                                  4, "Motion search range for bipred refinement")
+  ("BipredMinGain",                                   m_bipredMinGain,                                    0.0, "Stop the bipred refinement when an iteration reduces the cost by less than this fraction (0: fixed number of iterations)")
+  ("BipredSkipRatio",                                 m_bipredSkipRatio,                                  0.0, "Skip the bipred search when one uni-prediction cost exceeds the other by more than this ratio (0: always search)")
   ("HadamardME",                                      m_bUseHADME,                                       true, "Hadamard ME for fractional-pel")
   ("ASR",                                             m_bUseASR,                                        false, "Adaptive motion search range")
+  ("CtuSearchControl",                                m_bUseCtuSearchControl,                           false, "Adapt the motion search range per CTU from neighbouring motion and prune rarely selected reference pictures")
+  ("RefPruneThreshold",                               m_dRefPruneThreshold,                              0.02, "Selection rate in the current picture below which a reference picture is not searched (CtuSearchControl, 0: no pruning)")
 
   // Mode decision parameters
   ("LambdaModifier0,-LM0",                            m_adLambdaModifier[ 0 ],                  ( Double )1.0, "Lambda modifier for temporal layer 0")
@@ -766,6 +789,7 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
 #endif
 
   ("AdaptiveQP,-aq",                                  m_bUseAdaptiveQP,                                 false, "QP adaptation based on a psycho-visual model")
+  ("AdaptiveQPThread",                                m_bUseAdaptiveQPThread,                           false, "Run the QP adaptation picture analysis on a worker thread")
   ("MaxQPAdaptationRange,-aqr",                       m_iQPAdaptationRange,                                 6, "QP adaptation range")
   ("dQPFile,m",                                       cfg_dQPFile,                                 string(""), "dQP file name")
   ("RDOQ",                                            m_useRDOQ,                                         true)
@@ -820,6 +844,7 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   ("IntraReferenceSmoothing",                         m_enableIntraReferenceSmoothing,                   true, "0: Disable use of intra reference smoothing. 1: Enable use of intra reference smoothing (not valid in V1 profiles)")
   ("WeightedPredP,-wpP",                              m_useWeightedPred,                                false, "Use weighted prediction in P slices")
   ("WeightedPredB,-wpB",                              m_useWeightedBiPred,                              false, "Use weighted (bidirectional) prediction in B slices")
+  ("WeightedPredFastSelect",                          m_useWPFastSelect,                                false, "Decide whether weighted prediction pays off from SADs over every second sample of every second row")
   ("Log2ParallelMergeLevel",                          m_log2ParallelMergeLevel,                            2u, "Parallel merge estimation region")
     //deprecated copies of renamed tile parameters
   ("UniformSpacingIdc",                               m_tileUniformSpacingFlag,                         false,      "deprecated alias of TileUniformSpacing")
@@ -844,12 +869,15 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
                                                                                                                "\t1: use MD5\n"
                                                                                                                "\t0: disable")
   ("SEIpictureDigest",                                m_decodedPictureHashSEIEnabled,                       0, "deprecated alias for SEIDecodedPictureHash")
+  ("ParallelPictureHash",                             m_bParallelPictureHash,                           false, "Calculate the decoded picture hash of each colour plane on a separate thread")
   ("TMVPMode",                                        m_TMVPModeId,                                         1, "TMVP mode 0: TMVP disable for all slices. 1: TMVP enable for all slices (default) 2: TMVP enable for certain slices only")
   ("FEN",                                             m_bUseFastEnc,                                    false, "fast encoder setting")
   ("ECU",                                             m_bUseEarlyCU,                                    false, "Early CU setting")
   ("FDM",                                             m_useFastDecisionForMerge,                         true, "Fast decision for Merge RD Cost")
   ("CFM",                                             m_bUseCbfFastMode,                                false, "Cbf fast mode setting")
   ("ESD",                                             m_useEarlySkipDetection,                          false, "Early SKIP detection setting")
+  ("FastMergeTopK",                                   m_fastMergeTopK,                                      0, "Number of merge candidates, ranked by SATD, that are given a full RD check (0: all)")
+  ("AdaptiveSkipTermination",                         m_useAdaptiveSkipTermination,                     false, "Terminate the mode search early for SKIP CUs whose neighbouring and co-located CUs are SKIP")
   ( "RateControl",                                    m_RCEnableRateControl,                            false, "Rate control: enable rate control" )
   ( "TargetBitrate",                                  m_RCTargetBitrate,                                    0, "Rate control: target bit-rate" )
   ( "KeepHierarchicalBit",                            m_RCKeepHierarchicalBit,                              0, "Rate control: 0: equal bit allocation; 1: fixed ratio bit allocation; 2: adaptive ratio bit allocation" )
@@ -857,6 +885,13 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   ( "RCLCUSeparateModel",                             m_RCUseLCUSeparateModel,                           true, "Rate control: use LCU level separate R-lambda model" )
   ( "InitialQP",                                      m_RCInitialQP,                                        0, "Rate control: initial QP" )
   ( "RCForceIntraQP",                                 m_RCForceIntraQP,                                 false, "Rate control: force intra QP to be equal to initial QP" )
+  ( "RCCtuRowLevelRateControl",                       m_RCCtuRowLevelRC,                                false, "Rate control: with LCU level RC, choose lambda and QP once per CTU row and refine the model after each row" )
+  ( "RCCpbSize",                                      m_RCCpbSize,                                          0, "Rate control: size in bits of the coded picture buffer to stay within (0: no buffer constraint)" )
+  ( "RCCpbInitialDelay",                              m_RCCpbInitialDelay,                                500, "Rate control: initial CPB removal delay in ms" )
+  ( "RCSmoothWindowSize",                             m_RCSmoothWindowSize,                g_RCSmoothWindowSize, "Rate control: number of pictures over which a deviation from the sequence budget is recovered" )
+  ( "RCCtuSmoothWindowSize",                          m_RCCtuSmoothWindowSize,          g_RCLCUSmoothWindowSize, "Rate control: number of CTUs (CTU rows) over which a deviation from the picture budget is recovered" )
+  ( "RCAlphaUpdate",                                  m_RCAlphaUpdate,                                    0.0, "Rate control: R-lambda model alpha learning rate (0: derived from the target bpp)" )
+  ( "RCBetaUpdate",                                   m_RCBetaUpdate,                                     0.0, "Rate control: R-lambda model beta learning rate (0: derived from the target bpp)" )
 
   ("TransquantBypassEnableFlag",                      m_TransquantBypassEnableFlag,                     false, "transquant_bypass_enable_flag indicator in PPS")
   ("CUTransquantBypassFlagForce",                     m_CUTransquantBypassFlagForce,                    false, "Force transquant bypass mode, when transquant_bypass_enable_flag is enabled")
@@ -1036,6 +1071,9 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   m_pchBitstreamFile = cfg_BitstreamFile.empty() ? NULL : strdup(cfg_BitstreamFile.c_str());
   m_pchReconFile = cfg_ReconFile.empty() ? NULL : strdup(cfg_ReconFile.c_str());
   m_pchdQPFile = cfg_dQPFile.empty() ? NULL : strdup(cfg_dQPFile.c_str());
+  m_multiRateQPOffsets = cfg_multiRateQPOffsets.values;
+  m_pchAnalysisSaveFile = cfg_AnalysisSaveFile.empty() ? NULL : strdup(cfg_AnalysisSaveFile.c_str());
+  m_pchAnalysisLoadFile = cfg_AnalysisLoadFile.empty() ? NULL : strdup(cfg_AnalysisLoadFile.c_str());
 
   if(m_isField)
   {
@@ -1525,6 +1563,7 @@ Void TAppEncCfg::xCheckParameter()
   xConfirmPara( m_InputChromaFormatIDC >= NUM_CHROMA_FORMAT,                                "InputChromaFormatIDC must be either 400, 420, 422 or 444" );
   xConfirmPara( m_iFrameRate <= 0,                                                          "Frame rate must be more than 1" );
   xConfirmPara( m_framesToBeEncoded <= 0,                                                   "Total Number Of Frames encoded must be more than 0" );
+  xConfirmPara( m_iInputQueueDepth < 0,                                                     "InputQueueDepth must not be negative" );
   xConfirmPara( m_iGOPSize < 1 ,                                                            "GOP Size must be greater or equal to 1" );
   xConfirmPara( m_iGOPSize > 1 &&  m_iGOPSize % 2,                                          "GOP Size must be a multiple of 2, if GOP Size is greater than 1" );
   xConfirmPara( (m_iIntraPeriod > 0 && m_iIntraPeriod < m_iGOPSize) || m_iIntraPeriod == 0, "Intra period must be more than GOP size, or -1 , not 0" );
@@ -1569,11 +1608,23 @@ Void TAppEncCfg::xCheckParameter()
   }
 
   xConfirmPara( m_iQP <  -6 * (m_internalBitDepth[CHANNEL_TYPE_LUMA] - 8) || m_iQP > 51,    "QP exceeds supported range (-QpBDOffsety to 51)" );
+  for (UInt i = 0; i < m_multiRateQPOffsets.size(); i++)
+  {
+    const Int iRungQP = m_iQP + m_multiRateQPOffsets[i];
+    xConfirmPara( iRungQP < -6 * (m_internalBitDepth[CHANNEL_TYPE_LUMA] - 8) || iRungQP > 51, "QP plus MultiRateQPOffsets exceeds supported range (-QpBDOffsety to 51)" );
+  }
+  xConfirmPara( !m_multiRateQPOffsets.empty() && m_RCEnableRateControl,                    "MultiRateQPOffsets cannot be used with RateControl" );
+  xConfirmPara( m_analysisReuseLevel < 0 || m_analysisReuseLevel > 1,                      "AnalysisReuseLevel must be 0 or 1" );
+  xConfirmPara( m_pchAnalysisSaveFile && m_pchAnalysisLoadFile && !strcmp(m_pchAnalysisSaveFile, m_pchAnalysisLoadFile), "AnalysisSaveFile and AnalysisLoadFile must be different files" );
   xConfirmPara( m_loopFilterBetaOffsetDiv2 < -6 || m_loopFilterBetaOffsetDiv2 > 6,        "Loop Filter Beta Offset div. 2 exceeds supported range (-6 to 6)");
   xConfirmPara( m_loopFilterTcOffsetDiv2 < -6 || m_loopFilterTcOffsetDiv2 > 6,            "Loop Filter Tc Offset div. 2 exceeds supported range (-6 to 6)");
   xConfirmPara( m_iFastSearch < 0 || m_iFastSearch > 2,                                     "Fast Search Mode is not supported value (0:Full search  1:Diamond  2:PMVFAST)" );
   xConfirmPara( m_iSearchRange < 0 ,                                                        "Search Range must be more than 0" );
   xConfirmPara( m_bipredSearchRange < 0 ,                                                   "Search Range must be more than 0" );
+  xConfirmPara( m_bipredMinGain < 0.0 || m_bipredMinGain >= 1.0,                            "BipredMinGain must be in the range 0 to 1" );
+  xConfirmPara( m_bipredSkipRatio != 0.0 && m_bipredSkipRatio < 1.0,                        "BipredSkipRatio must be 0 or at least 1" );
+  xConfirmPara( m_fastMergeTopK < 0 || m_fastMergeTopK > MRG_MAX_NUM_CANDS,                 "FastMergeTopK must be in the range 0 to 5" );
+  xConfirmPara( m_dRefPruneThreshold < 0.0 || m_dRefPruneThreshold >= 1.0,                  "RefPruneThreshold must be in the range 0 to 1" );
   xConfirmPara( m_iMaxDeltaQP > 7,                                                          "Absolute Delta QP exceeds supported range (0 to 7)" );
   xConfirmPara( m_iMaxCuDQPDepth > m_uiMaxCUDepth - 1,                                          "Absolute depth for a minimum CuDQP exceeds maximum coding unit depth" );
 
@@ -1714,6 +1765,9 @@ Void TAppEncCfg::xCheckParameter()
   }
   Int numOK=0;
   xConfirmPara( m_iIntraPeriod >=0&&(m_iIntraPeriod%m_iGOPSize!=0), "Intra period must be a multiple of GOPSize, or -1" );
+  xConfirmPara( m_sceneCutDetection && m_isField, "Scene cut detection is not supported for field coding" );
+  xConfirmPara( m_sceneCutDetection && m_iDecodingRefreshType == 3, "Scene cut detection cannot be combined with recovery point SEI based random access" );
+  xConfirmPara( m_sceneCutThreshold < 0, "SceneCutThreshold must not be negative" );
 
   for(Int i=0; i<m_iGOPSize; i++)
   {
@@ -2110,6 +2164,12 @@ Void TAppEncCfg::xCheckParameter()
       }
     }
     xConfirmPara( m_uiDeltaQpRD > 0, "Rate control cannot be used together with slice level multiple-QP optimization!\n" );
+    xConfirmPara( m_RCCtuRowLevelRC && !m_RCLCULevelRC, "RCCtuRowLevelRateControl requires LCULevelRateControl" );
+    xConfirmPara( m_RCCpbSize < 0, "RCCpbSize must not be negative" );
+    xConfirmPara( m_RCCpbSize > 0 && m_RCCpbSize < m_RCTargetBitrate / m_iFrameRate, "RCCpbSize must hold at least one picture interval at the target bit rate" );
+    xConfirmPara( m_RCCpbInitialDelay < 0, "RCCpbInitialDelay must not be negative" );
+    xConfirmPara( m_RCSmoothWindowSize < 1 || m_RCCtuSmoothWindowSize < 1, "RCSmoothWindowSize and RCCtuSmoothWindowSize must be at least 1" );
+    xConfirmPara( m_RCAlphaUpdate < 0.0 || m_RCBetaUpdate < 0.0, "RCAlphaUpdate and RCBetaUpdate must not be negative" );
   }
 
   xConfirmPara(!m_TransquantBypassEnableFlag && m_CUTransquantBypassFlagForce, "CUTransquantBypassFlagForce cannot be 1 when TransquantBypassEnableFlag is 0");
@@ -2197,13 +2257,39 @@ Void TAppEncCfg::xPrintParameter()
 {
   printf("\n");
   printf("Input          File               : %s\n", m_pchInputFile          );
+  if (m_iInputQueueDepth > 0)
+  {
+    printf("Input queue depth                 : %d\n", m_iInputQueueDepth      );
+  }
   printf("Bitstream      File               : %s\n", m_pchBitstreamFile      );
+  if (m_bStreamAccessUnits)
+  {
+    printf("Bitstream output                  : per access unit\n");
+  }
+  if (!m_multiRateQPOffsets.empty())
+  {
+    printf("Multi-rate QP offsets             :");
+    for (UInt i = 0; i < m_multiRateQPOffsets.size(); i++)
+    {
+      printf(" %d", m_multiRateQPOffsets[i]);
+    }
+    printf("\n");
+  }
+  if (m_pchAnalysisSaveFile)
+  {
+    printf("Analysis save file                : %s\n", m_pchAnalysisSaveFile );
+  }
+  if (m_pchAnalysisLoadFile)
+  {
+    printf("Analysis load file                : %s (reuse level %d)\n", m_pchAnalysisLoadFile, m_analysisReuseLevel );
+  }
   printf("Reconstruction File               : %s\n", m_pchReconFile          );
   printf("Real     Format                   : %dx%d %dHz\n", m_iSourceWidth - m_confWinLeft - m_confWinRight, m_iSourceHeight - m_confWinTop - m_confWinBottom, m_iFrameRate );
   printf("Internal Format                   : %dx%d %dHz\n", m_iSourceWidth, m_iSourceHeight, m_iFrameRate );
   printf("Sequence PSNR output              : %s\n", (m_printMSEBasedSequencePSNR ? "Linear average, MSE-based" : "Linear average only") );
   printf("Sequence MSE output               : %s\n", (m_printSequenceMSE ? "Enabled" : "Disabled") );
   printf("Frame MSE output                  : %s\n", (m_printFrameMSE    ? "Enabled" : "Disabled") );
+  printf("SSIM output                       : %s\n", (m_printSSIM        ? "Enabled" : "Disabled") );
   if (m_isField)
   {
     printf("Frame/Field                       : Field based coding\n");
@@ -2247,6 +2333,10 @@ Void TAppEncCfg::xPrintParameter()
   printf("Max CU chroma QP adjustment depth : %d\n", m_maxCUChromaQpAdjustmentDepth);
   printf("QP adaptation                     : %d (range=%d)\n", m_bUseAdaptiveQP, (m_bUseAdaptiveQP ? m_iQPAdaptationRange : 0) );
   printf("GOP size                          : %d\n", m_iGOPSize );
+  if (m_sceneCutDetection)
+  {
+    printf("Scene cut threshold               : %d\n", m_sceneCutThreshold );
+  }
   printf("Input bit depth                   : (Y:%d, C:%d)\n", m_inputBitDepth[CHANNEL_TYPE_LUMA], m_inputBitDepth[CHANNEL_TYPE_CHROMA] );
   printf("MSB-extended bit depth            : (Y:%d, C:%d)\n", m_MSBExtendedBitDepth[CHANNEL_TYPE_LUMA], m_MSBExtendedBitDepth[CHANNEL_TYPE_CHROMA] );
   printf("Internal bit depth                : (Y:%d, C:%d)\n", m_internalBitDepth[CHANNEL_TYPE_LUMA], m_internalBitDepth[CHANNEL_TYPE_CHROMA] );
@@ -2286,6 +2376,11 @@ Void TAppEncCfg::xPrintParameter()
     printf("UseLCUSeparateModel               : %d\n", m_RCUseLCUSeparateModel );
     printf("InitialQP                         : %d\n", m_RCInitialQP );
     printf("ForceIntraQP                      : %d\n", m_RCForceIntraQP );
+    printf("CtuRowLevelRC                     : %d\n", m_RCCtuRowLevelRC );
+    if ( m_RCCpbSize > 0 )
+    {
+      printf("CpbSize                           : %d (initial delay %d ms)\n", m_RCCpbSize, m_RCCpbInitialDelay );
+    }
   }
 
   printf("Max Num Merge Candidates          : %d\n", m_maxNumMergeCand);
@@ -2299,11 +2394,14 @@ Void TAppEncCfg::xPrintParameter()
   printf("RDpenalty:%d ", m_rdPenalty  );
   printf("SQP:%d ", m_uiDeltaQpRD         );
   printf("ASR:%d ", m_bUseASR             );
+  printf("CSC:%d ", m_bUseCtuSearchControl );
   printf("FEN:%d ", m_bUseFastEnc         );
   printf("ECU:%d ", m_bUseEarlyCU         );
   printf("FDM:%d ", m_useFastDecisionForMerge );
   printf("CFM:%d ", m_bUseCbfFastMode         );
   printf("ESD:%d ", m_useEarlySkipDetection  );
+  printf("FMK:%d ", m_fastMergeTopK          );
+  printf("AST:%d ", m_useAdaptiveSkipTermination );
   printf("RQT:%d ", 1     );
   printf("TransformSkip:%d ",     m_useTransformSkip              );
   printf("TransformSkipFast:%d ", m_useTransformSkipFast       );
@@ -57,7 +57,13 @@ protected:
   // file I/O
   Char*     m_pchInputFile;                                   ///< source file name
   Char*     m_pchBitstreamFile;                               ///< output bitstream file
+  Bool      m_bStreamAccessUnits;                             ///< write each access unit to the bitstream file as soon as it is encoded
+  std::vector<Int> m_multiRateQPOffsets;                      ///< QP offsets of the additional bitstreams of a multi-rate encode
+  Char*     m_pchAnalysisSaveFile;                            ///< file the final CU decisions are saved to
+  Char*     m_pchAnalysisLoadFile;                            ///< file with the CU decisions of an earlier encode
+  Int       m_analysisReuseLevel;                             ///< use of loaded or multi-rate CU decisions: 0: search around them, 1: code them
   Char*     m_pchReconFile;                                   ///< output reconstruction file
+  Int       m_iInputQueueDepth;                               ///< number of source pictures read ahead on a reader thread
   Double    m_adLambdaModifier[ MAX_TLAYER ];                 ///< Lambda modifier array for each temporal layer
   // source specification
   Int       m_iFrameRate;                                     ///< source frame-rates (Hz)
@@ -85,6 +91,8 @@ protected:
   Bool      m_printMSEBasedSequencePSNR;
   Bool      m_printFrameMSE;
   Bool      m_printSequenceMSE;
+  Bool      m_printSSIM;                                      ///< also calculate and print the SSIM of each picture
+  Bool      m_bParallelQualityMetrics;                        ///< measure the colour planes of each picture concurrently
 
   // profile/level
   Profile::Name m_profile;
@@ -103,6 +111,8 @@ protected:
   Int       m_iIntraPeriod;                                   ///< period of I-slice (random access period)
   Int       m_iDecodingRefreshType;                           ///< random access type
   Int       m_iGOPSize;                                       ///< GOP size of hierarchical structure
+  Bool      m_sceneCutDetection;                              ///< insert an IRAP picture and restart the GOP at detected scene cuts
+  Int       m_sceneCutThreshold;                              ///< scene cut detection threshold
   Int       m_extraRPSs;                                      ///< extra RPSs added to handle CRA
   GOPEntry  m_GOPList[MAX_GOP];                               ///< the coding structure entries from the config file
   Int       m_numReorderPics[MAX_TLAYER];                     ///< total number of reorder pictures
@@ -139,6 +149,7 @@ protected:
   TComSEIMasteringDisplay m_masteringDisplay;
 
   Bool      m_bUseAdaptiveQP;                                 ///< Flag for enabling QP adaptation based on a psycho-visual model
+  Bool      m_bUseAdaptiveQPThread;                           ///< Flag for running the QP adaptation picture analysis on a worker thread
   Int       m_iQPAdaptationRange;                             ///< dQP range by QP adaptation
 
   Int       m_maxTempLayer;                                  ///< Max temporal layer
@@ -190,6 +201,8 @@ protected:
 
   // coding tools (encoder-only parameters)
   Bool      m_bUseASR;                                        ///< flag for using adaptive motion search range
+  Bool      m_bUseCtuSearchControl;                           ///< flag for adapting the search range and pruning references per CTU
+  Double    m_dRefPruneThreshold;                             ///< selection rate below which a reference picture is not searched
   Bool      m_bUseHADME;                                      ///< flag for using HAD in sub-pel ME
   Bool      m_useRDOQ;                                       ///< flag for using RD optimized quantization
   Bool      m_useRDOQTS;                                     ///< flag for using RD optimized quantization for transform skip
@@ -197,11 +210,15 @@ protected:
   Int       m_iFastSearch;                                    ///< ME mode, 0 = full, 1 = diamond, 2 = PMVFAST
   Int       m_iSearchRange;                                   ///< ME search range
   Int       m_bipredSearchRange;                              ///< ME search range for bipred refinement
+  Double    m_bipredMinGain;                                  ///< relative cost gain below which the bipred refinement stops
+  Double    m_bipredSkipRatio;                                ///< ratio of the uni-prediction costs above which bipred is not searched
   Bool      m_bUseFastEnc;                                    ///< flag for using fast encoder setting
   Bool      m_bUseEarlyCU;                                    ///< flag for using Early CU setting
   Bool      m_useFastDecisionForMerge;                        ///< flag for using Fast Decision Merge RD-Cost
   Bool      m_bUseCbfFastMode;                              ///< flag for using Cbf Fast PU Mode Decision
   Bool      m_useEarlySkipDetection;                         ///< flag for using Early SKIP Detection
+  Int       m_fastMergeTopK;                                 ///< number of SATD-ranked merge candidates given a full RD check (0: all)
+  Bool      m_useAdaptiveSkipTermination;                    ///< flag for terminating the mode search from neighbouring SKIP statistics
   Int       m_sliceMode;                                     ///< 0: no slice limits, 1 : max number of CTBs per slice, 2: max number of bytes per slice,
                                                              ///< 3: max number of tiles per slice
   Int       m_sliceArgument;                                 ///< argument according to selected slice mode
@@ -223,6 +240,7 @@ protected:
   Bool      m_bUseConstrainedIntraPred;                       ///< flag for using constrained intra prediction
 
   Int       m_decodedPictureHashSEIEnabled;                    ///< Checksum(3)/CRC(2)/MD5(1)/disable(0) acting on decoded picture hash SEI message
+  Bool      m_bParallelPictureHash;                            ///< hash the colour planes of each picture concurrently
   Int       m_recoveryPointSEIEnabled;
   Int       m_bufferingPeriodSEIEnabled;
   Int       m_pictureTimingSEIEnabled;
@@ -291,6 +309,7 @@ protected:
   // weighted prediction
   Bool      m_useWeightedPred;                    ///< Use of weighted prediction in P slices
   Bool      m_useWeightedBiPred;                  ///< Use of bi-directional weighted prediction in B slices
+  Bool      m_useWPFastSelect;                    ///< estimate the SADs of the WP on/off decision on a subsampled picture
 
   UInt      m_log2ParallelMergeLevel;                         ///< Parallel merge estimation region
   UInt      m_maxNumMergeCand;                                ///< Max number of merge candidates
@@ -304,6 +323,13 @@ protected:
   Bool      m_RCUseLCUSeparateModel;              ///< use separate R-lambda model at LCU level
   Int       m_RCInitialQP;                        ///< inital QP for rate control
   Bool      m_RCForceIntraQP;                     ///< force all intra picture to use initial QP or not
+  Bool      m_RCCtuRowLevelRC;                    ///< with LCU level rate control, choose lambda and QP once per CTU row
+  Int       m_RCCpbSize;                          ///< size of the modelled coded picture buffer in bits, 0 for none
+  Int       m_RCCpbInitialDelay;                  ///< initial CPB removal delay in ms
+  Int       m_RCSmoothWindowSize;                 ///< pictures over which a deviation from the sequence budget is recovered
+  Int       m_RCCtuSmoothWindowSize;              ///< CTUs (or CTU rows) over which a deviation from the picture budget is recovered
+  Double    m_RCAlphaUpdate;                      ///< R-lambda model alpha learning rate, 0 for automatic
+  Double    m_RCBetaUpdate;                       ///< R-lambda model beta learning rate, 0 for automatic
   Int       m_useScalingListId;                               ///< using quantization matrix
   Char*     m_scalingListFile;                                ///< quantization matrix file name
 
@@ -0,0 +1,247 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2014, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TAppEncInputQueue.cpp
+    \brief    Source picture reader feeding the encoder
+*/
+
+#include <assert.h>
+
+#include "TAppEncInputQueue.h"
+
+//! \ingroup TAppEncoder
+//! \{
+
+// ====================================================================================================================
+// Constructor / destructor / create / destroy
+// ====================================================================================================================
+
+TAppEncInputQueue::TAppEncInputQueue()
+: m_pcInputFile      ( NULL )
+, m_ipCSC            ( IPCOLOURSPACE_UNCHANGED )
+, m_fileChromaFormat ( NUM_CHROMA_FORMAT )
+, m_iNumFramesToRead ( 0 )
+, m_bUseReaderThread ( false )
+#if ENABLE_WORKER_THREADS
+, m_bTerminate       ( false )
+#endif
+{
+  m_aiPad[0] = m_aiPad[1] = 0;
+}
+
+TAppEncInputQueue::~TAppEncInputQueue()
+{
+  destroy();
+}
+
+/** Allocate the picture pool and start reading
+ * \param pcInputFile      opened input file
+ * \param iNumFramesToRead number of frames to read, 0 reads until the end of the input
+ * \param iWidth           width of the pictures including the padding
+ * \param iHeight          height of the pictures including the padding
+ * \param chromaFormat     chroma format of the pictures
+ * \param uiMaxCUWidth     maximum CU width
+ * \param uiMaxCUHeight    maximum CU height
+ * \param uiMaxCUDepth     maximum CU depth
+ * \param ipCSC            colour space conversion applied to the input
+ * \param aiPad            padding added to the right and bottom of each picture
+ * \param fileChromaFormat chroma format of the file
+ * \param iQueueDepth      number of pictures read ahead on a reader thread, 0 reads each picture on demand
+ */
+Void TAppEncInputQueue::create( TVideoIOYuv* pcInputFile, Int iNumFramesToRead, Int iWidth, Int iHeight, ChromaFormat chromaFormat,
+                                UInt uiMaxCUWidth, UInt uiMaxCUHeight, UInt uiMaxCUDepth,
+                                InputColourSpaceConversion ipCSC, const Int aiPad[2], ChromaFormat fileChromaFormat, Int iQueueDepth )
+{
+  m_pcInputFile      = pcInputFile;
+  m_iNumFramesToRead = iNumFramesToRead > 0 ? iNumFramesToRead : -1;
+  m_ipCSC            = ipCSC;
+  m_aiPad[0]         = aiPad[0];
+  m_aiPad[1]         = aiPad[1];
+  m_fileChromaFormat = fileChromaFormat;
+
+#if ENABLE_WORKER_THREADS
+  m_bUseReaderThread = iQueueDepth > 0;
+#else
+  m_bUseReaderThread = false;
+#endif
+
+  // the encoder holds one picture while the reader fills the others
+  m_cPool.resize( m_bUseReaderThread ? iQueueDepth + 1 : 1 );
+  for ( UInt i = 0; i < m_cPool.size(); i++ )
+  {
+    m_cPool[i].pcPicYuvOrg     = new TComPicYuv;
+    m_cPool[i].pcPicYuvTrueOrg = new TComPicYuv;
+    m_cPool[i].pcPicYuvOrg    ->create( iWidth, iHeight, chromaFormat, uiMaxCUWidth, uiMaxCUHeight, uiMaxCUDepth );
+    m_cPool[i].pcPicYuvTrueOrg->create( iWidth, iHeight, chromaFormat, uiMaxCUWidth, uiMaxCUHeight, uiMaxCUDepth );
+    m_cPool[i].bEof            = false;
+    m_cFree.push_back( &m_cPool[i] );
+  }
+
+#if ENABLE_WORKER_THREADS
+  if ( m_bUseReaderThread )
+  {
+    m_bTerminate = false;
+    m_cReader    = std::thread( &TAppEncInputQueue::xReaderLoop, this );
+  }
+#endif
+}
+
+/** Stop reading and free the picture pool
+ */
+Void TAppEncInputQueue::destroy()
+{
+#if ENABLE_WORKER_THREADS
+  if ( m_cReader.joinable() )
+  {
+    {
+      std::lock_guard<std::mutex> cLock( m_cMutex );
+      m_bTerminate = true;
+    }
+    m_cFreeAvailable.notify_one();
+    m_cReader.join();
+  }
+#endif
+  m_bUseReaderThread = false;
+
+  for ( UInt i = 0; i < m_cPool.size(); i++ )
+  {
+    m_cPool[i].pcPicYuvOrg    ->destroy();
+    m_cPool[i].pcPicYuvTrueOrg->destroy();
+    delete m_cPool[i].pcPicYuvOrg;
+    delete m_cPool[i].pcPicYuvTrueOrg;
+  }
+  m_cPool.clear();
+  m_cFree.clear();
+  m_cFilled.clear();
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** Get the next source picture in input order, blocking until it has been read
+ * \returns picture to be handed back with releasePicture()
+ */
+TAppEncInputPic* TAppEncInputQueue::getPicture()
+{
+  TAppEncInputPic* pcInputPic = NULL;
+#if ENABLE_WORKER_THREADS
+  if ( m_bUseReaderThread )
+  {
+    std::unique_lock<std::mutex> cLock( m_cMutex );
+    while ( m_cFilled.empty() )
+    {
+      m_cFilledAvailable.wait( cLock );
+    }
+    pcInputPic = m_cFilled.front();
+    m_cFilled.pop_front();
+    return pcInputPic;
+  }
+#endif
+
+  assert( !m_cFree.empty() );
+  pcInputPic = m_cFree.front();
+  m_cFree.pop_front();
+  xReadPicture( pcInputPic );
+  return pcInputPic;
+}
+
+/** Return a picture obtained from getPicture() to the pool
+ * \param pcInputPic picture no longer used by the encoder
+ */
+Void TAppEncInputQueue::releasePicture( TAppEncInputPic* pcInputPic )
+{
+#if ENABLE_WORKER_THREADS
+  if ( m_bUseReaderThread )
+  {
+    {
+      std::lock_guard<std::mutex> cLock( m_cMutex );
+      m_cFree.push_back( pcInputPic );
+    }
+    m_cFreeAvailable.notify_one();
+    return;
+  }
+#endif
+  m_cFree.push_back( pcInputPic );
+}
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+Void TAppEncInputQueue::xReadPicture( TAppEncInputPic* pcInputPic )
+{
+  m_pcInputFile->read( pcInputPic->pcPicYuvOrg, pcInputPic->pcPicYuvTrueOrg, m_ipCSC, m_aiPad, m_fileChromaFormat );
+  pcInputPic->bEof = m_pcInputFile->isEof();
+  if ( m_iNumFramesToRead > 0 )
+  {
+    m_iNumFramesToRead--;
+  }
+}
+
+#if ENABLE_WORKER_THREADS
+/** Read pictures into free pool entries until the requested number of frames or the end of the input is reached
+ */
+Void TAppEncInputQueue::xReaderLoop()
+{
+  Bool bDone = false;
+  while ( !bDone )
+  {
+    TAppEncInputPic* pcInputPic = NULL;
+    {
+      std::unique_lock<std::mutex> cLock( m_cMutex );
+      while ( m_cFree.empty() && !m_bTerminate )
+      {
+        m_cFreeAvailable.wait( cLock );
+      }
+      if ( m_bTerminate )
+      {
+        return;
+      }
+      pcInputPic = m_cFree.front();
+      m_cFree.pop_front();
+    }
+
+    xReadPicture( pcInputPic );
+    bDone = pcInputPic->bEof || m_iNumFramesToRead == 0;
+
+    {
+      std::lock_guard<std::mutex> cLock( m_cMutex );
+      m_cFilled.push_back( pcInputPic );
+    }
+    m_cFilledAvailable.notify_one();
+  }
+}
+#endif
+
+//! \}
@@ -0,0 +1,112 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2014, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TAppEncInputQueue.h
+    \brief    Source picture reader feeding the encoder (header)
+*/
+
+#ifndef __TAPPENCINPUTQUEUE__
+#define __TAPPENCINPUTQUEUE__
+
+#include "TLibCommon/TComPicYuv.h"
+#include "TLibVideoIO/TVideoIOYuv.h"
+
+#include <vector>
+#include <deque>
+#if ENABLE_WORKER_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+//! \ingroup TAppEncoder
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// one source picture as read from the input file
+struct TAppEncInputPic
+{
+  TComPicYuv* pcPicYuvOrg;                                  ///< picture after the input colour space conversion
+  TComPicYuv* pcPicYuvTrueOrg;                              ///< picture as stored in the file
+  Bool        bEof;                                         ///< the end of the input was reached while reading this picture, its contents are invalid
+};
+
+/** Bounded queue of source pictures read ahead of the encoder. The pictures are taken from a fixed pool and must be
+ *  handed back with releasePicture() once the encoder has copied them. With a queue depth of 0 the pictures are read
+ *  on demand on the calling thread.
+ */
+class TAppEncInputQueue
+{
+private:
+  TVideoIOYuv*                  m_pcInputFile;
+  InputColourSpaceConversion    m_ipCSC;
+  Int                           m_aiPad[2];
+  ChromaFormat                  m_fileChromaFormat;
+  Int                           m_iNumFramesToRead;         ///< frames still to be read, negative reads until the end of the input
+
+  std::vector<TAppEncInputPic>  m_cPool;
+  std::deque<TAppEncInputPic*>  m_cFree;                    ///< pictures available for reading into
+  std::deque<TAppEncInputPic*>  m_cFilled;                  ///< pictures read, in input order
+
+  Bool                          m_bUseReaderThread;
+#if ENABLE_WORKER_THREADS
+  std::thread                   m_cReader;
+  std::mutex                    m_cMutex;
+  std::condition_variable       m_cFreeAvailable;
+  std::condition_variable       m_cFilledAvailable;
+  Bool                          m_bTerminate;
+
+  Void xReaderLoop();
+#endif
+
+  Void xReadPicture( TAppEncInputPic* pcInputPic );
+
+public:
+  TAppEncInputQueue();
+  virtual ~TAppEncInputQueue();
+
+  Void create ( TVideoIOYuv* pcInputFile, Int iNumFramesToRead, Int iWidth, Int iHeight, ChromaFormat chromaFormat,
+                UInt uiMaxCUWidth, UInt uiMaxCUHeight, UInt uiMaxCUDepth,
+                InputColourSpaceConversion ipCSC, const Int aiPad[2], ChromaFormat fileChromaFormat, Int iQueueDepth );
+  Void destroy();
+
+  TAppEncInputPic* getPicture     ();                       ///< next source picture, blocks until it has been read
+  Void             releasePicture ( TAppEncInputPic* pcInputPic );
+};
+
+//! \}
+
+#endif // __TAPPENCINPUTQUEUE__
@@ -42,6 +42,7 @@
 #include <fcntl.h>
 #include <assert.h>
 #include <iomanip>
+#include <sstream>
 
 #include "TAppEncTop.h"
 #include "TLibEncoder/AnnexBwrite.h"
@@ -60,6 +61,7 @@ using namespace std;
 TAppEncTop::TAppEncTop()
 {
   m_iFrameRcvd = 0;
+  m_pcBitstreamOut = NULL;
   m_totalBytes = 0;
   m_essentialBytes = 0;
 }
@@ -99,6 +101,8 @@ Void TAppEncTop::xInitLibCfg()
   m_cTEncTop.setPrintMSEBasedSequencePSNR                         ( m_printMSEBasedSequencePSNR);
   m_cTEncTop.setPrintFrameMSE                                     ( m_printFrameMSE);
   m_cTEncTop.setPrintSequenceMSE                                  ( m_printSequenceMSE);
+  m_cTEncTop.setPrintSSIM                                         ( m_printSSIM );
+  m_cTEncTop.setParallelQualityMetrics                            ( m_bParallelQualityMetrics );
 
   m_cTEncTop.setFrameRate                                         ( m_iFrameRate );
   m_cTEncTop.setFrameSkip                                         ( m_FrameSkip );
@@ -113,6 +117,8 @@ Void TAppEncTop::xInitLibCfg()
   m_cTEncTop.setGOPSize                                           ( m_iGOPSize );
   m_cTEncTop.setGopList                                           ( m_GOPList );
   m_cTEncTop.setExtraRPSs                                         ( m_extraRPSs );
+  m_cTEncTop.setSceneCutDetection                                 ( m_sceneCutDetection );
+  m_cTEncTop.setSceneCutThreshold                                 ( m_sceneCutThreshold );
   for(Int i = 0; i < MAX_TLAYER; i++)
   {
     m_cTEncTop.setNumReorderPics                                  ( m_numReorderPics[i], i );
@@ -143,6 +149,8 @@ Void TAppEncTop::xInitLibCfg()
   m_cTEncTop.setFastSearch                                        ( m_iFastSearch  );
   m_cTEncTop.setSearchRange                                       ( m_iSearchRange );
   m_cTEncTop.setBipredSearchRange                                 ( m_bipredSearchRange );
+  m_cTEncTop.setBipredMinGain                                     ( m_bipredMinGain );
+  m_cTEncTop.setBipredSkipRatio                                   ( m_bipredSkipRatio );
 
   //====== Quality control ========
   m_cTEncTop.setMaxDeltaQP                                        ( m_iMaxDeltaQP  );
@@ -158,12 +166,16 @@ Void TAppEncTop::xInitLibCfg()
 #endif
 
   m_cTEncTop.setUseAdaptiveQP                                     ( m_bUseAdaptiveQP  );
+  m_cTEncTop.setUseAdaptiveQPThread                               ( m_bUseAdaptiveQPThread );
   m_cTEncTop.setQPAdaptationRange                                 ( m_iQPAdaptationRange );
   m_cTEncTop.setUseExtendedPrecision                              ( m_useExtendedPrecision );
   m_cTEncTop.setUseHighPrecisionPredictionWeighting               ( m_useHighPrecisionPredictionWeighting );
   //====== Tool list ========
   m_cTEncTop.setDeltaQpRD                                         ( m_uiDeltaQpRD  );
   m_cTEncTop.setUseASR                                            ( m_bUseASR      );
+  m_cTEncTop.setUseCtuSearchControl                               ( m_bUseCtuSearchControl );
+  m_cTEncTop.setRefPruneThreshold                                 ( m_dRefPruneThreshold );
+  m_cTEncTop.setAnalysisReuseLevel                                ( m_analysisReuseLevel );
   m_cTEncTop.setUseHADME                                          ( m_bUseHADME    );
   m_cTEncTop.setdQPs                                              ( m_aidQP        );
   m_cTEncTop.setUseRDOQ                                           ( m_useRDOQ     );
@@ -178,6 +190,8 @@ Void TAppEncTop::xInitLibCfg()
   m_cTEncTop.setUseFastDecisionForMerge                           ( m_useFastDecisionForMerge  );
   m_cTEncTop.setUseCbfFastMode                                    ( m_bUseCbfFastMode  );
   m_cTEncTop.setUseEarlySkipDetection                             ( m_useEarlySkipDetection );
+  m_cTEncTop.setFastMergeTopK                                     ( m_fastMergeTopK );
+  m_cTEncTop.setUseAdaptiveSkipTermination                        ( m_useAdaptiveSkipTermination );
   m_cTEncTop.setUseCrossComponentPrediction                       ( m_useCrossComponentPrediction );
   m_cTEncTop.setUseReconBasedCrossCPredictionEstimate             ( m_reconBasedCrossCPredictionEstimate );
   m_cTEncTop.setSaoOffsetBitShift                                 ( CHANNEL_TYPE_LUMA  , m_saoOffsetBitShift[CHANNEL_TYPE_LUMA]   );
@@ -203,6 +217,7 @@ Void TAppEncTop::xInitLibCfg()
   //====== Weighted Prediction ========
   m_cTEncTop.setUseWP                                             ( m_useWeightedPred      );
   m_cTEncTop.setWPBiPred                                          ( m_useWeightedBiPred   );
+  m_cTEncTop.setUseWPFastSelect                                   ( m_useWPFastSelect     );
   //====== Parallel Merge Estimation ========
   m_cTEncTop.setLog2ParallelMergeLevelMinus2                      ( m_log2ParallelMergeLevel - 2 );
 
@@ -241,6 +256,7 @@ Void TAppEncTop::xInitLibCfg()
 
   m_cTEncTop.setDisableIntraReferenceSmoothing                    (!m_enableIntraReferenceSmoothing );
   m_cTEncTop.setDecodedPictureHashSEIEnabled                      ( m_decodedPictureHashSEIEnabled );
+  m_cTEncTop.setParallelPictureHash                               ( m_bParallelPictureHash );
   m_cTEncTop.setRecoveryPointSEIEnabled                           ( m_recoveryPointSEIEnabled );
   m_cTEncTop.setBufferingPeriodSEIEnabled                         ( m_bufferingPeriodSEIEnabled );
   m_cTEncTop.setPictureTimingSEIEnabled                           ( m_pictureTimingSEIEnabled );
@@ -336,6 +352,13 @@ Void TAppEncTop::xInitLibCfg()
   m_cTEncTop.setUseLCUSeparateModel                               ( m_RCUseLCUSeparateModel );
   m_cTEncTop.setInitialQP                                         ( m_RCInitialQP );
   m_cTEncTop.setForceIntraQP                                      ( m_RCForceIntraQP );
+  m_cTEncTop.setRCCtuRowLevelRC                                   ( m_RCCtuRowLevelRC );
+  m_cTEncTop.setRCCpbSize                                         ( m_RCCpbSize );
+  m_cTEncTop.setRCCpbInitialDelay                                 ( m_RCCpbInitialDelay );
+  m_cTEncTop.setRCSmoothWindowSize                                ( m_RCSmoothWindowSize );
+  m_cTEncTop.setRCCtuSmoothWindowSize                             ( m_RCCtuSmoothWindowSize );
+  m_cTEncTop.setRCAlphaUpdate                                     ( m_RCAlphaUpdate );
+  m_cTEncTop.setRCBetaUpdate                                      ( m_RCBetaUpdate );
   m_cTEncTop.setTransquantBypassEnableFlag                        ( m_TransquantBypassEnableFlag );
   m_cTEncTop.setCUTransquantBypassFlagForceValue                  ( m_CUTransquantBypassFlagForce );
   m_cTEncTop.setCostMode                                          ( m_costMode );
@@ -387,6 +410,60 @@ Void TAppEncTop::xCreateLib()
 
   // Neo Decoder
   m_cTEncTop.create();
+
+  // multi-rate encoding: additional encoders with the configuration of the main encoder except for the QP, which
+  // search around the CU decisions of the main encoder and write their own bitstream files
+  for ( UInt uiRung = 0; uiRung < m_multiRateQPOffsets.size(); uiRung++ )
+  {
+    TEncTop* pcRung = new TEncTop;
+    static_cast<TEncCfg&>( *pcRung ) = m_cTEncTop;
+    pcRung->setQP( m_iQP + m_multiRateQPOffsets[uiRung] );
+    pcRung->setCuAnalysisInput( &m_cCuAnalysis );
+    pcRung->create();
+    m_apcRungEncoders.push_back( pcRung );
+
+    std::string fileName( m_pchBitstreamFile );
+    std::ostringstream suffix;
+    suffix << "_r" << ( uiRung + 1 );
+    const size_t extPos = fileName.find_last_of( '.' );
+    const size_t dirPos = fileName.find_last_of( "/\\" );
+    fileName.insert( ( extPos == std::string::npos || ( dirPos != std::string::npos && extPos < dirPos ) ) ? fileName.size() : extPos, suffix.str() );
+
+    std::fstream* pcBitstreamFile = new std::fstream( fileName.c_str(), std::fstream::binary | std::fstream::out );
+    if ( !*pcBitstreamFile )
+    {
+      fprintf( stderr, "\nfailed to open bitstream file `%s' for writing\n", fileName.c_str() );
+      exit( EXIT_FAILURE );
+    }
+    printf( "Multi-rate bitstream %d            : %s (QP %d)\n", uiRung + 1, fileName.c_str(), m_iQP + m_multiRateQPOffsets[uiRung] );
+    m_apcRungBitstreamFiles.push_back( pcBitstreamFile );
+  }
+  m_acRungListPicYuvRec.resize( m_apcRungEncoders.size() );
+  m_auiRungBytes.assign( m_apcRungEncoders.size(), 0 );
+
+  const UInt uiNumCtus      = ( ( m_iSourceWidth + m_uiMaxCUWidth - 1 ) / m_uiMaxCUWidth ) * ( ( m_iSourceHeight + m_uiMaxCUHeight - 1 ) / m_uiMaxCUHeight );
+  const UInt uiNumPartInCtu = 1 << ( g_uiMaxCUDepth << 1 );
+  if ( !m_apcRungEncoders.empty() || m_pchAnalysisSaveFile )
+  {
+    m_cCuAnalysis.create( uiNumCtus, uiNumPartInCtu, Int( m_apcRungEncoders.size() ) );
+    if ( m_pchAnalysisSaveFile && !m_cCuAnalysis.openFile( m_pchAnalysisSaveFile, false ) )
+    {
+      fprintf( stderr, "\nfailed to open analysis file `%s' for writing\n", m_pchAnalysisSaveFile );
+      exit( EXIT_FAILURE );
+    }
+    m_cTEncTop.setCuAnalysisOutput( &m_cCuAnalysis );
+  }
+
+  if ( m_pchAnalysisLoadFile )
+  {
+    m_cCuAnalysisLoad.create( uiNumCtus, uiNumPartInCtu, 1 );
+    if ( !m_cCuAnalysisLoad.openFile( m_pchAnalysisLoadFile, true ) )
+    {
+      fprintf( stderr, "\nfailed to open analysis file `%s', or it was saved for another picture or CTU size\n", m_pchAnalysisLoadFile );
+      exit( EXIT_FAILURE );
+    }
+    m_cTEncTop.setCuAnalysisInput( &m_cCuAnalysisLoad );
+  }
 }
 
 Void TAppEncTop::xDestroyLib()
@@ -397,11 +474,30 @@ Void TAppEncTop::xDestroyLib()
 
   // Neo Decoder
   m_cTEncTop.destroy();
+
+  for ( UInt uiRung = 0; uiRung < m_apcRungEncoders.size(); uiRung++ )
+  {
+    m_apcRungEncoders[uiRung]->destroy();
+    delete m_apcRungEncoders[uiRung];
+    m_apcRungBitstreamFiles[uiRung]->close();
+    delete m_apcRungBitstreamFiles[uiRung];
+  }
+  m_apcRungEncoders.clear();
+  m_apcRungBitstreamFiles.clear();
+  m_cTEncTop.setCuAnalysisOutput( NULL );
+  m_cTEncTop.setCuAnalysisInput( NULL );
+  m_cCuAnalysis.destroy();
+  m_cCuAnalysisLoad.destroy();
 }
 
 Void TAppEncTop::xInitLib(Bool isFieldCoding)
 {
   m_cTEncTop.init(isFieldCoding);
+
+  for ( UInt uiRung = 0; uiRung < m_apcRungEncoders.size(); uiRung++ )
+  {
+    m_apcRungEncoders[uiRung]->init( isFieldCoding );
+  }
 }
 
 // ====================================================================================================================
@@ -425,7 +521,6 @@ Void TAppEncTop::encode()
     exit(EXIT_FAILURE);
   }
 
-  TComPicYuv*       pcPicYuvOrg = new TComPicYuv;
   TComPicYuv*       pcPicYuvRec = NULL;
 
   // initialize internal class & member variables
@@ -444,27 +539,24 @@ Void TAppEncTop::encode()
 
   list<AccessUnit> outputAccessUnits; ///< list of access units to write out.  is populated by the encoding process
 
-  TComPicYuv cPicYuvTrueOrg;
+  // with streaming output the encoder calls accessUnitEncoded() for each picture and outputAccessUnits stays empty
+  m_pcBitstreamOut = &bitstreamFile;
+  m_cTEncTop.setAccessUnitSink( m_bStreamAccessUnits ? this : NULL );
 
-  // allocate original YUV buffer
-  if( m_isField )
-  {
-    pcPicYuvOrg->create( m_iSourceWidth, m_iSourceHeightOrg, m_chromaFormatIDC, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxCUDepth );
-  cPicYuvTrueOrg.create(m_iSourceWidth, m_iSourceHeightOrg, m_chromaFormatIDC, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxCUDepth);
-  }
-  else
-  {
-    pcPicYuvOrg->create( m_iSourceWidth, m_iSourceHeight, m_chromaFormatIDC, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxCUDepth );
-  cPicYuvTrueOrg.create(m_iSourceWidth, m_iSourceHeight, m_chromaFormatIDC, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxCUDepth);
-  }
+  // allocate original YUV buffers and start reading the input
+  m_cInputQueue.create( &m_cTVideoIOYuvInputFile, m_isField ? (m_framesToBeEncoded >> 1) : m_framesToBeEncoded,
+                        m_iSourceWidth, m_isField ? m_iSourceHeightOrg : m_iSourceHeight, m_chromaFormatIDC, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxCUDepth,
+                        ipCSC, m_aiPad, m_InputChromaFormatIDC, m_iInputQueueDepth );
 
   while ( !bEos )
   {
     // get buffers
-    xGetBuffer(pcPicYuvRec);
+    xGetBuffer(m_cListPicYuvRec, pcPicYuvRec);
 
-    // read input YUV file
-    m_cTVideoIOYuvInputFile.read( pcPicYuvOrg, &cPicYuvTrueOrg, ipCSC, m_aiPad, m_InputChromaFormatIDC );
+    // get the next picture of the input YUV file
+    TAppEncInputPic* pcInputPic     = m_cInputQueue.getPicture();
+    TComPicYuv*      pcPicYuvOrg    = pcInputPic->pcPicYuvOrg;
+    TComPicYuv*      pcPicYuvTrueOrg = pcInputPic->pcPicYuvTrueOrg;
 
     // increase number of received frames
     m_iFrameRcvd++;
@@ -473,17 +565,30 @@ Void TAppEncTop::encode()
 
     Bool flush = 0;
     // if end of file (which is only detected on a read failure) flush the encoder of any queued pictures
-    if (m_cTVideoIOYuvInputFile.isEof())
+    if (pcInputPic->bEof)
     {
       flush = true;
       bEos = true;
       m_iFrameRcvd--;
       m_cTEncTop.setFramesToBeEncoded(m_iFrameRcvd);
+      for ( UInt uiRung = 0; uiRung < m_apcRungEncoders.size(); uiRung++ )
+      {
+        m_apcRungEncoders[uiRung]->setFramesToBeEncoded(m_iFrameRcvd);
+      }
     }
 
     // call encoding function for one frame
-    if ( m_isField ) m_cTEncTop.encode( bEos, flush ? 0 : pcPicYuvOrg, flush ? 0 : &cPicYuvTrueOrg, snrCSC, m_cListPicYuvRec, outputAccessUnits, iNumEncoded, m_isTopFieldFirst );
-    else             m_cTEncTop.encode( bEos, flush ? 0 : pcPicYuvOrg, flush ? 0 : &cPicYuvTrueOrg, snrCSC, m_cListPicYuvRec, outputAccessUnits, iNumEncoded );
+    if ( m_isField ) m_cTEncTop.encode( bEos, flush ? 0 : pcPicYuvOrg, flush ? 0 : pcPicYuvTrueOrg, snrCSC, m_cListPicYuvRec, outputAccessUnits, iNumEncoded, m_isTopFieldFirst );
+    else             m_cTEncTop.encode( bEos, flush ? 0 : pcPicYuvOrg, flush ? 0 : pcPicYuvTrueOrg, snrCSC, m_cListPicYuvRec, outputAccessUnits, iNumEncoded );
+
+    // the additional encoders code each GOP after the main encoder, so that its CU decisions are available
+    for ( UInt uiRung = 0; uiRung < m_apcRungEncoders.size(); uiRung++ )
+    {
+      xEncodeRung( uiRung, bEos, flush ? 0 : pcPicYuvOrg, flush ? 0 : pcPicYuvTrueOrg, snrCSC );
+    }
+
+    // the encoder has copied the picture, so its buffers can be read into again
+    m_cInputQueue.releasePicture( pcInputPic );
 
     // write bistream to file if necessary
     if ( iNumEncoded > 0 )
@@ -493,19 +598,29 @@ Void TAppEncTop::encode()
     }
   }
 
+  m_cTEncTop.setAccessUnitSink( NULL );
+  m_pcBitstreamOut = NULL;
+
   m_cTEncTop.printSummary(m_isField);
 
-  // delete original YUV buffer
-  pcPicYuvOrg->destroy();
-  delete pcPicYuvOrg;
-  pcPicYuvOrg = NULL;
+  const Double time = (Double) m_iFrameRcvd / m_iFrameRate;
+  for ( UInt uiRung = 0; uiRung < m_apcRungEncoders.size(); uiRung++ )
+  {
+    printf("\n\nMulti-rate bitstream %d (QP %d)\n", uiRung + 1, m_apcRungEncoders[uiRung]->getQP() );
+    m_apcRungEncoders[uiRung]->printSummary(m_isField);
+    printf("Bytes written to file: %u (%.3f kbps)\n", m_auiRungBytes[uiRung], 0.008 * m_auiRungBytes[uiRung] / time);
+    m_apcRungEncoders[uiRung]->deletePicBuffer();
+    xDeleteBuffer(m_acRungListPicYuvRec[uiRung]);
+  }
+
+  // delete original YUV buffers
+  m_cInputQueue.destroy();
 
   // delete used buffers in encoder class
   m_cTEncTop.deletePicBuffer();
-  cPicYuvTrueOrg.destroy();
 
   // delete buffers & classes
-  xDeleteBuffer();
+  xDeleteBuffer(m_cListPicYuvRec);
   xDestroyLib();
 
   printRateSummary();
@@ -523,14 +638,14 @@ Void TAppEncTop::encode()
  - end of the list has the latest picture
  .
  */
-Void TAppEncTop::xGetBuffer( TComPicYuv*& rpcPicYuvRec)
+Void TAppEncTop::xGetBuffer( TComList<TComPicYuv*>& rcListPicYuvRec, TComPicYuv*& rpcPicYuvRec)
 {
   assert( m_iGOPSize > 0 );
 
   // org. buffer
-  if ( m_cListPicYuvRec.size() >= (UInt)m_iGOPSize ) // buffer will be 1 element longer when using field coding, to maintain first field whilst processing second.
+  if ( rcListPicYuvRec.size() >= (UInt)m_iGOPSize ) // buffer will be 1 element longer when using field coding, to maintain first field whilst processing second.
   {
-    rpcPicYuvRec = m_cListPicYuvRec.popFront();
+    rpcPicYuvRec = rcListPicYuvRec.popFront();
 
   }
   else
@@ -540,14 +655,14 @@ Void TAppEncTop::xGetBuffer( TComPicYuv*& rpcPicYuvRec)
     rpcPicYuvRec->create( m_iSourceWidth, m_iSourceHeight, m_chromaFormatIDC, m_uiMaxCUWidth, m_uiMaxCUHeight, m_uiMaxCUDepth );
 
   }
-  m_cListPicYuvRec.pushBack( rpcPicYuvRec );
+  rcListPicYuvRec.pushBack( rpcPicYuvRec );
 }
 
-Void TAppEncTop::xDeleteBuffer( )
+Void TAppEncTop::xDeleteBuffer( TComList<TComPicYuv*>& rcListPicYuvRec )
 {
-  TComList<TComPicYuv*>::iterator iterPicYuvRec  = m_cListPicYuvRec.begin();
+  TComList<TComPicYuv*>::iterator iterPicYuvRec  = rcListPicYuvRec.begin();
 
-  Int iSize = Int( m_cListPicYuvRec.size() );
+  Int iSize = Int( rcListPicYuvRec.size() );
 
   for ( Int i = 0; i < iSize; i++ )
   {
@@ -586,13 +701,16 @@ Void TAppEncTop::xWriteOutput(std::ostream& bitstreamFile, Int iNumEncoded, cons
         m_cTVideoIOYuvReconFile.write( pcPicYuvRecTop, pcPicYuvRecBottom, ipCSC, m_confWinLeft, m_confWinRight, m_confWinTop, m_confWinBottom, NUM_CHROMA_FORMAT, m_isTopFieldFirst );
       }
 
-      const AccessUnit& auTop = *(iterBitstream++);
-      const vector<UInt>& statsTop = writeAnnexB(bitstreamFile, auTop);
-      rateStatsAccum(auTop, statsTop);
+      if (!m_bStreamAccessUnits)
+      {
+        const AccessUnit& auTop = *(iterBitstream++);
+        const vector<UInt>& statsTop = writeAnnexB(bitstreamFile, auTop);
+        rateStatsAccum(auTop, statsTop);
 
-      const AccessUnit& auBottom = *(iterBitstream++);
-      const vector<UInt>& statsBottom = writeAnnexB(bitstreamFile, auBottom);
-      rateStatsAccum(auBottom, statsBottom);
+        const AccessUnit& auBottom = *(iterBitstream++);
+        const vector<UInt>& statsBottom = writeAnnexB(bitstreamFile, auBottom);
+        rateStatsAccum(auBottom, statsBottom);
+      }
     }
   }
   else
@@ -615,13 +733,55 @@ Void TAppEncTop::xWriteOutput(std::ostream& bitstreamFile, Int iNumEncoded, cons
         m_cTVideoIOYuvReconFile.write( pcPicYuvRec, ipCSC, m_confWinLeft, m_confWinRight, m_confWinTop, m_confWinBottom );
       }
 
-      const AccessUnit& au = *(iterBitstream++);
-      const vector<UInt>& stats = writeAnnexB(bitstreamFile, au);
-      rateStatsAccum(au, stats);
+      if (!m_bStreamAccessUnits)
+      {
+        const AccessUnit& au = *(iterBitstream++);
+        const vector<UInt>& stats = writeAnnexB(bitstreamFile, au);
+        rateStatsAccum(au, stats);
+      }
     }
   }
 }
 
+/** \param uiRung          index of the additional encoder
+ *  \param bEos            last source picture
+ *  \param pcPicYuvOrg     source picture, NULL when flushing
+ *  \param pcPicYuvTrueOrg source picture before colour space conversion, NULL when flushing
+ *  \param snrCSC          colour space conversion for the quality measurement
+ */
+Void TAppEncTop::xEncodeRung(UInt uiRung, Bool bEos, TComPicYuv* pcPicYuvOrg, TComPicYuv* pcPicYuvTrueOrg, const InputColourSpaceConversion snrCSC)
+{
+  TEncTop*               pcRung          = m_apcRungEncoders[uiRung];
+  TComList<TComPicYuv*>& rcListPicYuvRec = m_acRungListPicYuvRec[uiRung];
+  TComPicYuv*            pcPicYuvRec     = NULL;
+  list<AccessUnit>       outputAccessUnits;
+  Int                    iNumEncoded     = 0;
+
+  xGetBuffer(rcListPicYuvRec, pcPicYuvRec);
+
+  if ( m_isField ) pcRung->encode( bEos, pcPicYuvOrg, pcPicYuvTrueOrg, snrCSC, rcListPicYuvRec, outputAccessUnits, iNumEncoded, m_isTopFieldFirst );
+  else             pcRung->encode( bEos, pcPicYuvOrg, pcPicYuvTrueOrg, snrCSC, rcListPicYuvRec, outputAccessUnits, iNumEncoded );
+
+  // only the bitstream is written, the reconstruction file belongs to the main encoder
+  for ( list<AccessUnit>::const_iterator it = outputAccessUnits.begin(); it != outputAccessUnits.end(); it++ )
+  {
+    const vector<UInt>& stats = writeAnnexB(*m_apcRungBitstreamFiles[uiRung], *it);
+    for ( UInt i = 0; i < stats.size(); i++ )
+    {
+      m_auiRungBytes[uiRung] += stats[i];
+    }
+  }
+}
+
+/** \param au  access unit that has just been finished by the encoder
+ */
+Void TAppEncTop::accessUnitEncoded(const AccessUnit& au)
+{
+  const vector<UInt>& stats = writeAnnexB(*m_pcBitstreamOut, au);
+  rateStatsAccum(au, stats);
+  m_pcBitstreamOut->flush();
+}
+
 /**
  *
  */
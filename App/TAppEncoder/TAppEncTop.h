@@ -40,11 +40,15 @@
 
 #include <list>
 #include <ostream>
+#include <fstream>
+#include <vector>
 
 #include "TLibEncoder/TEncTop.h"
+#include "TLibEncoder/TEncAccessUnitSink.h"
 #include "TLibVideoIO/TVideoIOYuv.h"
 #include "TLibCommon/AccessUnit.h"
 #include "TAppEncCfg.h"
+#include "TAppEncInputQueue.h"
 
 //! \ingroup TAppEncoder
 //! \{
@@ -54,21 +58,31 @@
 // ====================================================================================================================
 
 /// encoder application class
-class TAppEncTop : public TAppEncCfg
+class TAppEncTop : public TAppEncCfg, public TEncAccessUnitSink
 {
 private:
   // class interface
   TEncTop                    m_cTEncTop;                    ///< encoder class
   TVideoIOYuv                m_cTVideoIOYuvInputFile;       ///< input YUV file
   TVideoIOYuv                m_cTVideoIOYuvReconFile;       ///< output reconstruction file
+  TAppEncInputQueue          m_cInputQueue;                 ///< source pictures read from the input file
 
   TComList<TComPicYuv*>      m_cListPicYuvRec;              ///< list of reconstruction YUV files
 
   Int                        m_iFrameRcvd;                  ///< number of received frames
+  std::ostream*              m_pcBitstreamOut;              ///< bitstream file, while encoding
 
   UInt m_essentialBytes;
   UInt m_totalBytes;
 
+  // multi-rate encoding
+  std::vector<TEncTop*>      m_apcRungEncoders;             ///< encoders of the additional bitstreams, one per MultiRateQPOffsets entry
+  std::vector<std::fstream*> m_apcRungBitstreamFiles;       ///< bitstream files of the additional encoders
+  std::vector<TComList<TComPicYuv*> > m_acRungListPicYuvRec; ///< reconstruction buffers of the additional encoders
+  std::vector<UInt>          m_auiRungBytes;                ///< bytes written to the additional bitstream files
+  TEncCuAnalysis             m_cCuAnalysis;                 ///< CU decisions of the main encoder, used by the additional encoders and saved to the analysis file
+  TEncCuAnalysis             m_cCuAnalysisLoad;             ///< CU decisions loaded from the analysis file, used by the main encoder
+
 protected:
   // initialization
   Void  xCreateLib        ();                               ///< create files & encoder class
@@ -77,14 +91,18 @@ protected:
   Void  xDestroyLib       ();                               ///< destroy encoder class
 
   /// obtain required buffers
-  Void xGetBuffer(TComPicYuv*& rpcPicYuvRec);
+  Void xGetBuffer(TComList<TComPicYuv*>& rcListPicYuvRec, TComPicYuv*& rpcPicYuvRec);
 
   /// delete allocated buffers
-  Void  xDeleteBuffer     ();
+  Void  xDeleteBuffer     (TComList<TComPicYuv*>& rcListPicYuvRec);
+
+  /// encode a source picture with one of the additional encoders of a multi-rate encode
+  Void  xEncodeRung       (UInt uiRung, Bool bEos, TComPicYuv* pcPicYuvOrg, TComPicYuv* pcPicYuvTrueOrg, const InputColourSpaceConversion snrCSC);
 
   // file I/O
   Void xWriteOutput(std::ostream& bitstreamFile, Int iNumEncoded, const std::list<AccessUnit>& accessUnits); ///< write bitstream to file
   Void rateStatsAccum(const AccessUnit& au, const std::vector<UInt>& stats);
+  virtual Void accessUnitEncoded(const AccessUnit& au);     ///< write an access unit as soon as it is finished
   Void printRateSummary();
   Void printChromaFormat();
 
@@ -0,0 +1,201 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2014, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     yuvKernelBench.cpp
+    \brief    measures the time per call of the TComYuv block operations for each block size
+*/
+
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+
+#include "TLibCommon/TComRom.h"
+#include "TLibCommon/TComYuv.h"
+#include "TLibCommon/TComPicYuv.h"
+#include "TLibCommon/TComInterpolationFilter.h"
+#include "TAppCommon/program_options_lite.h"
+
+using namespace std;
+namespace po = df::program_options_lite;
+
+/// fills all planes of a buffer with pseudo-random samples in [iMin, iMax]
+static Void fillRandom(TComYuv& rcYuv, Int iMin, Int iMax)
+{
+  for (UInt ch = 0; ch < rcYuv.getNumberValidComponents(); ch++)
+  {
+    const ComponentID compID = ComponentID(ch);
+    Pel* pBuf = rcYuv.getAddr(compID);
+    for (UInt i = 0; i < rcYuv.getStride(compID) * rcYuv.getHeight(compID); i++)
+    {
+      pBuf[i] = Pel(iMin + rand() % (iMax - iMin + 1));
+    }
+  }
+}
+
+/// prints the average time of one call in nanoseconds
+static Void report(const char* name, UInt uiSize, clock_t start, UInt uiIterations)
+{
+  const Double dNs = Double(clock() - start) * 1e9 / CLOCKS_PER_SEC / uiIterations;
+  printf("%-20s %2ux%-2u %10.1f ns\n", name, uiSize, uiSize, dNs);
+}
+
+Int main(Int argc, const char** argv)
+{
+  Bool do_help;
+  UInt iterations;
+  UInt bitdepth;
+  UInt chromaFormatRaw;
+
+  po::Options opts;
+  opts.addOptions()
+  ("help", do_help, false, "this help text")
+  ("Iterations,n", iterations, 100000u, "number of calls timed per operation and block size")
+  ("BitDepth,d", bitdepth, 8u, "internal bit depth")
+  ("ChromaFormat", chromaFormatRaw, 420u, "chroma format. 400, 420, 422 or 444 only")
+  ;
+
+  po::setDefaults(opts);
+  po::scanArgv(opts, argc, argv);
+
+  if (do_help)
+  {
+    po::doHelp(cout, opts);
+    return EXIT_FAILURE;
+  }
+
+  ChromaFormat chromaFormatIDC=CHROMA_420;
+  switch (chromaFormatRaw)
+  {
+    case 400: chromaFormatIDC=CHROMA_400; break;
+    case 420: chromaFormatIDC=CHROMA_420; break;
+    case 422: chromaFormatIDC=CHROMA_422; break;
+    case 444: chromaFormatIDC=CHROMA_444; break;
+    default:
+      fprintf(stderr, "Bad chroma format string\n");
+      return EXIT_FAILURE;
+  }
+
+  for (UInt channelTypeIndex = 0; channelTypeIndex < MAX_NUM_CHANNEL_TYPE; channelTypeIndex++)
+  {
+    g_bitDepth[channelTypeIndex] = bitdepth;
+  }
+
+  // a single 64x64 CTU with 4x4 minimum blocks
+  const UInt uiMaxCUSize = 64;
+  const UInt uiMaxDepth  = 5;
+  g_uiMaxCUWidth  = uiMaxCUSize;
+  g_uiMaxCUHeight = uiMaxCUSize;
+  g_uiMaxCUDepth  = uiMaxDepth - 1;
+
+  UInt* piTmp = &g_auiZscanToRaster[0];
+  initZscanToRaster(uiMaxDepth, 1, 0, piTmp);
+  initRasterToZscan(uiMaxCUSize, uiMaxCUSize, uiMaxDepth);
+  initRasterToPelXY(uiMaxCUSize, uiMaxCUSize, uiMaxDepth);
+
+  TComPicYuv cPic;
+  cPic.create(uiMaxCUSize, uiMaxCUSize, chromaFormatIDC, uiMaxCUSize, uiMaxCUSize, g_uiMaxCUDepth);
+
+  const Int iMaxVal = (1 << bitdepth) - 1;
+
+  printf("%u iterations, %u-bit, chroma format %u\n", iterations, bitdepth, chromaFormatRaw);
+
+  for (UInt uiSize = 4; uiSize <= uiMaxCUSize; uiSize <<= 1)
+  {
+    TComYuv cOrg, cPred, cResi, cReco, cPred0, cPred1;
+    cOrg  .create(uiSize, uiSize, chromaFormatIDC);
+    cPred .create(uiSize, uiSize, chromaFormatIDC);
+    cResi .create(uiSize, uiSize, chromaFormatIDC);
+    cReco .create(uiSize, uiSize, chromaFormatIDC);
+    cPred0.create(uiSize, uiSize, chromaFormatIDC);
+    cPred1.create(uiSize, uiSize, chromaFormatIDC);
+
+    fillRandom(cOrg,   0, iMaxVal);
+    fillRandom(cPred,  0, iMaxVal);
+    fillRandom(cPred0, -IF_INTERNAL_OFFS, IF_INTERNAL_OFFS - 1);
+    fillRandom(cPred1, -IF_INTERNAL_OFFS, IF_INTERNAL_OFFS - 1);
+
+    clock_t start = clock();
+    for (UInt i = 0; i < iterations; i++)
+    {
+      cResi.subtract(&cOrg, &cPred, 0, uiSize);
+    }
+    report("subtract", uiSize, start, iterations);
+
+    start = clock();
+    for (UInt i = 0; i < iterations; i++)
+    {
+      cReco.addClip(&cPred, &cResi, 0, uiSize);
+    }
+    report("addClip", uiSize, start, iterations);
+
+    start = clock();
+    for (UInt i = 0; i < iterations; i++)
+    {
+      cReco.addAvg(&cPred0, &cPred1, 0, uiSize, uiSize);
+    }
+    report("addAvg", uiSize, start, iterations);
+
+    start = clock();
+    for (UInt i = 0; i < iterations; i++)
+    {
+      cOrg.copyPartToPartYuv(&cResi, 0, uiSize, uiSize);
+      cResi.removeHighFreq(&cPred, 0, uiSize, uiSize);
+    }
+    report("copy+removeHighFreq", uiSize, start, iterations);
+
+    start = clock();
+    for (UInt i = 0; i < iterations; i++)
+    {
+      cReco.copyPartToPartYuv(&cResi, 0, uiSize, uiSize);
+    }
+    report("copyPartToPartYuv", uiSize, start, iterations);
+
+    start = clock();
+    for (UInt i = 0; i < iterations; i++)
+    {
+      cReco.copyToPicYuv(&cPic, 0, 0);
+    }
+    report("copyToPicYuv", uiSize, start, iterations);
+
+    cOrg  .destroy();
+    cPred .destroy();
+    cResi .destroy();
+    cReco .destroy();
+    cPred0.destroy();
+    cPred1.destroy();
+  }
+
+  cPic.destroy();
+
+  return EXIT_SUCCESS;
+}
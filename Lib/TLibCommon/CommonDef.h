@@ -204,6 +204,14 @@ template <typename ValueType> inline ValueType rightShiftEvenRounding(const Valu
 // Adaptive search range depending on POC difference
 #define ADAPT_SR_SCALE              1           ///< division factor for adaptive search range
 
+// Per-CTU search control (encoder)
+#define CTU_SR_MARGIN               8           ///< margin added to the neighbouring motion for the per-CTU search range
+#define REF_PRUNE_MIN_SAMPLES       1024        ///< inter-coded 4x4 units of the picture needed before references are pruned
+
+// Search hints from the CU decisions of a reference encode (encoder)
+#define ANALYSIS_MV_REFINE_RANGE    8           ///< integer search range around the MV of the reference encode
+#define MAX_MULTI_RATE_RUNGS        8           ///< maximum number of additional bitstreams of a multi-rate encode
+
 #define CLIP_TO_709_RANGE           0
 
 // Early-skip threshold (encoder)
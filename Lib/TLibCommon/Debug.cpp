@@ -175,6 +175,11 @@ Void printRExtMacroSettings()
 
   PRINT_CONSTANT(RExt__O0043_BEST_EFFORT_DECODING,                                  settingNameWidth, settingValueWidth);
 
+  PRINT_CONSTANT(ENABLE_SIMD_OPT,                                                   settingNameWidth, settingValueWidth);
+  PRINT_CONSTANT(SIMD_SSE2,                                                         settingNameWidth, settingValueWidth);
+  PRINT_CONSTANT(ENABLE_WORKER_THREADS,                                             settingNameWidth, settingValueWidth);
+  PRINT_CONSTANT(FAST_CABAC_DECODER,                                                settingNameWidth, settingValueWidth);
+
   PRINT_CONSTANT(RExt__BACKWARDS_COMPATIBILITY_HM_TICKET_1149,                      settingNameWidth, settingValueWidth);
   PRINT_CONSTANT(RExt__BACKWARDS_COMPATIBILITY_HM_TICKET_1298,                      settingNameWidth, settingValueWidth);
   PRINT_CONSTANT(RExt__BACKWARDS_COMPATIBILITY_RBSP_EMULATION_PREVENTION,           settingNameWidth, settingValueWidth);
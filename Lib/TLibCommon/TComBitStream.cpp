@@ -40,6 +40,9 @@
 #include "TComBitStream.h"
 #include <string.h>
 #include <memory.h>
+#if SIMD_SSE2
+#include <emmintrin.h>
+#endif
 
 using namespace std;
 
@@ -80,11 +83,13 @@ TComInputBitstream::~TComInputBitstream()
 
 Char* TComOutputBitstream::getByteStream() const
 {
+  xFlushBytes();
   return (Char*) &m_fifo->front();
 }
 
-UInt TComOutputBitstream::getByteStreamLength()
+UInt TComOutputBitstream::getByteStreamLength() const
 {
+  xFlushBytes();
   return UInt(m_fifo->size());
 }
 
@@ -100,43 +105,29 @@ Void TComOutputBitstream::write   ( UInt uiBits, UInt uiNumberOfBits )
   assert( uiNumberOfBits <= 32 );
   assert( uiNumberOfBits == 32 || (uiBits & (~0 << uiNumberOfBits)) == 0 );
 
-  /* any modulo 8 remainder of num_total_bits cannot be written this time,
-   * and will be held until next time. */
-  UInt num_total_bits = uiNumberOfBits + m_num_held_bits;
-  UInt next_num_held_bits = num_total_bits % 8;
+  /* less than 32 bits are held between calls, so the new bits always fit
+   * into the 64-bit accumulator. NB, this requires that v only contains 0
+   * in bit positions {31..n} */
+  m_held_bits      = (m_held_bits << uiNumberOfBits) | uiBits;
+  m_num_held_bits += uiNumberOfBits;
 
-  /* form a byte aligned word (write_bits), by concatenating any held bits
-   * with the new bits, discarding the bits that will form the next_held_bits.
-   * eg: H = held bits, V = n new bits        /---- next_held_bits
-   * len(H)=7, len(V)=1: ... ---- HHHH HHHV . 0000 0000, next_num_held_bits=0
-   * len(H)=7, len(V)=2: ... ---- HHHH HHHV . V000 0000, next_num_held_bits=1
-   * if total_bits < 8, the value of v_ is not used */
-  UChar next_held_bits = uiBits << (8 - next_num_held_bits);
-
-  if (!(num_total_bits >> 3))
+  if (m_num_held_bits >= 32)
   {
-    /* insufficient bits accumulated to write out, append new_held_bits to
-     * current held_bits */
-    /* NB, this requires that v only contains 0 in bit positions {31..n} */
-    m_held_bits |= next_held_bits;
-    m_num_held_bits = next_num_held_bits;
-    return;
+    /* flush the oldest 32 bits as four bytes at once */
+    m_num_held_bits -= 32;
+    const UInt write_bits = UInt(m_held_bits >> m_num_held_bits);
+    const uint8_t bytes[4] = { uint8_t(write_bits >> 24), uint8_t(write_bits >> 16), uint8_t(write_bits >> 8), uint8_t(write_bits) };
+    m_fifo->insert(m_fifo->end(), bytes, bytes + 4);
   }
+}
 
-  /* topword serves to justify held_bits to align with the msb of uiBits */
-  UInt topword = (uiNumberOfBits - next_num_held_bits) & ~((1 << 3) -1);
-  UInt write_bits = (m_held_bits << topword) | (uiBits >> next_num_held_bits);
-
-  switch (num_total_bits >> 3)
+Void TComOutputBitstream::xFlushBytes() const
+{
+  while (m_num_held_bits >= 8)
   {
-  case 4: m_fifo->push_back(write_bits >> 24);
-  case 3: m_fifo->push_back(write_bits >> 16);
-  case 2: m_fifo->push_back(write_bits >> 8);
-  case 1: m_fifo->push_back(write_bits);
+    m_num_held_bits -= 8;
+    m_fifo->push_back(uint8_t(m_held_bits >> m_num_held_bits));
   }
-
-  m_held_bits = next_held_bits;
-  m_num_held_bits = next_num_held_bits;
 }
 
 Void TComOutputBitstream::writeAlignOne()
@@ -148,11 +139,12 @@ Void TComOutputBitstream::writeAlignOne()
 
 Void TComOutputBitstream::writeAlignZero()
 {
+  xFlushBytes();
   if (0 == m_num_held_bits)
   {
     return;
   }
-  m_fifo->push_back(m_held_bits);
+  m_fifo->push_back(uint8_t(m_held_bits << (8 - m_num_held_bits)));
   m_held_bits = 0;
   m_num_held_bits = 0;
 }
@@ -167,9 +159,25 @@ Void   TComOutputBitstream::addSubstream( TComOutputBitstream* pcSubstream )
   UInt uiNumBits = pcSubstream->getNumberOfWrittenBits();
 
   const vector<uint8_t>& rbsp = pcSubstream->getFIFO();
-  for (vector<uint8_t>::const_iterator it = rbsp.begin(); it != rbsp.end();)
+  if (getNumBitsUntilByteAligned() == 0)
   {
-    write(*it++, 8);
+    // byte aligned: the complete bytes can be appended as they are
+    xFlushBytes();
+    m_fifo->insert(m_fifo->end(), rbsp.begin(), rbsp.end());
+  }
+  else
+  {
+    const uint8_t* pData = rbsp.empty() ? NULL : &rbsp.front();
+    const UInt     uiNumBytes = UInt(rbsp.size());
+    UInt           i = 0;
+    for (; i + 4 <= uiNumBytes; i += 4)
+    {
+      write((UInt(pData[i]) << 24) | (UInt(pData[i+1]) << 16) | (UInt(pData[i+2]) << 8) | pData[i+3], 32);
+    }
+    for (; i < uiNumBytes; i++)
+    {
+      write(pData[i], 8);
+    }
   }
   if (uiNumBits&0x7)
   {
@@ -187,32 +195,59 @@ Int TComOutputBitstream::countStartCodeEmulations()
 {
   UInt cnt = 0;
   vector<uint8_t>& rbsp   = getFIFO();
-  for (vector<uint8_t>::iterator it = rbsp.begin(); it != rbsp.end();)
+  if (rbsp.empty())
+  {
+    return 0;
+  }
+  const uint8_t* const pEnd = &rbsp.front() + rbsp.size();
+  for (const uint8_t* p = findStartCodeEmulation(&rbsp.front(), pEnd); p != pEnd; p = findStartCodeEmulation(p, pEnd))
+  {
+    cnt++;
+  }
+  return cnt;
+}
+
+const uint8_t* TComOutputBitstream::findStartCodeEmulation( const uint8_t* p, const uint8_t* pEnd )
+{
+  while (pEnd - p >= 3)
   {
-    vector<uint8_t>::iterator found = it;
-    do
+#if SIMD_SSE2
+    // skip 16 positions at a time while no pair of zero bytes starts at any of them
+    const __m128i zero = _mm_setzero_si128();
+    while (pEnd - p >= 17)
     {
-      // find the next emulated 00 00 {00,01,02,03}
-      // NB, end()-1, prevents finding a trailing two byte sequence
-      found = search_n(found, rbsp.end()-1, 2, 0);
-      found++;
-      // if not found, found == end, otherwise found = second zero byte
-      if (found == rbsp.end())
+      const __m128i z0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)p), zero);
+      const __m128i z1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + 1)), zero);
+      if (_mm_movemask_epi8(_mm_and_si128(z0, z1)))
       {
+        while (p[0] != 0 || p[1] != 0)
+        {
+          p++;
+        }
         break;
       }
-      if (*(++found) <= 3)
+      p += 16;
+    }
+    if (pEnd - p < 3)
+    {
+      break;
+    }
+#endif
+    if (p[0] == 0 && p[1] == 0)
+    {
+      if (p[2] <= 3)
       {
-        break;
+        return p + 2;
       }
-    } while (true);
-    it = found;
-    if (found != rbsp.end())
+      // p[2] is non-zero, so the next pair cannot start before p+3
+      p += 3;
+    }
+    else
     {
-      cnt++;
+      p++;
     }
   }
-  return cnt;
+  return pEnd;
 }
 
 /**
@@ -310,6 +345,8 @@ Void TComOutputBitstream::insertAt(const TComOutputBitstream& src, UInt pos)
   UInt src_bits = src.getNumberOfWrittenBits();
   assert(0 == src_bits % 8);
 
+  src.xFlushBytes();
+  this->xFlushBytes();
   vector<uint8_t>::iterator at = this->m_fifo->begin() + pos;
   this->m_fifo->insert(at, src.m_fifo->begin(), src.m_fifo->end());
 }
@@ -329,6 +366,8 @@ UInt TComInputBitstream::readOutTrailingBits ()
 
 TComOutputBitstream& TComOutputBitstream::operator= (const TComOutputBitstream& src)
 {
+  src.xFlushBytes();
+  this->xFlushBytes();
   vector<uint8_t>::iterator at = this->m_fifo->begin();
   this->m_fifo->insert(at, src.m_fifo->begin(), src.m_fifo->end());
 
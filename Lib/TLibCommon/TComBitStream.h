@@ -82,9 +82,12 @@ class TComOutputBitstream : public TComBitIf
    */
   std::vector<uint8_t> *m_fifo;
 
-  UInt m_num_held_bits; /// number of bits not flushed to bytestream.
-  UChar m_held_bits; /// the bits held and not flushed to bytestream.
-                             /// this value is always msb-aligned, bigendian.
+  mutable UInt   m_num_held_bits; /// number of bits not flushed to bytestream, less than 32 between writes.
+  mutable UInt64 m_held_bits; /// the bits held and not flushed to bytestream.
+                             /// the m_num_held_bits lsbs are valid, the bits above them are stale.
+
+  /** move all complete bytes held in the accumulator to the fifo, leaving less than 8 held bits */
+  Void xFlushBytes() const;
 
 public:
   // create / destroy
@@ -120,7 +123,7 @@ public:
   /**
    * Return the number of valid bytes available from  getByteStream()
    */
-  UInt getByteStreamLength();
+  UInt getByteStreamLength() const;
 
   /**
    * Reset all internal state.
@@ -141,21 +144,29 @@ public:
   Void insertAt(const TComOutputBitstream& src, UInt pos);
 
   /**
-   * Return a reference to the internal fifo
+   * Return a reference to the internal fifo, holding all complete bytes written so far
    */
-  std::vector<uint8_t>& getFIFO() { return *m_fifo; }
+  std::vector<uint8_t>& getFIFO() { xFlushBytes(); return *m_fifo; }
 
-  UChar getHeldBits  ()          { return m_held_bits;          }
+  /** Return the bits of the incomplete last byte, msb-aligned */
+  UChar getHeldBits  ()          { xFlushBytes(); return UChar(m_held_bits << (8 - m_num_held_bits)); }
 
   TComOutputBitstream& operator= (const TComOutputBitstream& src);
   /** Return a reference to the internal fifo */
-  std::vector<uint8_t>& getFIFO() const { return *m_fifo; }
+  std::vector<uint8_t>& getFIFO() const { xFlushBytes(); return *m_fifo; }
 
   Void          addSubstream    ( TComOutputBitstream* pcSubstream );
   Void writeByteAlignment();
 
   //! returns the number of start code emulations contained in the current buffer
   Int countStartCodeEmulations();
+
+  /**
+   * Find the next byte in [pBegin, pEnd) that must be preceded by an emulation_prevention_three_byte,
+   * i.e. a byte <= 3 following two zero bytes, where the zero bytes must also lie in [pBegin, pEnd).
+   * Returns pEnd if there is none.
+   */
+  static const uint8_t* findStartCodeEmulation( const uint8_t* pBegin, const uint8_t* pEnd );
 };
 
 /**
@@ -198,10 +209,17 @@ public:
     byte = (*m_fifo)[m_fifo_idx - 1];
   }
 
+  Void        rewindBytes     ( UInt uiNumBytes )
+  {
+    assert(m_fifo_idx >= uiNumBytes);
+    m_fifo_idx -= uiNumBytes;
+  }
+
   UInt        readOutTrailingBits (); // NOTE: RExt - now returns the number of bits read.
   UChar getHeldBits  ()          { return m_held_bits;          }
   TComOutputBitstream& operator= (const TComOutputBitstream& src);
   UInt  getByteLocation              ( )                     { return m_fifo_idx                    ; }
+  UInt  getNumBytesLeft              ( )                     { return (UInt)m_fifo->size() - m_fifo_idx; }
 
   // Peek at bits in word-storage. Used in determining if we have completed reading of current bitstream and therefore slice in LCEC.
   UInt        peekBits (UInt uiBits) { UInt tmp; pseudoRead(uiBits, tmp); return tmp; }
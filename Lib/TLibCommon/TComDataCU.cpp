@@ -45,8 +45,78 @@
 
 #if ADAPTIVE_QP_SELECTION
   TCoeff * TComDataCU::m_pcGlbArlCoeff[MAX_NUM_COMPONENT] = { NULL, NULL, NULL };
+  UInt     TComDataCU::m_glbArlCoeffUsers = 0;
 #endif
 
+// ====================================================================================================================
+// Per-partition field layout
+// ====================================================================================================================
+
+/** The one-byte per-partition arrays of a CU are stored back to back, one array of m_uiNumPartition entries per field.
+ *  The fields that do not depend on the chroma components come first, so a 4:0:0 CU only has to copy the first
+ *  NUM_PART_FIELDS_LUMA of them.
+ */
+enum PartField
+{
+  PART_FIELD_QP = 0,
+  PART_FIELD_DEPTH,
+  PART_FIELD_WIDTH,
+  PART_FIELD_HEIGHT,
+  PART_FIELD_CHROMA_QP_ADJ,
+  PART_FIELD_SKIP_FLAG,
+  PART_FIELD_PART_SIZE,
+  PART_FIELD_PRED_MODE,
+  PART_FIELD_TRANSQUANT_BYPASS,
+  PART_FIELD_MERGE_FLAG,
+  PART_FIELD_MERGE_INDEX,
+  PART_FIELD_INTER_DIR,
+  PART_FIELD_TR_IDX,
+  PART_FIELD_IPCM_FLAG,
+  PART_FIELD_MVP_IDX,
+  PART_FIELD_MVP_NUM           = PART_FIELD_MVP_IDX + NUM_REF_PIC_LIST_01,
+  PART_FIELD_INTRA_DIR_LUMA    = PART_FIELD_MVP_NUM + NUM_REF_PIC_LIST_01,
+  PART_FIELD_COMPONENT_LUMA,
+  PART_FIELD_INTRA_DIR_CHROMA  = PART_FIELD_COMPONENT_LUMA + 4,
+  PART_FIELD_COMPONENT_CHROMA,
+  NUM_PART_FIELDS              = PART_FIELD_COMPONENT_CHROMA + 4 * (MAX_NUM_COMPONENT - 1),
+  NUM_PART_FIELDS_LUMA         = PART_FIELD_INTRA_DIR_CHROMA
+};
+
+enum ComponentPartField
+{
+  COMPONENT_PART_FIELD_CCP_ALPHA = 0,
+  COMPONENT_PART_FIELD_TRANSFORM_SKIP,
+  COMPONENT_PART_FIELD_EXPLICIT_RDPCM,
+  COMPONENT_PART_FIELD_CBF,
+  NUM_COMPONENT_PART_FIELDS
+};
+
+static inline UInt componentPartField( const ComponentID compID, const ComponentPartField field )
+{
+  return isLuma(compID) ? (PART_FIELD_COMPONENT_LUMA + field)
+                        : (PART_FIELD_COMPONENT_CHROMA + (compID - COMPONENT_Cb) * NUM_COMPONENT_PART_FIELDS + field);
+}
+
+static inline UChar* partField( UChar* pFields, const UInt uiStride, const UInt field )
+{
+  return pFields + field * uiStride;
+}
+
+static inline UInt alignBufferSize( const UInt size )
+{
+  return (size + 15) & ~15;
+}
+
+/** Copy uiNumPart entries of the first uiNumFields per-partition fields.
+ */
+static inline Void copyPartFields( UChar* pDst, const UInt uiDstStride, const UChar* pSrc, const UInt uiSrcStride, const UInt uiNumPart, const UInt uiNumFields )
+{
+  for (UInt field = 0; field < uiNumFields; field++)
+  {
+    memcpy( pDst + field * uiDstStride, pSrc + field * uiSrcStride, uiNumPart );
+  }
+}
+
 // ====================================================================================================================
 // Constructor / destructor / create / destroy
 // ====================================================================================================================
@@ -107,18 +177,94 @@ TComDataCU::TComDataCU()
   m_bDecSubCu          = false;
   m_sliceStartCU        = 0;
   m_sliceSegmentStartCU = 0;
+
+  m_puhBuffer          = NULL;
+  m_bExternalBuffer    = false;
+  m_puhPartFields      = NULL;
+  m_uiPartFieldStride  = 0;
+
+  m_pcCandCache        = NULL;
 }
 
 TComDataCU::~TComDataCU()
 {
 }
 
+/** Compute where each array of a CU is placed within its buffer. The one-byte per-partition arrays come first,
+ *  back to back, so that they can be copied with a loop over a single stride.
+ */
+Void TComDataCU::xGetBufferLayout( BufferLayout& layout, ChromaFormat chromaFormatIDC, UInt uiNumPartition, UInt uiWidth, UInt uiHeight, Bool bDecSubCu, Bool bGlobalRMARLBuffer )
+{
+  UInt offset = 0;
+
+  layout.partFields = offset;
+  if ( !bDecSubCu )
+  {
+    offset += alignBufferSize( NUM_PART_FIELDS * uiNumPartition );
+  }
+
+  for(UInt i=0; i<NUM_REF_PIC_LIST_01; i++)
+  {
+    layout.mvField[i] = offset;
+    if ( !bDecSubCu )
+    {
+      offset += TComCUMvField::getBufferSize( uiNumPartition );
+    }
+  }
+
+  layout.sliceStartCU        = offset;  offset += alignBufferSize( sizeof(UInt) * uiNumPartition );
+  layout.sliceSegmentStartCU = offset;  offset += alignBufferSize( sizeof(UInt) * uiNumPartition );
+
+  for (UInt comp=0; comp<MAX_NUM_COMPONENT; comp++)
+  {
+    const ComponentID compID = ComponentID(comp);
+    const UInt totalSize     = bDecSubCu ? 0 : ((uiWidth * uiHeight) >> (getComponentScaleX(compID, chromaFormatIDC) + getComponentScaleY(compID, chromaFormatIDC)));
+
+    layout.coeff[comp]     = offset;  offset += alignBufferSize( sizeof(TCoeff) * totalSize );
+    layout.arlCoeff[comp]  = offset;
+#if ADAPTIVE_QP_SELECTION
+    if ( !bGlobalRMARLBuffer )
+    {
+      offset += alignBufferSize( sizeof(TCoeff) * totalSize );
+    }
+#endif
+    layout.pcmSample[comp] = offset;  offset += alignBufferSize( sizeof(Pel) * totalSize );
+  }
+
+  layout.totalSize = offset;
+}
+
+/** Size in bytes of the buffer that create() needs for a CU with the given parameters.
+ */
+UInt TComDataCU::getBufferSize( ChromaFormat chromaFormatIDC, UInt uiNumPartition, UInt uiWidth, UInt uiHeight, Bool bDecSubCu
+#if ADAPTIVE_QP_SELECTION
+                               , Bool bGlobalRMARLBuffer
+#endif
+                               )
+{
+#if !ADAPTIVE_QP_SELECTION
+  const Bool bGlobalRMARLBuffer = false;
+#endif
+  BufferLayout layout;
+  xGetBufferLayout( layout, chromaFormatIDC, uiNumPartition, uiWidth, uiHeight, bDecSubCu, bGlobalRMARLBuffer );
+  return layout.totalSize;
+}
+
+/** Create the CU data. All arrays are placed in a single buffer: either pBuffer, which must hold getBufferSize()
+ *  bytes and remains owned by the caller, or a buffer allocated here.
+ */
 Void TComDataCU::create( ChromaFormat chromaFormatIDC, UInt uiNumPartition, UInt uiWidth, UInt uiHeight, Bool bDecSubCu, Int unitSize
 #if ADAPTIVE_QP_SELECTION
                         , Bool bGlobalRMARLBuffer
 #endif
+                        , UChar *pBuffer
                         )
 {
+#if !ADAPTIVE_QP_SELECTION
+  const Bool bGlobalRMARLBuffer = false;
+#endif
+  assert( sizeof(Bool) == 1 && sizeof(Char) == 1 );
+
   m_bDecSubCu = bDecSubCu;
 
   m_pcPic              = NULL;
@@ -126,73 +272,85 @@ Void TComDataCU::create( ChromaFormat chromaFormatIDC, UInt uiNumPartition, UInt
   m_uiNumPartition     = uiNumPartition;
   m_unitSize = unitSize;
 
+  BufferLayout layout;
+  xGetBufferLayout( layout, chromaFormatIDC, uiNumPartition, uiWidth, uiHeight, bDecSubCu, bGlobalRMARLBuffer );
+
+  m_bExternalBuffer = (pBuffer != NULL);
+  m_puhBuffer       = m_bExternalBuffer ? pBuffer : (UChar*)xMalloc(UChar, layout.totalSize);
+  memset( m_puhBuffer, 0, layout.totalSize );
+
   if ( !bDecSubCu )
   {
-    m_phQP               = (Char*     )xMalloc(Char,     uiNumPartition);
-    m_puhDepth           = (UChar*    )xMalloc(UChar,    uiNumPartition);
-    m_puhWidth           = (UChar*    )xMalloc(UChar,    uiNumPartition);
-    m_puhHeight          = (UChar*    )xMalloc(UChar,    uiNumPartition);
+    m_puhPartFields      = m_puhBuffer + layout.partFields;
+    m_uiPartFieldStride  = uiNumPartition;
 
-    m_ChromaQpAdj        = new UChar[ uiNumPartition ];
-    m_skipFlag           = new Bool[ uiNumPartition ];
-    m_pePartSize         = new Char[ uiNumPartition ];
+    m_phQP               = (Char*  )partField(m_puhPartFields, uiNumPartition, PART_FIELD_QP);
+    m_puhDepth           = (UChar* )partField(m_puhPartFields, uiNumPartition, PART_FIELD_DEPTH);
+    m_puhWidth           = (UChar* )partField(m_puhPartFields, uiNumPartition, PART_FIELD_WIDTH);
+    m_puhHeight          = (UChar* )partField(m_puhPartFields, uiNumPartition, PART_FIELD_HEIGHT);
+
+    m_ChromaQpAdj        = (UChar* )partField(m_puhPartFields, uiNumPartition, PART_FIELD_CHROMA_QP_ADJ);
+    m_skipFlag           = (Bool*  )partField(m_puhPartFields, uiNumPartition, PART_FIELD_SKIP_FLAG);
+    m_pePartSize         = (Char*  )partField(m_puhPartFields, uiNumPartition, PART_FIELD_PART_SIZE);
     memset( m_pePartSize, NUMBER_OF_PART_SIZES,uiNumPartition * sizeof( *m_pePartSize ) );
-    m_pePredMode         = new Char[ uiNumPartition ];
-    m_CUTransquantBypass = new Bool[ uiNumPartition ];
+    m_pePredMode         = (Char*  )partField(m_puhPartFields, uiNumPartition, PART_FIELD_PRED_MODE);
+    m_CUTransquantBypass = (Bool*  )partField(m_puhPartFields, uiNumPartition, PART_FIELD_TRANSQUANT_BYPASS);
 
-    m_pbMergeFlag        = (Bool*  )xMalloc(Bool,   uiNumPartition);
-    m_puhMergeIndex      = (UChar* )xMalloc(UChar,  uiNumPartition);
+    m_pbMergeFlag        = (Bool*  )partField(m_puhPartFields, uiNumPartition, PART_FIELD_MERGE_FLAG);
+    m_puhMergeIndex      = (UChar* )partField(m_puhPartFields, uiNumPartition, PART_FIELD_MERGE_INDEX);
 
-    for (UInt ch=0; ch<MAX_NUM_CHANNEL_TYPE; ch++)
-    {
-      m_puhIntraDir[ch] = (UChar* )xMalloc(UChar,  uiNumPartition);
-    }
-    m_puhInterDir        = (UChar* )xMalloc(UChar,  uiNumPartition);
+    m_puhIntraDir[CHANNEL_TYPE_LUMA]   = (UChar* )partField(m_puhPartFields, uiNumPartition, PART_FIELD_INTRA_DIR_LUMA);
+    m_puhIntraDir[CHANNEL_TYPE_CHROMA] = (UChar* )partField(m_puhPartFields, uiNumPartition, PART_FIELD_INTRA_DIR_CHROMA);
+    m_puhInterDir        = (UChar* )partField(m_puhPartFields, uiNumPartition, PART_FIELD_INTER_DIR);
 
-    m_puhTrIdx           = (UChar* )xMalloc(UChar,  uiNumPartition);
+    m_puhTrIdx           = (UChar* )partField(m_puhPartFields, uiNumPartition, PART_FIELD_TR_IDX);
 
     for(UInt i=0; i<NUM_REF_PIC_LIST_01; i++)
     {
       const RefPicList rpl=RefPicList(i);
-      m_apiMVPIdx[rpl]       = new Char[ uiNumPartition ];
-      m_apiMVPNum[rpl]       = new Char[ uiNumPartition ];
+      m_apiMVPIdx[rpl]       = (Char*  )partField(m_puhPartFields, uiNumPartition, PART_FIELD_MVP_IDX + i);
+      m_apiMVPNum[rpl]       = (Char*  )partField(m_puhPartFields, uiNumPartition, PART_FIELD_MVP_NUM + i);
       memset( m_apiMVPIdx[rpl], -1,uiNumPartition * sizeof( Char ) );
     }
 
     for (UInt comp=0; comp<MAX_NUM_COMPONENT; comp++)
     {
       const ComponentID compID = ComponentID(comp);
-      const UInt chromaShift = getComponentScaleX(compID, chromaFormatIDC) + getComponentScaleY(compID, chromaFormatIDC);
-      const UInt totalSize   = (uiWidth * uiHeight) >> chromaShift;
 
-      m_crossComponentPredictionAlpha[compID] = (Char*  )xMalloc(Char,   uiNumPartition);
-      m_puhTransformSkip[compID]              = (UChar* )xMalloc(UChar,  uiNumPartition);
-      m_explicitRdpcmMode[compID]             = (UChar* )xMalloc(UChar,  uiNumPartition);
-      m_puhCbf[compID]                        = (UChar* )xMalloc(UChar,  uiNumPartition);
-      m_pcTrCoeff[compID]                     = (TCoeff*)xMalloc(TCoeff, totalSize);
-      memset( m_pcTrCoeff[compID], 0, (totalSize * sizeof( TCoeff )) );
+      m_crossComponentPredictionAlpha[compID] = (Char*  )partField(m_puhPartFields, uiNumPartition, componentPartField(compID, COMPONENT_PART_FIELD_CCP_ALPHA));
+      m_puhTransformSkip[compID]              = (UChar* )partField(m_puhPartFields, uiNumPartition, componentPartField(compID, COMPONENT_PART_FIELD_TRANSFORM_SKIP));
+      m_explicitRdpcmMode[compID]             = (UChar* )partField(m_puhPartFields, uiNumPartition, componentPartField(compID, COMPONENT_PART_FIELD_EXPLICIT_RDPCM));
+      m_puhCbf[compID]                        = (UChar* )partField(m_puhPartFields, uiNumPartition, componentPartField(compID, COMPONENT_PART_FIELD_CBF));
+      m_pcTrCoeff[compID]                     = (TCoeff*)(m_puhBuffer + layout.coeff[comp]);
 
 #if ADAPTIVE_QP_SELECTION
       if( bGlobalRMARLBuffer )
       {
-        if (m_pcGlbArlCoeff[compID] == NULL) m_pcGlbArlCoeff[compID] = (TCoeff*)xMalloc(TCoeff, totalSize);
+        // sized for the largest CU, as the buffer may outlive the CUs (and the picture format) it was created for
+        if (m_pcGlbArlCoeff[compID] == NULL) m_pcGlbArlCoeff[compID] = (TCoeff*)xMalloc(TCoeff, MAX_CU_SIZE * MAX_CU_SIZE);
 
         m_pcArlCoeff[compID] = m_pcGlbArlCoeff[compID];
         m_ArlCoeffIsAliasedAllocation = true;
       }
       else
       {
-         m_pcArlCoeff[compID] = (TCoeff*)xMalloc(TCoeff, totalSize);
+         m_pcArlCoeff[compID] = (TCoeff*)(m_puhBuffer + layout.arlCoeff[comp]);
       }
 #endif
-      m_pcIPCMSample[compID] = (Pel*   )xMalloc(Pel , totalSize);
+      m_pcIPCMSample[compID] = (Pel*   )(m_puhBuffer + layout.pcmSample[comp]);
+    }
+#if ADAPTIVE_QP_SELECTION
+    if (m_ArlCoeffIsAliasedAllocation)
+    {
+      m_glbArlCoeffUsers++;
     }
+#endif
 
-    m_pbIPCMFlag         = (Bool*  )xMalloc(Bool, uiNumPartition);
+    m_pbIPCMFlag         = (Bool*  )partField(m_puhPartFields, uiNumPartition, PART_FIELD_IPCM_FLAG);
 
     for(UInt i=0; i<NUM_REF_PIC_LIST_01; i++)
     {
-      m_acCUMvField[i].create( uiNumPartition );
+      m_acCUMvField[i].create( uiNumPartition, m_puhBuffer + layout.mvField[i] );
     }
 
   }
@@ -204,8 +362,8 @@ Void TComDataCU::create( ChromaFormat chromaFormatIDC, UInt uiNumPartition, UInt
     }
   }
 
-  m_sliceStartCU        = (UInt*  )xMalloc(UInt, uiNumPartition);
-  m_sliceSegmentStartCU = (UInt*  )xMalloc(UInt, uiNumPartition);
+  m_sliceStartCU        = (UInt*  )(m_puhBuffer + layout.sliceStartCU);
+  m_sliceSegmentStartCU = (UInt*  )(m_puhBuffer + layout.sliceSegmentStartCU);
 
   // create motion vector fields
 
@@ -225,56 +383,20 @@ Void TComDataCU::destroy()
   // encoder-side buffer free
   if ( !m_bDecSubCu )
   {
-    if ( m_phQP               ) { xFree(m_phQP);                m_phQP               = NULL; }
-    if ( m_puhDepth           ) { xFree(m_puhDepth);            m_puhDepth           = NULL; }
-    if ( m_puhWidth           ) { xFree(m_puhWidth);            m_puhWidth           = NULL; }
-    if ( m_puhHeight          ) { xFree(m_puhHeight);           m_puhHeight          = NULL; }
-
-    if ( m_skipFlag           ) { delete[] m_skipFlag;          m_skipFlag          = NULL; }
-
-    if ( m_pePartSize         ) { delete[] m_pePartSize;        m_pePartSize         = NULL; }
-    if ( m_pePredMode         ) { delete[] m_pePredMode;        m_pePredMode         = NULL; }
-    if ( m_ChromaQpAdj        ) { delete[] m_ChromaQpAdj;       m_ChromaQpAdj        = NULL; }
-    if ( m_CUTransquantBypass ) { delete[] m_CUTransquantBypass;m_CUTransquantBypass = NULL; }
-    if ( m_puhInterDir        ) { xFree(m_puhInterDir);         m_puhInterDir        = NULL; }
-    if ( m_pbMergeFlag        ) { xFree(m_pbMergeFlag);         m_pbMergeFlag        = NULL; }
-    if ( m_puhMergeIndex      ) { xFree(m_puhMergeIndex);       m_puhMergeIndex      = NULL; }
-
-    for (UInt ch=0; ch<MAX_NUM_CHANNEL_TYPE; ch++)
-    {
-      xFree(m_puhIntraDir[ch]);
-      m_puhIntraDir[ch] = NULL;
-    }
-
-    if ( m_puhTrIdx           ) { xFree(m_puhTrIdx);            m_puhTrIdx          = NULL; }
-
-    for (UInt comp=0; comp<MAX_NUM_COMPONENT; comp++)
-    {
-      if ( m_crossComponentPredictionAlpha[comp] ) { xFree(m_crossComponentPredictionAlpha[comp]); m_crossComponentPredictionAlpha[comp] = NULL; }
-      if ( m_puhTransformSkip[comp]              ) { xFree(m_puhTransformSkip[comp]);              m_puhTransformSkip[comp]              = NULL; }
-      if ( m_puhCbf[comp]                        ) { xFree(m_puhCbf[comp]);                        m_puhCbf[comp]                        = NULL; }
-      if ( m_pcTrCoeff[comp]                     ) { xFree(m_pcTrCoeff[comp]);                     m_pcTrCoeff[comp]                     = NULL; }
-      if ( m_explicitRdpcmMode[comp]             ) { xFree(m_explicitRdpcmMode[comp]);             m_explicitRdpcmMode[comp]             = NULL; }
-
 #if ADAPTIVE_QP_SELECTION
-      if (!m_ArlCoeffIsAliasedAllocation)
+    // the global ARL buffer is released with the last CU that shares it
+    if (m_ArlCoeffIsAliasedAllocation)
+    {
+      m_ArlCoeffIsAliasedAllocation = false;
+      if (--m_glbArlCoeffUsers == 0)
       {
-        if ( m_pcArlCoeff[comp]     ) { xFree(m_pcArlCoeff[comp]);      m_pcArlCoeff[comp]    = NULL; }
+        for (UInt comp=0; comp<MAX_NUM_COMPONENT; comp++)
+        {
+          if ( m_pcGlbArlCoeff[comp] ) { xFree(m_pcGlbArlCoeff[comp]); m_pcGlbArlCoeff[comp] = NULL; }
+        }
       }
-
-      if ( m_pcGlbArlCoeff[comp]  ) { xFree(m_pcGlbArlCoeff[comp]);   m_pcGlbArlCoeff[comp] = NULL; }
-#endif
-
-      if ( m_pcIPCMSample[comp]   ) { xFree(m_pcIPCMSample[comp]);    m_pcIPCMSample[comp]  = NULL; }
-    }
-    if ( m_pbIPCMFlag         ) { xFree(m_pbIPCMFlag   );       m_pbIPCMFlag        = NULL; }
-
-    for(UInt i=0; i<NUM_REF_PIC_LIST_01; i++)
-    {
-      const RefPicList rpl=RefPicList(i);
-      if ( m_apiMVPIdx[rpl]       ) { delete[] m_apiMVPIdx[rpl];      m_apiMVPIdx[rpl]      = NULL; }
-      if ( m_apiMVPNum[rpl]       ) { delete[] m_apiMVPNum[rpl];      m_apiMVPNum[rpl]      = NULL; }
     }
+#endif
 
     for(UInt i=0; i<NUM_REF_PIC_LIST_01; i++)
     {
@@ -283,6 +405,56 @@ Void TComDataCU::destroy()
     }
   }
 
+  // all the per-partition arrays live in m_puhBuffer
+  if ( m_puhBuffer && !m_bExternalBuffer )
+  {
+    xFree(m_puhBuffer);
+  }
+  m_puhBuffer          = NULL;
+  m_bExternalBuffer    = false;
+  m_puhPartFields      = NULL;
+
+  delete m_pcCandCache;
+  m_pcCandCache        = NULL;
+
+  m_phQP               = NULL;
+  m_puhDepth           = NULL;
+  m_puhWidth           = NULL;
+  m_puhHeight          = NULL;
+  m_skipFlag           = NULL;
+  m_pePartSize         = NULL;
+  m_pePredMode         = NULL;
+  m_ChromaQpAdj        = NULL;
+  m_CUTransquantBypass = NULL;
+  m_puhInterDir        = NULL;
+  m_pbMergeFlag        = NULL;
+  m_puhMergeIndex      = NULL;
+  m_puhTrIdx           = NULL;
+  m_pbIPCMFlag         = NULL;
+  for (UInt ch=0; ch<MAX_NUM_CHANNEL_TYPE; ch++)
+  {
+    m_puhIntraDir[ch] = NULL;
+  }
+  for (UInt comp=0; comp<MAX_NUM_COMPONENT; comp++)
+  {
+    m_crossComponentPredictionAlpha[comp] = NULL;
+    m_puhTransformSkip[comp]              = NULL;
+    m_puhCbf[comp]                        = NULL;
+    m_pcTrCoeff[comp]                     = NULL;
+    m_explicitRdpcmMode[comp]             = NULL;
+#if ADAPTIVE_QP_SELECTION
+    m_pcArlCoeff[comp]                    = NULL;
+#endif
+    m_pcIPCMSample[comp]                  = NULL;
+  }
+  for(UInt i=0; i<NUM_REF_PIC_LIST_01; i++)
+  {
+    m_apiMVPIdx[i] = NULL;
+    m_apiMVPNum[i] = NULL;
+  }
+  m_sliceStartCU        = NULL;
+  m_sliceSegmentStartCU = NULL;
+
   m_pcPic              = NULL;
   m_pcSlice            = NULL;
 
@@ -296,17 +468,34 @@ Void TComDataCU::destroy()
   {
     m_apcCUColocated[i]  = NULL;
   }
+}
 
-  if( m_sliceStartCU )
+Void TComDataCU::enableCandidateCache()
+{
+  if ( m_pcCandCache == NULL )
   {
-    xFree(m_sliceStartCU);
-    m_sliceStartCU=NULL;
+    m_pcCandCache = new CandidateCache;
   }
-  if(m_sliceSegmentStartCU )
+  xInvalidateCandidateCache();
+}
+
+/** Drops the cached candidate lists, called whenever the CU moves to another position.
+ * The neighbours of a CU do not change while its coding modes are being decided, so the lists stay valid until then.
+ */
+Void TComDataCU::xInvalidateCandidateCache()
+{
+  if ( m_pcCandCache == NULL )
+  {
+    return;
+  }
+  for ( UInt partSize = 0; partSize < NUMBER_OF_PART_SIZES; partSize++ )
   {
-    xFree(m_sliceSegmentStartCU);
-    m_sliceSegmentStartCU=NULL;
+    for ( UInt puIdx = 0; puIdx < 4; puIdx++ )
+    {
+      m_pcCandCache->acMergeList[partSize][puIdx].bValid = false;
+    }
   }
+  ::memset( m_pcCandCache->abAMVPValid, 0, sizeof( m_pcCandCache->abAMVPValid ) );
 }
 
 
@@ -328,6 +517,7 @@ Void TComDataCU::destroy()
  */
 Void TComDataCU::initCU( TComPic* pcPic, UInt iCUAddr )
 {
+  xInvalidateCandidateCache();
 
   m_pcPic              = pcPic;
   m_pcSlice            = pcPic->getSlice(pcPic->getCurrSliceIdx());
@@ -617,6 +807,8 @@ Void TComDataCU::initSubCU( TComDataCU* pcCU, UInt uiPartUnitIdx, UInt uiDepth,
 {
   assert( uiPartUnitIdx<4 );
 
+  xInvalidateCandidateCache();
+
   UInt uiPartOffset = ( pcCU->getTotalNumPart()>>2 )*uiPartUnitIdx;
 
   m_pcPic              = pcCU->getPic();
@@ -796,6 +988,8 @@ Void TComDataCU::copySubCU( TComDataCU* pcCU, UInt uiAbsPartIdx, UInt uiDepth )
 {
   UInt uiPart = uiAbsPartIdx;
 
+  xInvalidateCandidateCache();
+
   m_pcPic              = pcCU->getPic();
   m_pcSlice            = pcCU->getSlice();
   m_uiCUAddr           = pcCU->getAddr();
@@ -935,43 +1129,11 @@ Void TComDataCU::copyPartFrom( TComDataCU* pcCU, UInt uiPartUnitIdx, UInt uiDept
 
   UInt uiOffset         = pcCU->getTotalNumPart()*uiPartUnitIdx;
   const UInt numValidComp=pcCU->getPic()->getNumberValidComponents();
-  const UInt numValidChan=pcCU->getPic()->getChromaFormat()==CHROMA_400 ? 1:2;
 
   UInt uiNumPartition = pcCU->getTotalNumPart();
-  Int iSizeInUchar  = sizeof( UChar ) * uiNumPartition;
-  Int iSizeInBool   = sizeof( Bool  ) * uiNumPartition;
+  const UInt numPartFields = numValidComp == 1 ? NUM_PART_FIELDS_LUMA : NUM_PART_FIELDS;
 
-  Int sizeInChar  = sizeof( Char ) * uiNumPartition;
-  memcpy( m_skipFlag   + uiOffset, pcCU->getSkipFlag(),       sizeof( *m_skipFlag )   * uiNumPartition );
-  memcpy( m_phQP       + uiOffset, pcCU->getQP(),             sizeInChar                        );
-  memcpy( m_pePartSize + uiOffset, pcCU->getPartitionSize(),  sizeof( *m_pePartSize ) * uiNumPartition );
-  memcpy( m_pePredMode + uiOffset, pcCU->getPredictionMode(), sizeof( *m_pePredMode ) * uiNumPartition );
-  memcpy( m_ChromaQpAdj + uiOffset, pcCU->getChromaQpAdj(),   sizeof( *m_ChromaQpAdj ) * uiNumPartition );
-  memcpy( m_CUTransquantBypass + uiOffset, pcCU->getCUTransquantBypass(), sizeof( *m_CUTransquantBypass ) * uiNumPartition );
-  memcpy( m_pbMergeFlag         + uiOffset, pcCU->getMergeFlag(),         iSizeInBool  );
-  memcpy( m_puhMergeIndex       + uiOffset, pcCU->getMergeIndex(),        iSizeInUchar );
-
-  for (UInt ch=0; ch<numValidChan; ch++)
-  {
-    memcpy( m_puhIntraDir[ch]   + uiOffset, pcCU->getIntraDir(ChannelType(ch)), iSizeInUchar );
-  }
-
-  memcpy( m_puhInterDir         + uiOffset, pcCU->getInterDir(),          iSizeInUchar );
-  memcpy( m_puhTrIdx            + uiOffset, pcCU->getTransformIdx(),      iSizeInUchar );
-
-  for(UInt comp=0; comp<numValidComp; comp++)
-  {
-    memcpy( m_crossComponentPredictionAlpha[comp] + uiOffset, pcCU->getCrossComponentPredictionAlpha(ComponentID(comp)), iSizeInUchar );
-    memcpy( m_puhTransformSkip[comp]              + uiOffset, pcCU->getTransformSkip(ComponentID(comp))                , iSizeInUchar );
-    memcpy( m_puhCbf[comp]                        + uiOffset, pcCU->getCbf(ComponentID(comp))                          , iSizeInUchar );
-    memcpy( m_explicitRdpcmMode[comp]             + uiOffset, pcCU->getExplicitRdpcmMode(ComponentID(comp))            , iSizeInUchar );
-  }
-
-  memcpy( m_puhDepth  + uiOffset, pcCU->getDepth(),  iSizeInUchar );
-  memcpy( m_puhWidth  + uiOffset, pcCU->getWidth(),  iSizeInUchar );
-  memcpy( m_puhHeight + uiOffset, pcCU->getHeight(), iSizeInUchar );
-
-  memcpy( m_pbIPCMFlag + uiOffset, pcCU->getIPCMFlag(), iSizeInBool );
+  copyPartFields( m_puhPartFields + uiOffset, m_uiPartFieldStride, pcCU->m_puhPartFields, pcCU->m_uiPartFieldStride, uiNumPartition, numPartFields );
 
   m_pcCUAboveLeft      = pcCU->getCUAboveLeft();
   m_pcCUAboveRight     = pcCU->getCUAboveRight();
@@ -981,8 +1143,6 @@ Void TComDataCU::copyPartFrom( TComDataCU* pcCU, UInt uiPartUnitIdx, UInt uiDept
   for(UInt i=0; i<NUM_REF_PIC_LIST_01; i++)
   {
     const RefPicList rpl=RefPicList(i);
-    memcpy( m_apiMVPIdx[rpl] + uiOffset, pcCU->getMVPIdx(rpl), iSizeInUchar );
-    memcpy( m_apiMVPNum[rpl] + uiOffset, pcCU->getMVPNum(rpl), iSizeInUchar );
     m_apcCUColocated[rpl] = pcCU->getCUColocated(rpl);
   }
 
@@ -1017,52 +1177,14 @@ Void TComDataCU::copyToPic( UChar uhDepth )
 {
   TComDataCU*& rpcCU = m_pcPic->getCU( m_uiCUAddr );
   const UInt numValidComp=rpcCU->getPic()->getNumberValidComponents();
-  const UInt numValidChan=rpcCU->getPic()->getChromaFormat()==CHROMA_400 ? 1:2;
 
   rpcCU->getTotalCost()       = m_dTotalCost;
   rpcCU->getTotalDistortion() = m_uiTotalDistortion;
   rpcCU->getTotalBits()       = m_uiTotalBits;
 
-  Int iSizeInUchar  = sizeof( UChar ) * m_uiNumPartition;
-  Int iSizeInBool   = sizeof( Bool  ) * m_uiNumPartition;
-  Int sizeInChar  = sizeof( Char ) * m_uiNumPartition;
-
-  memcpy( rpcCU->getSkipFlag() + m_uiAbsIdxInLCU, m_skipFlag, sizeof( *m_skipFlag ) * m_uiNumPartition );
-
-  memcpy( rpcCU->getQP() + m_uiAbsIdxInLCU, m_phQP, sizeInChar  );
+  const UInt numPartFields = numValidComp == 1 ? NUM_PART_FIELDS_LUMA : NUM_PART_FIELDS;
 
-  memcpy( rpcCU->getPartitionSize()  + m_uiAbsIdxInLCU, m_pePartSize, sizeof( *m_pePartSize ) * m_uiNumPartition );
-  memcpy( rpcCU->getPredictionMode() + m_uiAbsIdxInLCU, m_pePredMode, sizeof( *m_pePredMode ) * m_uiNumPartition );
-  memcpy( rpcCU->getChromaQpAdj() + m_uiAbsIdxInLCU, m_ChromaQpAdj, sizeof( *m_ChromaQpAdj ) * m_uiNumPartition );
-  memcpy( rpcCU->getCUTransquantBypass()+ m_uiAbsIdxInLCU, m_CUTransquantBypass, sizeof( *m_CUTransquantBypass ) * m_uiNumPartition );
-  memcpy( rpcCU->getMergeFlag()         + m_uiAbsIdxInLCU, m_pbMergeFlag,         iSizeInBool  );
-  memcpy( rpcCU->getMergeIndex()        + m_uiAbsIdxInLCU, m_puhMergeIndex,       iSizeInUchar );
-  for (UInt ch=0; ch<numValidChan; ch++)
-  {
-    memcpy( rpcCU->getIntraDir(ChannelType(ch)) + m_uiAbsIdxInLCU, m_puhIntraDir[ch], iSizeInUchar);
-  }
-
-  memcpy( rpcCU->getInterDir()          + m_uiAbsIdxInLCU, m_puhInterDir,         iSizeInUchar );
-  memcpy( rpcCU->getTransformIdx()      + m_uiAbsIdxInLCU, m_puhTrIdx,            iSizeInUchar );
-
-  for(UInt comp=0; comp<numValidComp; comp++)
-  {
-    memcpy( rpcCU->getCrossComponentPredictionAlpha(ComponentID(comp)) + m_uiAbsIdxInLCU, m_crossComponentPredictionAlpha[comp], iSizeInUchar );
-    memcpy( rpcCU->getTransformSkip(ComponentID(comp))                 + m_uiAbsIdxInLCU, m_puhTransformSkip[comp],              iSizeInUchar );
-    memcpy( rpcCU->getCbf(ComponentID(comp))                           + m_uiAbsIdxInLCU, m_puhCbf[comp],                        iSizeInUchar );
-    memcpy( rpcCU->getExplicitRdpcmMode(ComponentID(comp))             + m_uiAbsIdxInLCU, m_explicitRdpcmMode[comp],             iSizeInUchar );
-  }
-
-  memcpy( rpcCU->getDepth()  + m_uiAbsIdxInLCU, m_puhDepth,  iSizeInUchar );
-  memcpy( rpcCU->getWidth()  + m_uiAbsIdxInLCU, m_puhWidth,  iSizeInUchar );
-  memcpy( rpcCU->getHeight() + m_uiAbsIdxInLCU, m_puhHeight, iSizeInUchar );
-
-  for(UInt i=0; i<NUM_REF_PIC_LIST_01; i++)
-  {
-    const RefPicList rpl=RefPicList(i);
-    memcpy( rpcCU->getMVPIdx(rpl) + m_uiAbsIdxInLCU, m_apiMVPIdx[rpl], iSizeInUchar );
-    memcpy( rpcCU->getMVPNum(rpl) + m_uiAbsIdxInLCU, m_apiMVPNum[rpl], iSizeInUchar );
-  }
+  copyPartFields( rpcCU->m_puhPartFields + m_uiAbsIdxInLCU, rpcCU->m_uiPartFieldStride, m_puhPartFields, m_uiPartFieldStride, m_uiNumPartition, numPartFields );
 
   for(UInt i=0; i<NUM_REF_PIC_LIST_01; i++)
   {
@@ -1070,8 +1192,6 @@ Void TComDataCU::copyToPic( UChar uhDepth )
     m_acCUMvField[rpl].copyTo( rpcCU->getCUMvField( rpl ), m_uiAbsIdxInLCU );
   }
 
-  memcpy( rpcCU->getIPCMFlag() + m_uiAbsIdxInLCU, m_pbIPCMFlag,         iSizeInBool  );
-
   const UInt numCoeffY    = (g_uiMaxCUWidth*g_uiMaxCUHeight)>>(uhDepth<<1);
   const UInt offsetY      = m_uiAbsIdxInLCU*m_pcPic->getMinCUWidth()*m_pcPic->getMinCUHeight();
   for (UInt comp=0; comp<numValidComp; comp++)
@@ -1099,51 +1219,14 @@ Void TComDataCU::copyToPic( UChar uhDepth, UInt uiPartIdx, UInt uiPartDepth )
   UInt uiPartOffset         = m_uiAbsIdxInLCU + uiPartStart;
 
   const UInt numValidComp=rpcCU->getPic()->getNumberValidComponents();
-  const UInt numValidChan=rpcCU->getPic()->getChromaFormat()==CHROMA_400 ? 1:2;
 
   rpcCU->getTotalCost()       = m_dTotalCost;
   rpcCU->getTotalDistortion() = m_uiTotalDistortion;
   rpcCU->getTotalBits()       = m_uiTotalBits;
 
-  Int iSizeInUchar  = sizeof( UChar  ) * uiQNumPart;
-  Int iSizeInBool   = sizeof( Bool   ) * uiQNumPart;
-  Int sizeInChar  = sizeof( Char ) * uiQNumPart;
+  const UInt numPartFields = numValidComp == 1 ? NUM_PART_FIELDS_LUMA : NUM_PART_FIELDS;
 
-  memcpy( rpcCU->getSkipFlag()       + uiPartOffset, m_skipFlag,   sizeof( *m_skipFlag )   * uiQNumPart );
-
-  memcpy( rpcCU->getQP() + uiPartOffset, m_phQP, sizeInChar );
-  memcpy( rpcCU->getPartitionSize()  + uiPartOffset, m_pePartSize, sizeof( *m_pePartSize ) * uiQNumPart );
-  memcpy( rpcCU->getPredictionMode() + uiPartOffset, m_pePredMode, sizeof( *m_pePredMode ) * uiQNumPart );
-
-  memcpy( rpcCU->getCUTransquantBypass()+ uiPartOffset, m_CUTransquantBypass, sizeof( *m_CUTransquantBypass ) * uiQNumPart );
-  memcpy( rpcCU->getMergeFlag()         + uiPartOffset, m_pbMergeFlag,         iSizeInBool  );
-  memcpy( rpcCU->getMergeIndex()        + uiPartOffset, m_puhMergeIndex,       iSizeInUchar );
-  for (UInt ch=0; ch<numValidChan; ch++)
-  {
-    memcpy( rpcCU->getIntraDir(ChannelType(ch)) + uiPartOffset, m_puhIntraDir[ch], iSizeInUchar );
-  }
-
-  memcpy( rpcCU->getInterDir()          + uiPartOffset, m_puhInterDir,         iSizeInUchar );
-  memcpy( rpcCU->getTransformIdx()      + uiPartOffset, m_puhTrIdx,            iSizeInUchar );
-
-  for(UInt comp=0; comp<numValidComp; comp++)
-  {
-    memcpy( rpcCU->getCrossComponentPredictionAlpha(ComponentID(comp)) + uiPartOffset, m_crossComponentPredictionAlpha[comp], iSizeInUchar );
-    memcpy( rpcCU->getTransformSkip(ComponentID(comp) )                + uiPartOffset, m_puhTransformSkip[comp],   iSizeInUchar );
-    memcpy( rpcCU->getCbf(ComponentID(comp))                           + uiPartOffset, m_puhCbf[comp],             iSizeInUchar );
-    memcpy( rpcCU->getExplicitRdpcmMode(ComponentID(comp) )            + uiPartOffset, m_explicitRdpcmMode[comp],  iSizeInUchar );
-  }
-
-  memcpy( rpcCU->getDepth()  + uiPartOffset, m_puhDepth,  iSizeInUchar );
-  memcpy( rpcCU->getWidth()  + uiPartOffset, m_puhWidth,  iSizeInUchar );
-  memcpy( rpcCU->getHeight() + uiPartOffset, m_puhHeight, iSizeInUchar );
-
-  for(UInt i=0; i<NUM_REF_PIC_LIST_01; i++)
-  {
-    const RefPicList rpl=RefPicList(i);
-    memcpy( rpcCU->getMVPIdx(rpl) + uiPartOffset, m_apiMVPIdx[rpl], iSizeInUchar );
-    memcpy( rpcCU->getMVPNum(rpl) + uiPartOffset, m_apiMVPNum[rpl], iSizeInUchar );
-  }
+  copyPartFields( rpcCU->m_puhPartFields + uiPartOffset, rpcCU->m_uiPartFieldStride, m_puhPartFields, m_uiPartFieldStride, uiQNumPart, numPartFields );
 
   for(UInt i=0; i<NUM_REF_PIC_LIST_01; i++)
   {
@@ -1151,8 +1234,6 @@ Void TComDataCU::copyToPic( UChar uhDepth, UInt uiPartIdx, UInt uiPartDepth )
     m_acCUMvField[rpl].copyTo( rpcCU->getCUMvField( rpl ), m_uiAbsIdxInLCU, uiPartStart, uiQNumPart );
   }
 
-  memcpy( rpcCU->getIPCMFlag() + uiPartOffset, m_pbIPCMFlag,         iSizeInBool  );
-
   const UInt numCoeffY    = (g_uiMaxCUWidth*g_uiMaxCUHeight)>>((uhDepth+uiPartDepth)<<1);
   const UInt offsetY      = uiPartOffset*m_pcPic->getMinCUWidth()*m_pcPic->getMinCUHeight();
   for (UInt comp=0; comp<numValidComp; comp++)
@@ -2229,217 +2310,53 @@ Void TComDataCU::getMvField ( TComDataCU* pcCU, UInt uiAbsPartIdx, RefPicList eR
   rcMvField.setMvField( pcCUMvField->getMv( uiAbsPartIdx ), pcCUMvField->getRefIdx( uiAbsPartIdx ) );
 }
 
-Void TComDataCU::deriveLeftRightTopIdxGeneral ( UInt uiAbsPartIdx, UInt uiPartIdx, UInt& ruiPartIdxLT, UInt& ruiPartIdxRT )
+/** Returns the corner and centre units of a PU of the current partitioning
+ * \param uiPartIdx PU index
+ * \returns z-scan offsets relative to the first unit of the CU
+ */
+const PUNeighbourIdx& TComDataCU::xGetPUNeighbourIdx( UInt uiPartIdx )
 {
-  ruiPartIdxLT = m_uiAbsIdxInLCU + uiAbsPartIdx;
-  UInt uiPUWidth = 0;
+  const UInt uiLog2WidthInUnits = g_aucConvertToBit[ m_puhWidth[0] ] - g_aucConvertToBit[ m_pcPic->getMinCUWidth() ];
+  return g_auPUNeighbourIdx[uiLog2WidthInUnits][ getPartitionSize( 0 ) ][uiPartIdx];
+}
 
-  switch ( m_pePartSize[uiAbsPartIdx] )
-  {
-    case SIZE_2Nx2N: uiPUWidth = m_puhWidth[uiAbsPartIdx];  break;
-    case SIZE_2NxN:  uiPUWidth = m_puhWidth[uiAbsPartIdx];   break;
-    case SIZE_Nx2N:  uiPUWidth = m_puhWidth[uiAbsPartIdx]  >> 1;  break;
-    case SIZE_NxN:   uiPUWidth = m_puhWidth[uiAbsPartIdx]  >> 1; break;
-    case SIZE_2NxnU:   uiPUWidth = m_puhWidth[uiAbsPartIdx]; break;
-    case SIZE_2NxnD:   uiPUWidth = m_puhWidth[uiAbsPartIdx]; break;
-    case SIZE_nLx2N:
-      if ( uiPartIdx == 0 )
-      {
-        uiPUWidth = m_puhWidth[uiAbsPartIdx]  >> 2;
-      }
-      else if ( uiPartIdx == 1 )
-      {
-        uiPUWidth = (m_puhWidth[uiAbsPartIdx]  >> 1) + (m_puhWidth[uiAbsPartIdx]  >> 2);
-      }
-      else
-      {
-        assert(0);
-      }
-      break;
-    case SIZE_nRx2N:
-      if ( uiPartIdx == 0 )
-      {
-        uiPUWidth = (m_puhWidth[uiAbsPartIdx]  >> 1) + (m_puhWidth[uiAbsPartIdx]  >> 2);
-      }
-      else if ( uiPartIdx == 1 )
-      {
-        uiPUWidth = m_puhWidth[uiAbsPartIdx]  >> 2;
-      }
-      else
-      {
-        assert(0);
-      }
-      break;
-    default:
-      assert (0);
-      break;
-  }
+Void TComDataCU::deriveLeftRightTopIdxGeneral ( UInt uiAbsPartIdx, UInt uiPartIdx, UInt& ruiPartIdxLT, UInt& ruiPartIdxRT )
+{
+  const PUNeighbourIdx& rcIdx = xGetPUNeighbourIdx( uiPartIdx );
+  assert( uiAbsPartIdx == rcIdx.uiLT );
 
-  ruiPartIdxRT = g_auiRasterToZscan [g_auiZscanToRaster[ ruiPartIdxLT ] + uiPUWidth / m_pcPic->getMinCUWidth() - 1 ];
+  ruiPartIdxLT = m_uiAbsIdxInLCU + uiAbsPartIdx;
+  ruiPartIdxRT = m_uiAbsIdxInLCU + rcIdx.uiRT;
 }
 
 Void TComDataCU::deriveLeftBottomIdxGeneral( UInt uiAbsPartIdx, UInt uiPartIdx, UInt& ruiPartIdxLB )
 {
-  UInt uiPUHeight = 0;
-  switch ( m_pePartSize[uiAbsPartIdx] )
-  {
-    case SIZE_2Nx2N: uiPUHeight = m_puhHeight[uiAbsPartIdx];    break;
-    case SIZE_2NxN:  uiPUHeight = m_puhHeight[uiAbsPartIdx] >> 1;    break;
-    case SIZE_Nx2N:  uiPUHeight = m_puhHeight[uiAbsPartIdx];  break;
-    case SIZE_NxN:   uiPUHeight = m_puhHeight[uiAbsPartIdx] >> 1;    break;
-    case SIZE_2NxnU:
-      if ( uiPartIdx == 0 )
-      {
-        uiPUHeight = m_puhHeight[uiAbsPartIdx] >> 2;
-      }
-      else if ( uiPartIdx == 1 )
-      {
-        uiPUHeight = (m_puhHeight[uiAbsPartIdx] >> 1) + (m_puhHeight[uiAbsPartIdx] >> 2);
-      }
-      else
-      {
-        assert(0);
-      }
-      break;
-    case SIZE_2NxnD:
-      if ( uiPartIdx == 0 )
-      {
-        uiPUHeight = (m_puhHeight[uiAbsPartIdx] >> 1) + (m_puhHeight[uiAbsPartIdx] >> 2);
-      }
-      else if ( uiPartIdx == 1 )
-      {
-        uiPUHeight = m_puhHeight[uiAbsPartIdx] >> 2;
-      }
-      else
-      {
-        assert(0);
-      }
-      break;
-    case SIZE_nLx2N: uiPUHeight = m_puhHeight[uiAbsPartIdx];  break;
-    case SIZE_nRx2N: uiPUHeight = m_puhHeight[uiAbsPartIdx];  break;
-    default:
-      assert (0);
-      break;
-  }
+  const PUNeighbourIdx& rcIdx = xGetPUNeighbourIdx( uiPartIdx );
+  assert( uiAbsPartIdx == rcIdx.uiLT );
 
-  ruiPartIdxLB      = g_auiRasterToZscan [g_auiZscanToRaster[ m_uiAbsIdxInLCU + uiAbsPartIdx ] + ((uiPUHeight / m_pcPic->getMinCUHeight()) - 1)*m_pcPic->getNumPartInWidth()];
+  ruiPartIdxLB = m_uiAbsIdxInLCU + rcIdx.uiLB;
 }
 
 Void TComDataCU::deriveLeftRightTopIdx ( UInt uiPartIdx, UInt& ruiPartIdxLT, UInt& ruiPartIdxRT )
 {
-  ruiPartIdxLT = m_uiAbsIdxInLCU;
-  ruiPartIdxRT = g_auiRasterToZscan [g_auiZscanToRaster[ ruiPartIdxLT ] + m_puhWidth[0] / m_pcPic->getMinCUWidth() - 1 ];
-
-  switch ( m_pePartSize[0] )
-  {
-    case SIZE_2Nx2N:                                                                                                                                break;
-    case SIZE_2NxN:
-      ruiPartIdxLT += ( uiPartIdx == 0 )? 0 : m_uiNumPartition >> 1; ruiPartIdxRT += ( uiPartIdx == 0 )? 0 : m_uiNumPartition >> 1;
-      break;
-    case SIZE_Nx2N:
-      ruiPartIdxLT += ( uiPartIdx == 0 )? 0 : m_uiNumPartition >> 2; ruiPartIdxRT -= ( uiPartIdx == 1 )? 0 : m_uiNumPartition >> 2;
-      break;
-    case SIZE_NxN:
-      ruiPartIdxLT += ( m_uiNumPartition >> 2 ) * uiPartIdx;         ruiPartIdxRT +=  ( m_uiNumPartition >> 2 ) * ( uiPartIdx - 1 );
-      break;
-    case SIZE_2NxnU:
-      ruiPartIdxLT += ( uiPartIdx == 0 )? 0 : m_uiNumPartition >> 3;
-      ruiPartIdxRT += ( uiPartIdx == 0 )? 0 : m_uiNumPartition >> 3;
-      break;
-    case SIZE_2NxnD:
-      ruiPartIdxLT += ( uiPartIdx == 0 )? 0 : ( m_uiNumPartition >> 1 ) + ( m_uiNumPartition >> 3 );
-      ruiPartIdxRT += ( uiPartIdx == 0 )? 0 : ( m_uiNumPartition >> 1 ) + ( m_uiNumPartition >> 3 );
-      break;
-    case SIZE_nLx2N:
-      ruiPartIdxLT += ( uiPartIdx == 0 )? 0 : m_uiNumPartition >> 4;
-      ruiPartIdxRT -= ( uiPartIdx == 1 )? 0 : ( m_uiNumPartition >> 2 ) + ( m_uiNumPartition >> 4 );
-      break;
-    case SIZE_nRx2N:
-      ruiPartIdxLT += ( uiPartIdx == 0 )? 0 : ( m_uiNumPartition >> 2 ) + ( m_uiNumPartition >> 4 );
-      ruiPartIdxRT -= ( uiPartIdx == 1 )? 0 : m_uiNumPartition >> 4;
-      break;
-    default:
-      assert (0);
-      break;
-  }
+  const PUNeighbourIdx& rcIdx = xGetPUNeighbourIdx( uiPartIdx );
 
+  ruiPartIdxLT = m_uiAbsIdxInLCU + rcIdx.uiLT;
+  ruiPartIdxRT = m_uiAbsIdxInLCU + rcIdx.uiRT;
 }
 
 Void TComDataCU::deriveLeftBottomIdx( UInt  uiPartIdx,      UInt&      ruiPartIdxLB )
 {
-  ruiPartIdxLB      = g_auiRasterToZscan [g_auiZscanToRaster[ m_uiAbsIdxInLCU ] + ( ((m_puhHeight[0] / m_pcPic->getMinCUHeight())>>1) - 1)*m_pcPic->getNumPartInWidth()];
-
-  switch ( m_pePartSize[0] )
-  {
-    case SIZE_2Nx2N:
-      ruiPartIdxLB += m_uiNumPartition >> 1;
-      break;
-    case SIZE_2NxN:
-      ruiPartIdxLB += ( uiPartIdx == 0 )? 0 : m_uiNumPartition >> 1;
-      break;
-    case SIZE_Nx2N:
-      ruiPartIdxLB += ( uiPartIdx == 0 )? m_uiNumPartition >> 1 : (m_uiNumPartition >> 2)*3;
-      break;
-    case SIZE_NxN:
-      ruiPartIdxLB += ( m_uiNumPartition >> 2 ) * uiPartIdx;
-      break;
-    case SIZE_2NxnU:
-      ruiPartIdxLB += ( uiPartIdx == 0 ) ? -((Int)m_uiNumPartition >> 3) : m_uiNumPartition >> 1;
-      break;
-    case SIZE_2NxnD:
-      ruiPartIdxLB += ( uiPartIdx == 0 ) ? (m_uiNumPartition >> 2) + (m_uiNumPartition >> 3): m_uiNumPartition >> 1;
-      break;
-    case SIZE_nLx2N:
-      ruiPartIdxLB += ( uiPartIdx == 0 ) ? m_uiNumPartition >> 1 : (m_uiNumPartition >> 1) + (m_uiNumPartition >> 4);
-      break;
-    case SIZE_nRx2N:
-      ruiPartIdxLB += ( uiPartIdx == 0 ) ? m_uiNumPartition >> 1 : (m_uiNumPartition >> 1) + (m_uiNumPartition >> 2) + (m_uiNumPartition >> 4);
-      break;
-    default:
-      assert (0);
-      break;
-  }
+  ruiPartIdxLB = m_uiAbsIdxInLCU + xGetPUNeighbourIdx( uiPartIdx ).uiLB;
 }
 
 /** Derives the partition index of neighbouring bottom right block
- * \param [in]  eCUMode
  * \param [in]  uiPartIdx
  * \param [out] ruiPartIdxRB
  */
 Void TComDataCU::deriveRightBottomIdx( UInt  uiPartIdx,      UInt&      ruiPartIdxRB )
 {
-  ruiPartIdxRB      = g_auiRasterToZscan [g_auiZscanToRaster[ m_uiAbsIdxInLCU ] + ( ((m_puhHeight[0] / m_pcPic->getMinCUHeight())>>1) - 1)*m_pcPic->getNumPartInWidth() +  m_puhWidth[0] / m_pcPic->getMinCUWidth() - 1];
-
-  switch ( m_pePartSize[0] )
-  {
-    case SIZE_2Nx2N:
-      ruiPartIdxRB += m_uiNumPartition >> 1;
-      break;
-    case SIZE_2NxN:
-      ruiPartIdxRB += ( uiPartIdx == 0 )? 0 : m_uiNumPartition >> 1;
-      break;
-    case SIZE_Nx2N:
-      ruiPartIdxRB += ( uiPartIdx == 0 )? m_uiNumPartition >> 2 : (m_uiNumPartition >> 1);
-      break;
-    case SIZE_NxN:
-      ruiPartIdxRB += ( m_uiNumPartition >> 2 ) * ( uiPartIdx - 1 );
-      break;
-    case SIZE_2NxnU:
-      ruiPartIdxRB += ( uiPartIdx == 0 ) ? -((Int)m_uiNumPartition >> 3) : m_uiNumPartition >> 1;
-      break;
-    case SIZE_2NxnD:
-      ruiPartIdxRB += ( uiPartIdx == 0 ) ? (m_uiNumPartition >> 2) + (m_uiNumPartition >> 3): m_uiNumPartition >> 1;
-      break;
-    case SIZE_nLx2N:
-      ruiPartIdxRB += ( uiPartIdx == 0 ) ? (m_uiNumPartition >> 3) + (m_uiNumPartition >> 4): m_uiNumPartition >> 1;
-      break;
-    case SIZE_nRx2N:
-      ruiPartIdxRB += ( uiPartIdx == 0 ) ? (m_uiNumPartition >> 2) + (m_uiNumPartition >> 3) + (m_uiNumPartition >> 4) : m_uiNumPartition >> 1;
-      break;
-    default:
-      assert (0);
-      break;
-  }
+  ruiPartIdxRB = m_uiAbsIdxInLCU + xGetPUNeighbourIdx( uiPartIdx ).uiRB;
 }
 
 Void TComDataCU::deriveLeftRightTopIdxAdi ( UInt& ruiPartIdxLT, UInt& ruiPartIdxRT, UInt uiPartOffset, UInt uiPartDepth )
@@ -2486,12 +2403,42 @@ Bool TComDataCU::hasEqualMotion( UInt uiAbsPartIdx, TComDataCU* pcCandCU, UInt u
 /** Constructs a list of merging candidates
  * \param uiAbsPartIdx
  * \param uiPUIdx
- * \param uiDepth
  * \param pcMvFieldNeighbours
  * \param puhInterDirNeighbours
  * \param numValidMergeCand
+ * \param mrgCandIdx  index of the only candidate needed, -1 for the whole list
+ *
+ * With the candidate cache enabled, the full list of each PU that does not depend on other PUs of the CU is derived
+ * once per CU position and served from the cache afterwards.
  */
 Void TComDataCU::getInterMergeCandidates( UInt uiAbsPartIdx, UInt uiPUIdx, TComMvField* pcMvFieldNeighbours, UChar* puhInterDirNeighbours, Int& numValidMergeCand, Int mrgCandIdx )
+{
+  const PartSize ePartSize = getPartitionSize( uiAbsPartIdx );
+
+  // the A1/B1 exclusions keep the second PU of a two-PU CU independent of the first, but NxN PUs see their predecessors
+  if ( m_pcCandCache == NULL || ( ePartSize == SIZE_NxN && uiPUIdx > 0 ) )
+  {
+    xDeriveMergeCandidates( uiAbsPartIdx, uiPUIdx, pcMvFieldNeighbours, puhInterDirNeighbours, numValidMergeCand, mrgCandIdx );
+    return;
+  }
+
+  CandidateCache::MergeList& rcList = m_pcCandCache->acMergeList[ePartSize][uiPUIdx];
+  if ( !rcList.bValid )
+  {
+    xDeriveMergeCandidates( uiAbsPartIdx, uiPUIdx, rcList.acMvField, rcList.auhInterDir, rcList.iNumValidMergeCand );
+    rcList.bValid = true;
+  }
+
+  const UInt uiNumCand = getSlice()->getMaxNumMergeCand();
+  ::memcpy( puhInterDirNeighbours, rcList.auhInterDir, uiNumCand * sizeof( UChar ) );
+  for ( UInt ui = 0; ui < ( uiNumCand << 1 ); ui++ )
+  {
+    pcMvFieldNeighbours[ui] = rcList.acMvField[ui];
+  }
+  numValidMergeCand = rcList.iNumValidMergeCand;
+}
+
+Void TComDataCU::xDeriveMergeCandidates( UInt uiAbsPartIdx, UInt uiPUIdx, TComMvField* pcMvFieldNeighbours, UChar* puhInterDirNeighbours, Int& numValidMergeCand, Int mrgCandIdx )
 {
   UInt uiAbsPartAddr = m_uiAbsIdxInLCU + uiAbsPartIdx;
   Bool abCandIsInter[ MRG_MAX_NUM_CANDS ];
@@ -2935,6 +2882,24 @@ Void TComDataCU::getPartPosition( UInt partIdx, Int& xP, Int& yP, Int& nPSW, Int
  * \param pInfo
  */
 Void TComDataCU::fillMvpCand ( UInt uiPartIdx, UInt uiPartAddr, RefPicList eRefPicList, Int iRefIdx, AMVPInfo* pInfo )
+{
+  // only the first PU is cached: the spatial candidates of the second one may lie in the first
+  if ( m_pcCandCache == NULL || uiPartIdx != 0 || iRefIdx < 0 )
+  {
+    xDeriveMvpCand( uiPartIdx, uiPartAddr, eRefPicList, iRefIdx, pInfo );
+    return;
+  }
+
+  const PartSize ePartSize = getPartitionSize( 0 );
+  if ( !m_pcCandCache->abAMVPValid[ePartSize][eRefPicList][iRefIdx] )
+  {
+    xDeriveMvpCand( uiPartIdx, uiPartAddr, eRefPicList, iRefIdx, &m_pcCandCache->acAMVPInfo[ePartSize][eRefPicList][iRefIdx] );
+    m_pcCandCache->abAMVPValid[ePartSize][eRefPicList][iRefIdx] = true;
+  }
+  *pInfo = m_pcCandCache->acAMVPInfo[ePartSize][eRefPicList][iRefIdx];
+}
+
+Void TComDataCU::xDeriveMvpCand ( UInt uiPartIdx, UInt uiPartAddr, RefPicList eRefPicList, Int iRefIdx, AMVPInfo* pInfo )
 {
   TComMv cMvPred;
   Bool bAddedSmvp = false;
@@ -3499,15 +3464,7 @@ Int TComDataCU::xGetDistScaleFactor(Int iCurrPOC, Int iCurrRefPOC, Int iColPOC,
  */
 Void TComDataCU::xDeriveCenterIdx( UInt uiPartIdx, UInt& ruiPartIdxCenter )
 {
-  UInt uiPartAddr;
-  Int  iPartWidth;
-  Int  iPartHeight;
-  getPartIndexAndSize( uiPartIdx, uiPartAddr, iPartWidth, iPartHeight);
-
-  ruiPartIdxCenter = m_uiAbsIdxInLCU+uiPartAddr; // partition origin.
-  ruiPartIdxCenter = g_auiRasterToZscan[ g_auiZscanToRaster[ ruiPartIdxCenter ]
-                                        + ( iPartHeight/m_pcPic->getMinCUHeight()  )/2*m_pcPic->getNumPartInWidth()
-                                        + ( iPartWidth/m_pcPic->getMinCUWidth()  )/2];
+  ruiPartIdxCenter = m_uiAbsIdxInLCU + xGetPUNeighbourIdx( uiPartIdx ).uiCenter;
 }
 
 Void TComDataCU::compressMV()
@@ -108,11 +108,17 @@ private:
 #if ADAPTIVE_QP_SELECTION
   TCoeff*        m_pcArlCoeff[MAX_NUM_COMPONENT];  // ARL coefficient buffer (0->Y, 1->Cb, 2->Cr)
   static TCoeff* m_pcGlbArlCoeff[MAX_NUM_COMPONENT]; // global ARL buffer
+  static UInt    m_glbArlCoeffUsers;                 // number of CUs sharing the global ARL buffer
   Bool           m_ArlCoeffIsAliasedAllocation;  // ARL coefficient buffer is an alias of the global buffer and must not be free()'d
 #endif
 
   Pel*           m_pcIPCMSample[MAX_NUM_COMPONENT];    // PCM sample buffer (0->Y, 1->Cb, 2->Cr)
 
+  UChar*         m_puhBuffer;          // single buffer holding all the per-partition arrays and coefficient buffers
+  Bool           m_bExternalBuffer;    // m_puhBuffer is part of the picture's allocation and must not be free()'d
+  UChar*         m_puhPartFields;      // the one-byte per-partition arrays, stored back to back
+  UInt           m_uiPartFieldStride;  // distance between the one-byte per-partition arrays
+
   // -------------------------------------------------------------------------------------------------------------------
   // neighbour access variables
   // -------------------------------------------------------------------------------------------------------------------
@@ -156,6 +162,28 @@ private:
   Char          m_codedQP;
   UChar*        m_explicitRdpcmMode[MAX_NUM_COMPONENT]; // Stores the explicit RDPCM mode for all TUs belonging to this CU
 
+  // -------------------------------------------------------------------------------------------------------------------
+  // candidate list cache
+  // -------------------------------------------------------------------------------------------------------------------
+
+  /// merge and AMVP candidate lists already derived at the current CU position
+  struct CandidateCache
+  {
+    struct MergeList
+    {
+      Bool        bValid;
+      Int         iNumValidMergeCand;
+      UChar       auhInterDir[MRG_MAX_NUM_CANDS];
+      TComMvField acMvField[MRG_MAX_NUM_CANDS << 1];
+    };
+
+    MergeList     acMergeList[NUMBER_OF_PART_SIZES][4];                        // [part size][PU index]
+    Bool          abAMVPValid[NUMBER_OF_PART_SIZES][NUM_REF_PIC_LIST_01][MAX_NUM_REF];
+    AMVPInfo      acAMVPInfo [NUMBER_OF_PART_SIZES][NUM_REF_PIC_LIST_01][MAX_NUM_REF]; // first PU only
+  };
+
+  CandidateCache* m_pcCandCache;      // NULL unless enabled by the encoder
+
 protected:
 
   /// add possible motion vector predictor candidates
@@ -173,6 +201,27 @@ protected:
   Int           xGetDistScaleFactor   ( Int iCurrPOC, Int iCurrRefPOC, Int iColPOC, Int iColRefPOC );
 
   Void xDeriveCenterIdx( UInt uiPartIdx, UInt& ruiPartIdxCenter );
+  const PUNeighbourIdx& xGetPUNeighbourIdx( UInt uiPartIdx );
+
+  /// derive the candidate lists without going through the cache
+  Void          xDeriveMergeCandidates( UInt uiAbsPartIdx, UInt uiPUIdx, TComMvField* pcMFieldNeighbours, UChar* puhInterDirNeighbours, Int& numValidMergeCand, Int mrgCandIdx = -1 );
+  Void          xDeriveMvpCand        ( UInt uiPartIdx, UInt uiPartAddr, RefPicList eRefPicList, Int iRefIdx, AMVPInfo* pInfo );
+  Void          xInvalidateCandidateCache();
+
+  /// offsets of the arrays within the CU buffer
+  struct BufferLayout
+  {
+    UInt partFields;
+    UInt mvField[NUM_REF_PIC_LIST_01];
+    UInt sliceStartCU;
+    UInt sliceSegmentStartCU;
+    UInt coeff[MAX_NUM_COMPONENT];
+    UInt arlCoeff[MAX_NUM_COMPONENT];
+    UInt pcmSample[MAX_NUM_COMPONENT];
+    UInt totalSize;
+  };
+
+  static Void xGetBufferLayout( BufferLayout& layout, ChromaFormat chromaFormatIDC, UInt uiNumPartition, UInt uiWidth, UInt uiHeight, Bool bDecSubCu, Bool bGlobalRMARLBuffer );
 
 public:
   TComDataCU();
@@ -186,9 +235,19 @@ public:
 #if ADAPTIVE_QP_SELECTION
     , Bool bGlobalRMARLBuffer = false
 #endif
+    , UChar *pBuffer = NULL
     );
   Void          destroy               ();
 
+  /// keep the merge and AMVP lists derived at a CU position until the CU is re-initialised
+  Void          enableCandidateCache  ();
+
+  static UInt   getBufferSize         ( ChromaFormat chromaFormatIDC, UInt uiNumPartition, UInt uiWidth, UInt uiHeight, Bool bDecSubCu
+#if ADAPTIVE_QP_SELECTION
+    , Bool bGlobalRMARLBuffer = false
+#endif
+    );
+
   Void          initCU                ( TComPic* pcPic, UInt uiCUAddr );
   Void          initEstData           ( const UInt uiDepth, const Int qp, const Bool bTransquantBypass );
   Void          initSubCU             ( TComDataCU* pcCU, UInt uiPartUnitIdx, UInt uiDepth, Int qp );
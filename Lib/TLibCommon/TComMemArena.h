@@ -0,0 +1,119 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2014, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComMemArena.h
+    \brief    single-allocation arena for working buffers (header)
+*/
+
+#ifndef __TCOMMEMARENA__
+#define __TCOMMEMARENA__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include <assert.h>
+#include <stddef.h>
+#include "CommonDef.h"
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/** Arena for buffers that live as long as their owner. The owner adds up the sizes it needs with getAlignedSize(),
+ *  allocates them all at once with create() and then carves the buffers out in order with allocate(). Every buffer
+ *  starts on a cache line, so buffers used together can be placed next to each other without false sharing.
+ */
+class TComMemArena
+{
+public:
+  static const size_t ALIGNMENT = 64;
+
+  TComMemArena() : m_pRaw(NULL), m_pBase(NULL), m_size(0), m_used(0) {}
+  ~TComMemArena() { destroy(); }
+
+  static size_t getAlignedSize( const size_t size ) { return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+  Void create( const size_t size )
+  {
+    destroy();
+    m_pRaw  = (UChar*)xMalloc(UChar, size + ALIGNMENT);
+    m_pBase = m_pRaw + ((ALIGNMENT - (size_t(m_pRaw) & (ALIGNMENT - 1))) & (ALIGNMENT - 1));
+    m_size  = size;
+    m_used  = 0;
+  }
+
+  Void destroy()
+  {
+    if (m_pRaw != NULL)
+    {
+      xFree(m_pRaw);
+    }
+    m_pRaw  = NULL;
+    m_pBase = NULL;
+    m_size  = 0;
+    m_used  = 0;
+  }
+
+  /// take the next size bytes (rounded up to a cache line) from the arena
+  UChar* allocate( const size_t size )
+  {
+    const size_t alignedSize = getAlignedSize(size);
+    assert(m_used + alignedSize <= m_size);
+    UChar* p = m_pBase + m_used;
+    m_used  += alignedSize;
+    return p;
+  }
+
+  template<typename T>
+  T*     allocateArray( const size_t num ) { return (T*)allocate(num * sizeof(T)); }
+
+  size_t getSize() const { return m_size; }
+  size_t getUsed() const { return m_used; }
+
+private:
+  TComMemArena( const TComMemArena& );
+  TComMemArena& operator= ( const TComMemArena& );
+
+  UChar* m_pRaw;
+  UChar* m_pBase;
+  size_t m_size;
+  size_t m_used;
+};
+
+//! \}
+
+#endif // __TCOMMEMARENA__
@@ -36,6 +36,7 @@
 */
 
 #include <memory.h>
+#include <new>
 #include "TComMotionInfo.h"
 #include "assert.h"
 #include <stdlib.h>
@@ -51,15 +52,41 @@
 // Create / destroy
 // --------------------------------------------------------------------------------------------------------------------
 
-Void TComCUMvField::create( UInt uiNumPartition )
+/** Size in bytes of the buffer that create() needs for uiNumPartition partitions (a multiple of 16 bytes).
+ */
+UInt TComCUMvField::getBufferSize( UInt uiNumPartition )
+{
+  return ( 2 * uiNumPartition * sizeof( TComMv ) + uiNumPartition * sizeof( Char ) + 15 ) & ~15;
+}
+
+/** \param uiNumPartition number of partitions
+ *  \param pBuffer        if not NULL, getBufferSize() bytes in which to place the arrays instead of allocating them
+ */
+Void TComCUMvField::create( UInt uiNumPartition, UChar *pBuffer )
 {
   assert(m_pcMv     == NULL);
   assert(m_pcMvd    == NULL);
   assert(m_piRefIdx == NULL);
 
-  m_pcMv     = new TComMv[ uiNumPartition ];
-  m_pcMvd    = new TComMv[ uiNumPartition ];
-  m_piRefIdx = new Char  [ uiNumPartition ];
+  if (pBuffer != NULL)
+  {
+    m_pcMv     = reinterpret_cast<TComMv*>( pBuffer );
+    m_pcMvd    = m_pcMv + uiNumPartition;
+    m_piRefIdx = reinterpret_cast<Char*>( m_pcMvd + uiNumPartition );
+    for ( UInt i = 0; i < uiNumPartition; i++ )
+    {
+      new ( m_pcMv  + i ) TComMv();
+      new ( m_pcMvd + i ) TComMv();
+    }
+    m_bExternalBuffer = true;
+  }
+  else
+  {
+    m_pcMv     = new TComMv[ uiNumPartition ];
+    m_pcMvd    = new TComMv[ uiNumPartition ];
+    m_piRefIdx = new Char  [ uiNumPartition ];
+    m_bExternalBuffer = false;
+  }
 
   m_uiNumPartition = uiNumPartition;
 }
@@ -70,9 +97,13 @@ Void TComCUMvField::destroy()
   assert(m_pcMvd    != NULL);
   assert(m_piRefIdx != NULL);
 
-  delete[] m_pcMv;
-  delete[] m_pcMvd;
-  delete[] m_piRefIdx;
+  if (!m_bExternalBuffer)
+  {
+    delete[] m_pcMv;
+    delete[] m_pcMvd;
+    delete[] m_piRefIdx;
+  }
+  m_bExternalBuffer = false;
 
   m_pcMv     = NULL;
   m_pcMvd    = NULL;
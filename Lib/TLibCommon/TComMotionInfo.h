@@ -95,20 +95,23 @@ private:
   TComMv*   m_pcMvd;
   Char*     m_piRefIdx;
   UInt      m_uiNumPartition;
+  Bool      m_bExternalBuffer;   ///< the arrays are part of a buffer owned by the CU and must not be deleted
   AMVPInfo  m_cAMVPInfo;
 
   template <typename T>
   Void setAll( T *p, T const & val, PartSize eCUMode, Int iPartAddr, UInt uiDepth, Int iPartIdx );
 
 public:
-  TComCUMvField() : m_pcMv(NULL), m_pcMvd(NULL), m_piRefIdx(NULL), m_uiNumPartition(0) {}
+  TComCUMvField() : m_pcMv(NULL), m_pcMvd(NULL), m_piRefIdx(NULL), m_uiNumPartition(0), m_bExternalBuffer(false) {}
   ~TComCUMvField() {}
 
   // ------------------------------------------------------------------------------------------------------------------
   // create / destroy
   // ------------------------------------------------------------------------------------------------------------------
 
-  Void    create( UInt uiNumPartition );
+  static UInt getBufferSize( UInt uiNumPartition );
+
+  Void    create( UInt uiNumPartition, UChar *pBuffer = NULL );
   Void    destroy();
 
   // ------------------------------------------------------------------------------------------------------------------
@@ -119,6 +119,38 @@ Void TComPic::destroy()
   deleteSEIs(m_SEIs);
 }
 
+/** Check whether the picture buffers were created with the given dimensions, so that the picture can be
+ *  reused through reinit() instead of being destroyed and created again.
+ */
+Bool TComPic::isCompatible( Int iWidth, Int iHeight, ChromaFormat chromaFormatIDC, UInt uiMaxWidth, UInt uiMaxHeight, UInt uiMaxDepth ) const
+{
+  const TComPicYuv *pcPicYuvRec = m_apcPicYuv[PIC_YUV_REC];
+  return m_apcPicSym != NULL && pcPicYuvRec != NULL
+      && pcPicYuvRec->getWidth(COMPONENT_Y)  == iWidth
+      && pcPicYuvRec->getHeight(COMPONENT_Y) == iHeight
+      && pcPicYuvRec->getChromaFormat()      == chromaFormatIDC
+      && m_apcPicSym->getMaxCUWidth()        == uiMaxWidth
+      && m_apcPicSym->getMaxCUHeight()       == uiMaxHeight
+      && m_apcPicSym->getTotalDepth()        == uiMaxDepth;
+}
+
+/** Prepare an existing picture for a new picture of the same dimensions. The picture metadata is reset
+ *  as create() would, while the CU data and sample buffers are kept.
+ */
+Void TComPic::reinit( Window &conformanceWindow, Window &defaultDisplayWindow, Int *numReorderPics )
+{
+  m_apcPicSym->resetSliceBuffer();
+  m_uiCurrSliceIdx = 0;
+  m_apcPicYuv[PIC_YUV_REC]->setBorderExtension(false);
+
+  deleteSEIs(m_SEIs);
+  m_bUsedByCurr = false;
+
+  m_conformanceWindow    = conformanceWindow;
+  m_defaultDisplayWindow = defaultDisplayWindow;
+  memcpy(m_numReorderPics, numReorderPics, MAX_TLAYER*sizeof(Int));
+}
+
 Void TComPic::compressMotion()
 {
   TComPicSym* pPicSym = getPicSym();
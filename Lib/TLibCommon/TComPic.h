@@ -94,6 +94,9 @@ public:
 
   virtual Void  destroy();
 
+  Bool          isCompatible( Int iWidth, Int iHeight, ChromaFormat chromaFormatIDC, UInt uiMaxWidth, UInt uiMaxHeight, UInt uiMaxDepth ) const;
+  Void          reinit( Window &conformanceWindow, Window &defaultDisplayWindow, Int *numReorderPics );
+
   UInt          getTLayer() const               { return m_uiTLayer;   }
   Void          setTLayer( UInt uiTLayer ) { m_uiTLayer = uiTLayer; }
 
@@ -61,6 +61,7 @@ TComPicSym::TComPicSym()
 ,m_apcTComSlice(NULL)
 ,m_uiNumAllocatedSlice (0)
 ,m_apcTComDataCU (NULL)
+,m_puhCUBuffer (NULL)
 ,m_iNumColumnsMinus1 (0)
 ,m_iNumRowsMinus1(0)
 ,m_puiCUOrderMap(0)
@@ -103,6 +104,15 @@ Void TComPicSym::create  ( ChromaFormat chromaFormatIDC, Int iPicWidth, Int iPic
   m_apcTComSlice      = new TComSlice*[m_uiNumCUsInFrame];
   m_apcTComSlice[0]   = new TComSlice;
   m_uiNumAllocatedSlice = 1;
+
+  // the CUs of a picture share one buffer, rather than making a dozen allocations each
+  const UInt uiCUBufferSize = TComDataCU::getBufferSize( chromaFormatIDC, m_uiNumPartitions, m_uiMaxCUWidth, m_uiMaxCUHeight, false
+#if ADAPTIVE_QP_SELECTION
+      , true
+#endif
+      );
+  m_puhCUBuffer = (UChar*)xMalloc(UChar, size_t(uiCUBufferSize) * m_uiNumCUsInFrame);
+
   for ( i=0; i<m_uiNumCUsInFrame ; i++ )
   {
     m_apcTComDataCU[i] = new TComDataCU;
@@ -110,6 +120,7 @@ Void TComPicSym::create  ( ChromaFormat chromaFormatIDC, Int iPicWidth, Int iPic
 #if ADAPTIVE_QP_SELECTION
       , true
 #endif
+      , m_puhCUBuffer + size_t(uiCUBufferSize) * i
       );
   }
 
@@ -147,6 +158,12 @@ Void TComPicSym::destroy()
   delete [] m_apcTComDataCU;
   m_apcTComDataCU = NULL;
 
+  if (m_puhCUBuffer)
+  {
+    xFree(m_puhCUBuffer);
+    m_puhCUBuffer = NULL;
+  }
+
   delete [] m_puiCUOrderMap;
   m_puiCUOrderMap = NULL;
 
@@ -183,6 +200,18 @@ Void TComPicSym::clearSliceBuffer()
   m_uiNumAllocatedSlice = 1;
 }
 
+/** Return the slice buffer to the state left by create(): a single, default-constructed slice.
+ */
+Void TComPicSym::resetSliceBuffer()
+{
+  for (UInt i = 0; i < m_uiNumAllocatedSlice; i++)
+  {
+    delete m_apcTComSlice[i];
+  }
+  m_apcTComSlice[0]     = new TComSlice;
+  m_uiNumAllocatedSlice = 1;
+}
+
 UInt TComPicSym::getPicSCUEncOrder( UInt SCUAddr )
 {
   return getInverseCUOrderMap(SCUAddr/m_uiNumPartitions)*m_uiNumPartitions + SCUAddr%m_uiNumPartitions;
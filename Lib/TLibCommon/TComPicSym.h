@@ -99,6 +99,7 @@ private:
   TComSlice**   m_apcTComSlice;
   UInt          m_uiNumAllocatedSlice;
   TComDataCU**  m_apcTComDataCU;        ///< array of CU data
+  UChar*        m_puhCUBuffer;          ///< single allocation holding the arrays of all CUs in m_apcTComDataCU
 
   Int           m_iNumColumnsMinus1;
   Int           m_iNumRowsMinus1;
@@ -119,6 +120,9 @@ public:
   UInt        getFrameHeightInCU()      { return m_uiHeightInCU;                }
   UInt        getMinCUWidth()           { return m_uiMinCUWidth;                }
   UInt        getMinCUHeight()          { return m_uiMinCUHeight;               }
+  UInt        getMaxCUWidth()           { return m_uiMaxCUWidth;                }
+  UInt        getMaxCUHeight()          { return m_uiMaxCUHeight;               }
+  UInt        getTotalDepth()           { return m_uhTotalDepth;                }
   UInt        getNumberOfCUsInFrame()   { return m_uiNumCUsInFrame;  }
   TComDataCU*&  getCU( UInt uiCUAddr )  { return m_apcTComDataCU[uiCUAddr];     }
 
@@ -126,6 +130,7 @@ public:
   UInt        getNumAllocatedSlice()    { return m_uiNumAllocatedSlice;         }
   Void        allocateNewSlice();
   Void        clearSliceBuffer();
+  Void        resetSliceBuffer();
   UInt        getNumPartition()         { return m_uiNumPartitions;             }
   UInt        getNumPartInWidth()       { return m_uiNumPartInWidth;            }
   UInt        getNumPartInHeight()      { return m_uiNumPartInHeight;           }
@@ -65,7 +65,8 @@ TComPicYuv::TComPicYuv()
     m_buOffset[i]=0;
   }
 
-  m_bIsBorderExtended = false;
+  m_bIsBorderExtended  = false;
+  m_iNumCtuRowsExtended = 0;
 }
 
 
@@ -89,6 +90,7 @@ Void TComPicYuv::create( const Int  iPicWidth,    const  Int iPicHeight,    cons
   m_iMarginX          = g_uiMaxCUWidth  + 16; // for 16-byte alignment
   m_iMarginY          = g_uiMaxCUHeight + 16;  // margin for 8-tap filter and infinite padding
   m_bIsBorderExtended = false;
+  m_iNumCtuRowsExtended = 0;
 
   // assign the picture arrays and set up the ptr to the top left of the original picture
   {
@@ -174,6 +176,23 @@ Void TComPicYuv::extendPicBorder ()
 {
   if ( m_bIsBorderExtended ) return;
 
+  // extend whatever has not been extended row by row yet
+  extendPicBorderCtuRows( m_iNumCtuRowsExtended, getNumCtuRows() - m_iNumCtuRowsExtended );
+}
+
+/** Extend the left and right margins of a range of CTU rows, together with the top margin when the range contains
+ *  the first row and the bottom margin when it contains the last one, and mark the rows as available.
+ * \param iFirstRow first CTU row to extend, rows must be extended in order
+ * \param iNumRows  number of CTU rows to extend
+ */
+Void TComPicYuv::extendPicBorderCtuRows( Int iFirstRow, Int iNumRows )
+{
+  if ( m_bIsBorderExtended ) return;
+
+  assert( iFirstRow == m_iNumCtuRowsExtended );
+  const Int iNumCtuRows = getNumCtuRows();
+  const Int iEndRow     = std::min( iFirstRow + iNumRows, iNumCtuRows );
+
   for(Int chan=0; chan<getNumberValidComponents(); chan++)
   {
     const ComponentID ch=ComponentID(chan);
@@ -183,10 +202,13 @@ Void TComPicYuv::extendPicBorder ()
     const Int iHeight=getHeight(ch);
     const Int iMarginX=getMarginX(ch);
     const Int iMarginY=getMarginY(ch);
+    const Int iCtuHeight=m_iLcuHeight >> getComponentScaleY(ch);
+    const Int iStartY=iFirstRow * iCtuHeight;
+    const Int iEndY=std::min( iEndRow * iCtuHeight, iHeight );
 
-    Pel*  pi = piTxt;
+    Pel*  pi = piTxt + iStartY * iStride;
     // do left and right margins
-    for (Int y = 0; y < iHeight; y++)
+    for (Int y = iStartY; y < iEndY; y++)
     {
       for (Int x = 0; x < iMarginX; x++ )
       {
@@ -196,24 +218,77 @@ Void TComPicYuv::extendPicBorder ()
       pi += iStride;
     }
 
-    // pi is now the (0,height) (bottom left of image within bigger picture
-    pi -= (iStride + iMarginX);
-    // pi is now the (-marginX, height-1)
-    for (Int y = 0; y < iMarginY; y++ )
+    if ( iEndRow == iNumCtuRows )
     {
-      ::memcpy( pi + (y+1)*iStride, pi, sizeof(Pel)*(iWidth + (iMarginX<<1)) );
+      // pi is (-marginX, height-1)
+      pi = piTxt + (iHeight-1) * iStride - iMarginX;
+      for (Int y = 0; y < iMarginY; y++ )
+      {
+        ::memcpy( pi + (y+1)*iStride, pi, sizeof(Pel)*(iWidth + (iMarginX<<1)) );
+      }
     }
 
-    // pi is still (-marginX, height-1)
-    pi -= ((iHeight-1) * iStride);
-    // pi is now (-marginX, 0)
-    for (Int y = 0; y < iMarginY; y++ )
+    if ( iFirstRow == 0 )
     {
-      ::memcpy( pi - (y+1)*iStride, pi, sizeof(Pel)*(iWidth + (iMarginX<<1)) );
+      // pi is (-marginX, 0)
+      pi = piTxt - iMarginX;
+      for (Int y = 0; y < iMarginY; y++ )
+      {
+        ::memcpy( pi - (y+1)*iStride, pi, sizeof(Pel)*(iWidth + (iMarginX<<1)) );
+      }
     }
   }
 
-  m_bIsBorderExtended = true;
+#if ENABLE_WORKER_THREADS
+  std::lock_guard<std::mutex> cLock( m_cProgressMutex );
+#endif
+  m_iNumCtuRowsExtended = iEndRow;
+  m_bIsBorderExtended   = ( iEndRow == iNumCtuRows );
+#if ENABLE_WORKER_THREADS
+  m_cProgressChanged.notify_all();
+#endif
+}
+
+/** \returns the number of CTU rows, from the top, that are final and border extended
+ */
+Int TComPicYuv::getNumCtuRowsAvailable()
+{
+#if ENABLE_WORKER_THREADS
+  std::lock_guard<std::mutex> cLock( m_cProgressMutex );
+#endif
+  return m_iNumCtuRowsExtended;
+}
+
+/** Block until the given number of CTU rows from the top are final and border extended
+ * \param iNumRows number of CTU rows needed, clipped to the picture height
+ */
+Void TComPicYuv::waitForCtuRows( Int iNumRows )
+{
+  iNumRows = std::min( iNumRows, getNumCtuRows() );
+#if ENABLE_WORKER_THREADS
+  std::unique_lock<std::mutex> cLock( m_cProgressMutex );
+  while ( m_iNumCtuRowsExtended < iNumRows )
+  {
+    m_cProgressChanged.wait( cLock );
+  }
+#else
+  assert( m_iNumCtuRowsExtended >= iNumRows );
+#endif
+}
+
+/** Set whether the margins are extended, resetting the CTU row progress accordingly
+ * \param b true if the whole picture is extended, false if its samples are about to change
+ */
+Void TComPicYuv::setBorderExtension( Bool b )
+{
+#if ENABLE_WORKER_THREADS
+  std::lock_guard<std::mutex> cLock( m_cProgressMutex );
+#endif
+  m_bIsBorderExtended   = b;
+  m_iNumCtuRowsExtended = b ? getNumCtuRows() : 0;
+#if ENABLE_WORKER_THREADS
+  m_cProgressChanged.notify_all();
+#endif
 }
 
 
@@ -44,6 +44,11 @@
 #include "TComChromaFormat.h"
 #include "SEI.h"
 
+#if ENABLE_WORKER_THREADS
+#include <mutex>
+#include <condition_variable>
+#endif
+
 //! \ingroup TLibCommon
 //! \{
 
@@ -82,6 +87,11 @@ private:
   Int   m_iMarginY; // margin of Luma channel (chroma's may be smaller, depending on ratio)
 
   Bool  m_bIsBorderExtended;
+  Int   m_iNumCtuRowsExtended;  ///< number of CTU rows, from the top, whose samples are final and whose margins are extended
+#if ENABLE_WORKER_THREADS
+  std::mutex              m_cProgressMutex;
+  std::condition_variable m_cProgressChanged;
+#endif
 
 public:
                TComPicYuv         ();
@@ -150,19 +160,26 @@ public:
 
   //  Extend function of picture buffer
   Void          extendPicBorder   ();
+  Void          extendPicBorderCtuRows( Int iFirstRow, Int iNumRows );  ///< extend the margins of CTU rows, in order, as they are finished
+
+  //  Progress of the CTU-row border extension, for consumers running ahead of the picture's completion
+  Int           getNumCtuRows     () const { return ( m_iPicHeight + m_iLcuHeight - 1 ) / m_iLcuHeight; }
+  Int           getNumCtuRowsAvailable();
+  Void          waitForCtuRows    ( Int iNumRows );
 
   //  Dump picture
   Void          dump              (const Char* pFileName, Bool bAdd = false) const ;
 
   // Set border extension flag
-  Void          setBorderExtension(Bool b) { m_bIsBorderExtended = b; }
+  Void          setBorderExtension(Bool b);
 };// END CLASS DEFINITION TComPicYuv
 
 
 // These functions now return the length of the digest strings.
-UInt calcChecksum(const TComPicYuv& pic, TComDigest &digest);
-UInt calcCRC     (const TComPicYuv& pic, TComDigest &digest);
-UInt calcMD5     (const TComPicYuv& pic, TComDigest &digest);
+// With bParallelPlanes, the planes are hashed concurrently (if ENABLE_WORKER_THREADS).
+UInt calcChecksum(const TComPicYuv& pic, TComDigest &digest, Bool bParallelPlanes = false);
+UInt calcCRC     (const TComPicYuv& pic, TComDigest &digest, Bool bParallelPlanes = false);
+UInt calcMD5     (const TComPicYuv& pic, TComDigest &digest, Bool bParallelPlanes = false);
 std::string digestToString(const TComDigest &digest, Int numChar);
 //! \}
 
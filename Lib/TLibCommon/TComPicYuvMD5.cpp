@@ -34,109 +34,160 @@
 #include "TComPicYuv.h"
 #include "libmd5/MD5.h"
 
+#include <vector>
+#if SIMD_SSE2
+#include <emmintrin.h>
+#endif
+#if ENABLE_WORKER_THREADS
+#include <thread>
+#endif
+
 //! \ingroup TLibCommon
 //! \{
 
+/// maximum number of digest bytes per plane
+static const UInt MAX_PLANE_DIGEST_LENGTH = MD5_DIGEST_STRING_LENGTH;
+
+/// computes the digest of one plane into digest, returning its length in bytes
+typedef UInt (*PlaneHashFunc)(Int bitdepth, const Pel* plane, UInt width, UInt height, UInt stride, UChar* digest);
+
 /**
- * Update md5 using n samples from plane, each sample is adjusted to
- * OUTBIT_BITDEPTH_DIV8.
+ * Pack width samples into one byte each, keeping the 8 least significant bits.
  */
-template<UInt OUTPUT_BITDEPTH_DIV8>
-static Void md5_block(MD5& md5, const Pel* plane, UInt n)
+static Void packSamples8(UChar* dst, const Pel* src, UInt width)
 {
-  /* create a 64 byte buffer for packing Pel's into */
-  UChar buf[64/OUTPUT_BITDEPTH_DIV8][OUTPUT_BITDEPTH_DIV8];
-  for (UInt i = 0; i < n; i++)
+  UInt x = 0;
+#if SIMD_SSE2 && !RExt__HIGH_BIT_DEPTH_SUPPORT
+  const __m128i vMask = _mm_set1_epi16(0xff);
+  for (; x + 16 <= width; x += 16)
   {
-    Pel pel = plane[i];
-    /* perform bitdepth and endian conversion */
-    for (UInt d = 0; d < OUTPUT_BITDEPTH_DIV8; d++)
-    {
-      buf[i][d] = pel >> (d*8);
-    }
+    const __m128i vLo = _mm_and_si128(_mm_loadu_si128((const __m128i*)(src + x)),     vMask);
+    const __m128i vHi = _mm_and_si128(_mm_loadu_si128((const __m128i*)(src + x + 8)), vMask);
+    _mm_storeu_si128((__m128i*)(dst + x), _mm_packus_epi16(vLo, vHi));
+  }
+#endif
+  for (; x < width; x++)
+  {
+    dst[x] = UChar(src[x]);
   }
-  md5.update((UChar*)buf, n * OUTPUT_BITDEPTH_DIV8);
 }
 
 /**
- * Update md5 with all samples in plane in raster order, each sample
- * is adjusted to OUTBIT_BITDEPTH_DIV8.
+ * Pack width samples into two bytes each, in little-endian byte order.
  */
-template<UInt OUTPUT_BITDEPTH_DIV8>
-static Void md5_plane(MD5& md5, const Pel* plane, UInt width, UInt height, UInt stride)
+static Void packSamples16(UChar* dst, const Pel* src, UInt width)
 {
-  /* N is the number of samples to process per md5 update.
-   * All N samples must fit in buf */
-  UInt N = 32;
-  UInt width_modN = width % N;
-  UInt width_less_modN = width - width_modN;
+  for (UInt x = 0; x < width; x++)
+  {
+    dst[2*x]   = UChar(src[x]);
+    dst[2*x+1] = UChar(src[x] >> 8);
+  }
+}
 
-  for (UInt y = 0; y < height; y++)
+/**
+ * Calculate the MD5sum of all samples in plane in raster order. Each sample
+ * is inserted in little-endian byte order, using one byte for bit depths up
+ * to 8 and two bytes otherwise.
+ */
+static UInt md5Plane(Int bitdepth, const Pel* plane, UInt width, UInt height, UInt stride, UChar* digest)
+{
+  const UInt bytesPerSample = bitdepth <= 8 ? 1 : 2;
+  MD5 md5;
+
+#if !RExt__HIGH_BIT_DEPTH_SUPPORT && !defined(__BIG_ENDIAN__)
+  if (bytesPerSample == sizeof(Pel))
   {
-    /* convert pels into unsigned chars in little endian byte order.
-     * NB, for 8bit data, data is truncated to 8bits. */
-    for (UInt x = 0; x < width_less_modN; x += N)
-      md5_block<OUTPUT_BITDEPTH_DIV8>(md5, &plane[y*stride + x], N);
+    // the samples are already stored as little-endian 16-bit words
+    for (UInt y = 0; y < height; y++, plane += stride)
+    {
+      md5.update((UChar*)plane, width * bytesPerSample);
+    }
+    md5.finalize(digest);
+    return MD5_DIGEST_STRING_LENGTH;
+  }
+#endif
 
-    /* mop up any of the remaining line */
-    md5_block<OUTPUT_BITDEPTH_DIV8>(md5, &plane[y*stride + width_less_modN], width_modN);
+  std::vector<UChar> row(width * bytesPerSample);
+  for (UInt y = 0; y < height; y++, plane += stride)
+  {
+    if (bytesPerSample == 1)
+    {
+      packSamples8(&row[0], plane, width);
+    }
+    else
+    {
+      packSamples16(&row[0], plane, width);
+    }
+    md5.update(&row[0], width * bytesPerSample);
   }
+  md5.finalize(digest);
+  return MD5_DIGEST_STRING_LENGTH;
 }
 
-
-UInt compCRC(Int bitdepth, const Pel* plane, UInt width, UInt height, UInt stride, TComDigest &digest)
+/**
+ * Byte-wise lookup table for the CRC-16 (polynomial 0x1021) of the picture hash SEI:
+ * entry i holds the effect of shifting eight zero bits into a register whose upper byte is i.
+ */
+class CRCTable
 {
-  UInt crcMsb;
-  UInt bitVal;
-  UInt crcVal = 0xffff;
-  UInt bitIdx;
-  for (UInt y = 0; y < height; y++)
+public:
+  CRCTable()
   {
-    for (UInt x = 0; x < width; x++)
+    for (UInt i = 0; i < 256; i++)
     {
-      // take CRC of first pictureData byte
-      for(bitIdx=0; bitIdx<8; bitIdx++)
-      {
-        crcMsb = (crcVal >> 15) & 1;
-        bitVal = (plane[y*stride+x] >> (7 - bitIdx)) & 1;
-        crcVal = (((crcVal << 1) + bitVal) & 0xffff) ^ (crcMsb * 0x1021);
-      }
-      // take CRC of second pictureData byte if bit depth is greater than 8-bits
-      if(bitdepth > 8)
+      UInt crcVal = i << 8;
+      for (UInt bitIdx = 0; bitIdx < 8; bitIdx++)
       {
-        for(bitIdx=0; bitIdx<8; bitIdx++)
-        {
-          crcMsb = (crcVal >> 15) & 1;
-          bitVal = (plane[y*stride+x] >> (15 - bitIdx)) & 1;
-          crcVal = (((crcVal << 1) + bitVal) & 0xffff) ^ (crcMsb * 0x1021);
-        }
+        const UInt crcMsb = (crcVal >> 15) & 1;
+        crcVal = ((crcVal << 1) & 0xffff) ^ (crcMsb * 0x1021);
       }
+      m_table[i] = UShort(crcVal);
     }
   }
-  for(bitIdx=0; bitIdx<16; bitIdx++)
+
+  /// shift the eight bits of byteVal, most significant first, into crcVal
+  inline UInt update(UInt crcVal, UInt byteVal) const
   {
-    crcMsb = (crcVal >> 15) & 1;
-    crcVal = ((crcVal << 1) & 0xffff) ^ (crcMsb * 0x1021);
+    return (((crcVal << 8) & 0xff00) | (byteVal & 0xff)) ^ m_table[crcVal >> 8];
   }
 
-  digest.hash.push_back((crcVal>>8)  & 0xff);
-  digest.hash.push_back( crcVal      & 0xff);
-  return 2;
-}
+private:
+  UShort m_table[256];
+};
+
+static const CRCTable g_crcTable;
 
-UInt calcCRC(const TComPicYuv& pic, TComDigest &digest)
+static UInt crcPlane(Int bitdepth, const Pel* plane, UInt width, UInt height, UInt stride, UChar* digest)
 {
-  UInt digestLen=0;
-  digest.hash.clear();
-  for(Int chan=0; chan<pic.getNumberValidComponents(); chan++)
+  UInt crcVal = 0xffff;
+  for (UInt y = 0; y < height; y++, plane += stride)
   {
-    const ComponentID compID=ComponentID(chan);
-    digestLen=compCRC(g_bitDepth[toChannelType(compID)], pic.getAddr(compID), pic.getWidth(compID), pic.getHeight(compID), pic.getStride(compID), digest);
+    if (bitdepth > 8)
+    {
+      for (UInt x = 0; x < width; x++)
+      {
+        // least significant byte first
+        crcVal = g_crcTable.update(crcVal, plane[x]);
+        crcVal = g_crcTable.update(crcVal, plane[x] >> 8);
+      }
+    }
+    else
+    {
+      for (UInt x = 0; x < width; x++)
+      {
+        crcVal = g_crcTable.update(crcVal, plane[x]);
+      }
+    }
   }
-  return digestLen;
+  crcVal = g_crcTable.update(crcVal, 0);
+  crcVal = g_crcTable.update(crcVal, 0);
+
+  digest[0] = (crcVal>>8)  & 0xff;
+  digest[1] =  crcVal      & 0xff;
+  return 2;
 }
 
-UInt compChecksum(Int bitdepth, const Pel* plane, UInt width, UInt height, UInt stride, TComDigest &digest)
+static UInt checksumPlane(Int bitdepth, const Pel* plane, UInt width, UInt height, UInt stride, UChar* digest)
 {
   UInt checksum = 0;
   UChar xor_mask;
@@ -155,24 +206,73 @@ UInt compChecksum(Int bitdepth, const Pel* plane, UInt width, UInt height, UInt
     }
   }
 
-  digest.hash.push_back((checksum>>24) & 0xff);
-  digest.hash.push_back((checksum>>16) & 0xff);
-  digest.hash.push_back((checksum>>8)  & 0xff);
-  digest.hash.push_back( checksum      & 0xff);
+  digest[0] = (checksum>>24) & 0xff;
+  digest[1] = (checksum>>16) & 0xff;
+  digest[2] = (checksum>>8)  & 0xff;
+  digest[3] =  checksum      & 0xff;
   return 4;
 }
 
-UInt calcChecksum(const TComPicYuv& pic, TComDigest &digest)
+/**
+ * Hash one plane of pic, storing the digest in planeDigest and its length in *pDigestLen.
+ */
+static Void hashPlane(PlaneHashFunc hashFunc, const TComPicYuv* pic, ComponentID compID, UChar* planeDigest, UInt* pDigestLen)
+{
+  *pDigestLen = hashFunc(g_bitDepth[toChannelType(compID)], pic->getAddr(compID), pic->getWidth(compID), pic->getHeight(compID), pic->getStride(compID), planeDigest);
+}
+
+/**
+ * Hash each plane of pic with hashFunc and append the per-plane digests to
+ * digest in component order. With bParallelPlanes, the chroma planes are
+ * hashed on worker threads while the calling thread hashes luma.
+ */
+static UInt calcPlaneHashes(const TComPicYuv& pic, TComDigest &digest, PlaneHashFunc hashFunc, Bool bParallelPlanes)
 {
-  UInt digestLen=0;
+  const UInt numComp = pic.getNumberValidComponents();
+  UChar planeDigest[MAX_NUM_COMPONENT][MAX_PLANE_DIGEST_LENGTH];
+  UInt  digestLen[MAX_NUM_COMPONENT];
+
+#if ENABLE_WORKER_THREADS
+  if (bParallelPlanes && numComp > 1)
+  {
+    std::thread workers[MAX_NUM_COMPONENT];
+    for (UInt comp = 1; comp < numComp; comp++)
+    {
+      workers[comp] = std::thread(hashPlane, hashFunc, &pic, ComponentID(comp), planeDigest[comp], &digestLen[comp]);
+    }
+    hashPlane(hashFunc, &pic, COMPONENT_Y, planeDigest[COMPONENT_Y], &digestLen[COMPONENT_Y]);
+    for (UInt comp = 1; comp < numComp; comp++)
+    {
+      workers[comp].join();
+    }
+  }
+  else
+#endif
+  {
+    for (UInt comp = 0; comp < numComp; comp++)
+    {
+      hashPlane(hashFunc, &pic, ComponentID(comp), planeDigest[comp], &digestLen[comp]);
+    }
+  }
+
   digest.hash.clear();
-  for(Int chan=0; chan<pic.getNumberValidComponents(); chan++)
+  for (UInt comp = 0; comp < numComp; comp++)
   {
-    const ComponentID compID=ComponentID(chan);
-    digestLen=compChecksum(g_bitDepth[toChannelType(compID)], pic.getAddr(compID), pic.getWidth(compID), pic.getHeight(compID), pic.getStride(compID), digest);
+    digest.hash.insert(digest.hash.end(), planeDigest[comp], planeDigest[comp] + digestLen[comp]);
   }
-  return digestLen;
+  return digestLen[COMPONENT_Y];
+}
+
+UInt calcCRC(const TComPicYuv& pic, TComDigest &digest, Bool bParallelPlanes)
+{
+  return calcPlaneHashes(pic, digest, crcPlane, bParallelPlanes);
+}
+
+UInt calcChecksum(const TComPicYuv& pic, TComDigest &digest, Bool bParallelPlanes)
+{
+  return calcPlaneHashes(pic, digest, checksumPlane, bParallelPlanes);
 }
+
 /**
  * Calculate the MD5sum of pic, storing the result in digest.
  * MD5 calculation is performed on Y' then Cb, then Cr; each in raster order.
@@ -180,28 +280,9 @@ UInt calcChecksum(const TComPicYuv& pic, TComDigest &digest)
  * using sufficient bytes to represent the picture bitdepth.  Eg, 10bit data
  * uses little-endian two byte words; 8bit data uses single byte words.
  */
-UInt calcMD5(const TComPicYuv& pic, TComDigest &digest)
+UInt calcMD5(const TComPicYuv& pic, TComDigest &digest, Bool bParallelPlanes)
 {
-  /* choose an md5_plane packing function based on the system bitdepth */
-  typedef Void (*MD5PlaneFunc)(MD5&, const Pel*, UInt, UInt, UInt);
-  MD5PlaneFunc md5_plane_func;
-
-  MD5 md5[MAX_NUM_COMPONENT];
-
-  digest.hash.clear();
-  for(Int chan=0; chan<pic.getNumberValidComponents(); chan++)
-  {
-    const ComponentID compID=ComponentID(chan);
-    md5_plane_func = g_bitDepth[toChannelType(compID)] <= 8 ? (MD5PlaneFunc)md5_plane<1> : (MD5PlaneFunc)md5_plane<2>;
-    UChar tmp_digest[MD5_DIGEST_STRING_LENGTH];
-    md5_plane_func(md5[compID], pic.getAddr(compID), pic.getWidth(compID), pic.getHeight(compID), pic.getStride(compID));
-    md5[compID].finalize(tmp_digest);
-    for(UInt i=0; i<MD5_DIGEST_STRING_LENGTH; i++)
-    {
-      digest.hash.push_back(tmp_digest[i]);
-    }
-  }
-  return 16;
+  return calcPlaneHashes(pic, digest, md5Plane, bParallelPlanes);
 }
 
 std::string digestToString(const TComDigest &digest, Int numChar)
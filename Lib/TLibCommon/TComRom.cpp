@@ -136,9 +136,80 @@ public:
   }
 };
 
+// number of codec instances that have initialized the ROM tables (several encoders may share them)
+static Int s_numROMUsers = 0;
+
+// z-scan index of the minimum unit (x, y) inside an aligned square block
+static UInt getZscanIdxInBlock( UInt x, UInt y )
+{
+  UInt idx = 0;
+  for ( UInt bit = 0; bit < MAX_CU_DEPTH; bit++ )
+  {
+    idx |= ( ( x >> bit ) & 1 ) << ( 2 * bit     );
+    idx |= ( ( y >> bit ) & 1 ) << ( 2 * bit + 1 );
+  }
+  return idx;
+}
+
+// position and size in minimum units of PU puIdx in a CU n units wide, false if the CU has no such PU
+static Bool getPURect( PartSize ePartSize, UInt puIdx, UInt n, UInt& x0, UInt& y0, UInt& w, UInt& h )
+{
+  const UInt half    = n >> 1;
+  const UInt quarter = n >> 2;
+  UInt numPU = 2;
+
+  x0 = 0; y0 = 0; w = n; h = n;
+  switch ( ePartSize )
+  {
+    case SIZE_2Nx2N:
+      numPU = 1;
+      break;
+    case SIZE_2NxN:
+      h  = half;
+      y0 = puIdx * half;
+      break;
+    case SIZE_Nx2N:
+      w  = half;
+      x0 = puIdx * half;
+      break;
+    case SIZE_NxN:
+      numPU = 4;
+      w  = half;
+      h  = half;
+      x0 = ( puIdx & 1 ) * half;
+      y0 = ( puIdx >> 1 ) * half;
+      break;
+    case SIZE_2NxnU:
+      h  = ( puIdx == 0 ) ? quarter : n - quarter;
+      y0 = puIdx * quarter;
+      break;
+    case SIZE_2NxnD:
+      h  = ( puIdx == 0 ) ? n - quarter : quarter;
+      y0 = puIdx * ( n - quarter );
+      break;
+    case SIZE_nLx2N:
+      w  = ( puIdx == 0 ) ? quarter : n - quarter;
+      x0 = puIdx * quarter;
+      break;
+    case SIZE_nRx2N:
+      w  = ( puIdx == 0 ) ? n - quarter : quarter;
+      x0 = puIdx * ( n - quarter );
+      break;
+    default:
+      numPU = 0;
+      break;
+  }
+  return puIdx < numPU && w > 0 && h > 0;
+}
+
 // initialize ROM variables
 Void initROM()
 {
+  if ( s_numROMUsers++ > 0 )
+  {
+    return;
+  }
+
   Int i, c;
 
   // g_aucConvertToBit[ x ]: log2(x/4), if x=4 -> 0, x=8 -> 1, x=16 -> 2, ...
@@ -150,6 +221,28 @@ Void initROM()
     c++;
   }
 
+  // corner and centre units of every PU shape, for each CU size
+  ::memset( g_auPUNeighbourIdx, 0, sizeof( g_auPUNeighbourIdx ) );
+  for ( UInt log2Units = 0; log2Units < MAX_CU_DEPTH; log2Units++ )
+  {
+    for ( UInt partSize = 0; partSize < NUMBER_OF_PART_SIZES; partSize++ )
+    {
+      for ( UInt puIdx = 0; puIdx < 4; puIdx++ )
+      {
+        UInt x0, y0, w, h;
+        if ( getPURect( PartSize( partSize ), puIdx, 1 << log2Units, x0, y0, w, h ) )
+        {
+          PUNeighbourIdx& rcIdx = g_auPUNeighbourIdx[log2Units][partSize][puIdx];
+          rcIdx.uiLT     = getZscanIdxInBlock( x0,         y0         );
+          rcIdx.uiRT     = getZscanIdxInBlock( x0 + w - 1, y0         );
+          rcIdx.uiLB     = getZscanIdxInBlock( x0,         y0 + h - 1 );
+          rcIdx.uiRB     = getZscanIdxInBlock( x0 + w - 1, y0 + h - 1 );
+          rcIdx.uiCenter = getZscanIdxInBlock( x0 + w / 2, y0 + h / 2 );
+        }
+      }
+    }
+  }
+
   // initialise scan orders
   for(UInt log2BlockHeight = 0; log2BlockHeight < MAX_CU_DEPTH; log2BlockHeight++)
   {
@@ -223,6 +316,11 @@ Void initROM()
 
 Void destroyROM()
 {
+  if ( --s_numROMUsers > 0 )
+  {
+    return;
+  }
+
   for(UInt groupTypeIndex = 0; groupTypeIndex < SCAN_NUMBER_OF_GROUP_TYPES; groupTypeIndex++)
   {
     for (UInt scanOrderIndex = 0; scanOrderIndex < SCAN_NUMBER_OF_TYPES; scanOrderIndex++)
@@ -253,6 +351,8 @@ UInt g_auiRasterToPelY  [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ] = { 0, };
 
 UInt g_auiPUOffset[NUMBER_OF_PART_SIZES] = { 0, 8, 4, 4, 2, 10, 1, 5};
 
+PUNeighbourIdx g_auPUNeighbourIdx[MAX_CU_DEPTH][NUMBER_OF_PART_SIZES][4];
+
 Void initZscanToRaster ( Int iMaxDepth, Int iDepth, UInt uiStartVal, UInt*& rpuiCurrIdx )
 {
   Int iStride = 1 << ( iMaxDepth - 1 );
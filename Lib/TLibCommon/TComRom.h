@@ -92,6 +92,19 @@ extern       UInt g_uiAddCUDepth;
 
 extern       UInt g_auiPUOffset[NUMBER_OF_PART_SIZES];
 
+// z-scan offsets of the corner and centre minimum units of a PU, relative to the first unit of its CU
+struct PUNeighbourIdx
+{
+  UInt uiLT;      ///< top-left unit
+  UInt uiRT;      ///< top-right unit
+  UInt uiLB;      ///< bottom-left unit
+  UInt uiRB;      ///< bottom-right unit
+  UInt uiCenter;  ///< unit used for the collocated centre candidate
+};
+
+// [log2(CU width in minimum units)][part size][PU index]
+extern       PUNeighbourIdx g_auPUNeighbourIdx[MAX_CU_DEPTH][NUMBER_OF_PART_SIZES][4];
+
 #define QUANT_SHIFT                14 // Q(4) = 2^14
 #define IQUANT_SHIFT                6
 #define SCALE_BITS                 15 // Inherited from TMuC, pressumably for fractional bit estimates in RDOQ
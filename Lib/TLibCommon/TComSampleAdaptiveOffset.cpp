@@ -734,6 +734,45 @@ Void TComSampleAdaptiveOffset::SAOProcess(TComPic* pDecPic)
 }
 
 
+/** SAO process followed by the PCM LF disable process, run CTU row by CTU row. Each row of the reconstruction is
+ *  border extended, and so available as a reference, as soon as it is final.
+ * \param pDecPic picture (TComPic) pointer
+ */
+Void TComSampleAdaptiveOffset::SAOProcessCtuRows(TComPic* pDecPic)
+{
+  const Int numberOfComponents = getNumberValidComponents(m_chromaFormatIDC);
+  Bool bAllDisabled=true;
+  for(Int compIdx = 0; compIdx < numberOfComponents; compIdx++)
+  {
+    if (m_picSAOEnabled[compIdx]) bAllDisabled=false;
+  }
+  const Bool bRestorePCM = xIsPCMRestorationNeeded(pDecPic);
+
+  TComPicYuv* resYuv = pDecPic->getPicYuvRec();
+  TComPicYuv* srcYuv = m_tempPicYuv;
+  if (!bAllDisabled)
+  {
+    resYuv->copyToPic(srcYuv);
+  }
+  resYuv->setBorderExtension(false);
+
+  for(Int ctuRow = 0; ctuRow < m_numCTUInHeight; ctuRow++)
+  {
+    for(Int ctu = ctuRow*m_numCTUInWidth; ctu < (ctuRow+1)*m_numCTUInWidth; ctu++)
+    {
+      if (!bAllDisabled)
+      {
+        offsetCTU(ctu, srcYuv, resYuv, (pDecPic->getPicSym()->getSAOBlkParam())[ctu], pDecPic);
+      }
+      if (bRestorePCM)
+      {
+        xPCMCURestoration(pDecPic->getCU(ctu), 0, 0);
+      }
+    }
+    resYuv->extendPicBorderCtuRows(ctuRow, 1);
+  }
+}
+
 /** PCM LF disable process.
  * \param pcPic picture (TComPic) pointer
  * \returns Void
@@ -751,9 +790,7 @@ Void TComSampleAdaptiveOffset::PCMLFDisableProcess (TComPic* pcPic)
  */
 Void TComSampleAdaptiveOffset::xPCMRestoration(TComPic* pcPic)
 {
-  Bool  bPCMFilter = (pcPic->getSlice(0)->getSPS()->getUsePCM() && pcPic->getSlice(0)->getSPS()->getPCMFilterDisableFlag())? true : false;
-
-  if(bPCMFilter || pcPic->getSlice(0)->getPPS()->getTransquantBypassEnableFlag())
+  if(xIsPCMRestorationNeeded(pcPic))
   {
     for( UInt uiCUAddr = 0; uiCUAddr < pcPic->getNumCUsInFrame() ; uiCUAddr++ )
     {
@@ -764,6 +801,17 @@ Void TComSampleAdaptiveOffset::xPCMRestoration(TComPic* pcPic)
   }
 }
 
+/** Check whether any CU of the picture can have its unfiltered samples restored.
+ * \param pcPic picture (TComPic) pointer
+ * \returns true if PCM samples bypass the loop filters or lossless coding is enabled
+ */
+Bool TComSampleAdaptiveOffset::xIsPCMRestorationNeeded(TComPic* pcPic)
+{
+  Bool  bPCMFilter = (pcPic->getSlice(0)->getSPS()->getUsePCM() && pcPic->getSlice(0)->getSPS()->getPCMFilterDisableFlag())? true : false;
+
+  return bPCMFilter || pcPic->getSlice(0)->getPPS()->getTransquantBypassEnableFlag();
+}
+
 /** PCM CU restoration.
  * \param pcCU pointer to current CU
  * \param uiAbsPartIdx part index
@@ -827,6 +827,69 @@ Void partialButterflyInverse32(TCoeff *src, TCoeff *dst, Int shift, Int line, co
   }
 }
 
+/** Inverse transform (1D) of lines whose non-zero inputs all lie among the first few, using a single even/odd
+ *  decomposition and skipping the zero inputs. The sums are the same as those of the partial butterflies.
+ *  \param src       input data (transform coefficients)
+ *  \param dst       output data (residual)
+ *  \param shift     specifies right shift after 1D transform
+ *  \param line      number of lines (also the stride between the inputs of a line)
+ *  \param numLines  number of leading lines that contain non-zero inputs; the output of the other lines is zero
+ *  \param numInputs number of leading inputs of each line that can be non-zero
+ *  \param size      transform size
+ *  \param matrix    inverse transform matrix of the given size
+ */
+Void partialButterflyInverseReduced(TCoeff *src, TCoeff *dst, Int shift, Int line, Int numLines, Int numInputs, Int size, const TMatrixCoeff *matrix, const TCoeff outputMinimum, const TCoeff outputMaximum)
+{
+  Int j,k,i;
+  const Int half = size >> 1;
+  TCoeff E[MAX_TU_SIZE >> 1],O[MAX_TU_SIZE >> 1];
+  TCoeff add = (shift > 0) ? (1<<(shift-1)) : 0;
+
+  for (j=0; j<numLines; j++)
+  {
+    for (k=0;k<half;k++)
+    {
+      TCoeff even = 0;
+      TCoeff odd  = 0;
+      for (i=0; i<numInputs; i+=2)
+      {
+        even += matrix[(i * size) + k] * src[i * line];
+      }
+      for (i=1; i<numInputs; i+=2)
+      {
+        odd  += matrix[(i * size) + k] * src[i * line];
+      }
+      E[k] = even;
+      O[k] = odd;
+    }
+    for (k=0;k<half;k++)
+    {
+      dst[k]          = Clip3( outputMinimum, outputMaximum, (E[k] + O[k] + add)>>shift );
+      dst[size-1-k]   = Clip3( outputMinimum, outputMaximum, (E[k] - O[k] + add)>>shift );
+    }
+    src ++;
+    dst += size;
+  }
+
+  memset(dst, 0, ((line - numLines) * size * sizeof(TCoeff)));
+}
+
+/** Return the inverse transform matrix for a transform size
+ */
+static const TMatrixCoeff *getInverseTransformMatrix(Int size)
+{
+  switch (size)
+  {
+    case  4: return &g_aiT4 [TRANSFORM_INVERSE][0][0];
+    case  8: return &g_aiT8 [TRANSFORM_INVERSE][0][0];
+    case 16: return &g_aiT16[TRANSFORM_INVERSE][0][0];
+    case 32: return &g_aiT32[TRANSFORM_INVERSE][0][0];
+    default:
+      assert(0); exit (1); break;
+  }
+  return NULL;
+}
+
 /** MxN forward transform (2D)
 *  \param block input data (residual)
 *  \param coeff output data (transform coefficients)
@@ -890,8 +953,13 @@ Void xTrMxN(Int bitDepth, TCoeff *block, TCoeff *coeff, Int iWidth, Int iHeight,
 *  \param block output data (residual)
 *  \param iWidth input data (width of transform)
 *  \param iHeight input data (height of transform)
+*  \param numCols number of leading columns that contain non-zero coefficients
+*  \param numRows number of leading rows that contain non-zero coefficients
+*
+*  When the non-zero coefficients are confined to the low frequencies, the reduced 1D transform is used for the
+*  stages whose inputs are at most half non-zero, and a DC-only block is filled with its constant residual.
 */
-Void xITrMxN(Int bitDepth, TCoeff *coeff, TCoeff *block, Int iWidth, Int iHeight, Bool useDST, const Int maxTrDynamicRange)
+Void xITrMxN(Int bitDepth, TCoeff *coeff, TCoeff *block, Int iWidth, Int iHeight, Bool useDST, const Int maxTrDynamicRange, const Int numCols, const Int numRows)
 {
   static const Int TRANSFORM_MATRIX_SHIFT = g_transformMatrixShift[TRANSFORM_INVERSE];
 
@@ -903,47 +971,81 @@ Void xITrMxN(Int bitDepth, TCoeff *coeff, TCoeff *block, Int iWidth, Int iHeight
   assert(shift_1st >= 0);
   assert(shift_2nd >= 0);
 
+  const Bool bDST4x4 = (iWidth == 4) && (iHeight == 4) && useDST;
+
+  if (!bDST4x4 && (numCols <= 1) && (numRows <= 1))
+  {
+    //DC only (or empty): every residual sample has the same value
+    const TCoeff dc     = (numCols == 0 || numRows == 0) ? 0 : coeff[0];
+    const TCoeff gain   = g_aiT4[TRANSFORM_INVERSE][0][0]; //the first basis function is flat for every transform size
+    const TCoeff add1st = 1 << (shift_1st - 1);
+    const TCoeff add2nd = (shift_2nd > 0) ? (1 << (shift_2nd - 1)) : 0;
+    const TCoeff tmpDC  = Clip3( clipMinimum, clipMaximum, (gain * dc + add1st) >> shift_1st );
+    const TCoeff value  = Clip3<TCoeff>( std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max(), (gain * tmpDC + add2nd) >> shift_2nd );
+
+    for (Int n = 0; n < (iWidth * iHeight); n++)
+    {
+      block[n] = value;
+    }
+    return;
+  }
+
   TCoeff tmp[MAX_TU_SIZE * MAX_TU_SIZE];
 
-  switch (iHeight)
+  if (!bDST4x4 && ((numRows << 1) <= iHeight))
   {
-    case 4:
-      {
-        if ((iWidth == 4) && useDST)    // Check for DCT or DST
+    partialButterflyInverseReduced( coeff, tmp, shift_1st, iWidth, numCols, numRows, iHeight, getInverseTransformMatrix(iHeight), clipMinimum, clipMaximum );
+  }
+  else
+  {
+    switch (iHeight)
+    {
+      case 4:
         {
-          fastInverseDst( coeff, tmp, shift_1st, clipMinimum, clipMaximum);
+          if ((iWidth == 4) && useDST)    // Check for DCT or DST
+          {
+            fastInverseDst( coeff, tmp, shift_1st, clipMinimum, clipMaximum);
+          }
+          else partialButterflyInverse4 ( coeff, tmp, shift_1st, iWidth, clipMinimum, clipMaximum);
         }
-        else partialButterflyInverse4 ( coeff, tmp, shift_1st, iWidth, clipMinimum, clipMaximum);
-      }
-      break;
+        break;
 
-    case  8: partialButterflyInverse8 ( coeff, tmp, shift_1st, iWidth, clipMinimum, clipMaximum); break;
-    case 16: partialButterflyInverse16( coeff, tmp, shift_1st, iWidth, clipMinimum, clipMaximum); break;
-    case 32: partialButterflyInverse32( coeff, tmp, shift_1st, iWidth, clipMinimum, clipMaximum); break;
+      case  8: partialButterflyInverse8 ( coeff, tmp, shift_1st, iWidth, clipMinimum, clipMaximum); break;
+      case 16: partialButterflyInverse16( coeff, tmp, shift_1st, iWidth, clipMinimum, clipMaximum); break;
+      case 32: partialButterflyInverse32( coeff, tmp, shift_1st, iWidth, clipMinimum, clipMaximum); break;
 
-    default:
-      assert(0); exit (1); break;
+      default:
+        assert(0); exit (1); break;
+    }
   }
 
-  switch (iWidth)
+  if (!bDST4x4 && ((numCols << 1) <= iWidth))
   {
-    //NOTE: RExt - Clipping here is not in the standard, but is used to protect the "Pel" data type into which the inverse-transformed samples will be copied
-    case 4:
-      {
-        if ((iHeight == 4) && useDST)    // Check for DCT or DST
+    //the first stage output is non-zero only for the first numCols inputs of each line of the second stage
+    partialButterflyInverseReduced( tmp, block, shift_2nd, iHeight, iHeight, numCols, iWidth, getInverseTransformMatrix(iWidth), std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max() );
+  }
+  else
+  {
+    switch (iWidth)
+    {
+      //NOTE: RExt - Clipping here is not in the standard, but is used to protect the "Pel" data type into which the inverse-transformed samples will be copied
+      case 4:
         {
-          fastInverseDst( tmp, block, shift_2nd, std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max() );
+          if ((iHeight == 4) && useDST)    // Check for DCT or DST
+          {
+            fastInverseDst( tmp, block, shift_2nd, std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max() );
+          }
+          else partialButterflyInverse4 ( tmp, block, shift_2nd, iHeight, std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max());
         }
-        else partialButterflyInverse4 ( tmp, block, shift_2nd, iHeight, std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max());
-      }
-      break;
+        break;
 
-    case  8: partialButterflyInverse8 ( tmp, block, shift_2nd, iHeight, std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max()); break;
-    case 16: partialButterflyInverse16( tmp, block, shift_2nd, iHeight, std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max()); break;
-    case 32: partialButterflyInverse32( tmp, block, shift_2nd, iHeight, std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max()); break;
+      case  8: partialButterflyInverse8 ( tmp, block, shift_2nd, iHeight, std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max()); break;
+      case 16: partialButterflyInverse16( tmp, block, shift_2nd, iHeight, std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max()); break;
+      case 32: partialButterflyInverse32( tmp, block, shift_2nd, iHeight, std::numeric_limits<Pel>::min(), std::numeric_limits<Pel>::max()); break;
 
-    default:
-      assert(0); exit (1); break;
+      default:
+        assert(0); exit (1); break;
+    }
   }
 }
 
@@ -1852,10 +1954,28 @@ Void TComTrQuant::xIT( const ComponentID compID, Bool useDST, TCoeff* plCoef, Pe
 
   memcpy(coeff, plCoef, (iWidth * iHeight * sizeof(TCoeff)));
 
+  //find the top-left region that holds all non-zero coefficients, so that the zero rows and columns can be skipped
+  Int numCols = 0;
+  Int numRows = 0;
+  for (Int y = 0; y < iHeight; y++)
+  {
+    const TCoeff *row = coeff + (y * iWidth);
+    Int lastCol = iWidth;
+    while ((lastCol > 0) && (row[lastCol - 1] == 0))
+    {
+      lastCol--;
+    }
+    if (lastCol > 0)
+    {
+      numRows = y + 1;
+      numCols = std::max(numCols, lastCol);
+    }
+  }
+
 #if RExt__O0043_BEST_EFFORT_DECODING
-  xITrMxN( g_bitDepthInStream[toChannelType(compID)], coeff, block, iWidth, iHeight, useDST, g_maxTrDynamicRange[toChannelType(compID)] );
+  xITrMxN( g_bitDepthInStream[toChannelType(compID)], coeff, block, iWidth, iHeight, useDST, g_maxTrDynamicRange[toChannelType(compID)], numCols, numRows );
 #else
-  xITrMxN( g_bitDepth[toChannelType(compID)], coeff, block, iWidth, iHeight, useDST, g_maxTrDynamicRange[toChannelType(compID)] );
+  xITrMxN( g_bitDepth[toChannelType(compID)], coeff, block, iWidth, iHeight, useDST, g_maxTrDynamicRange[toChannelType(compID)], numCols, numRows );
 #endif
 
   for (Int y = 0; y < iHeight; y++)
@@ -2645,6 +2765,90 @@ Int TComTrQuant::getSigCtxInc    (       Int                        patternSigCt
 }
 
 
+/** Context derivation process of coeff_abs_significant_flag for all positions of a coefficient group
+ * \param patternSigCtx pattern for current coefficient group
+ * \param codingParameters coding parmeters for the TU (includes the scan)
+ * \param uiCGPosX column of current coefficient group
+ * \param uiCGPosY row of current coefficient group
+ * \param log2BlockWidth log2 width of the block
+ * \param log2BlockHeight log2 height of the block
+ * \param chanType channel type (CHANNEL_TYPE_LUMA/CHROMA)
+ * \param ctxInc returns the ctxInc of each position, in raster order within the group
+ *
+ * Gives the same result as getSigCtxInc, but resolves the block size and group dependent terms once per group.
+ */
+Void TComTrQuant::getSigCtxIncGroup(       Int                        patternSigCtx,
+                                     const TUEntropyCodingParameters &codingParameters,
+                                     const UInt                       uiCGPosX,
+                                     const UInt                       uiCGPosY,
+                                     const Int                        log2BlockWidth,
+                                     const Int                        log2BlockHeight,
+                                     const ChannelType                chanType,
+                                           UChar                     *ctxInc)
+{
+  const Int groupWidth  = 1 << MLS_CG_LOG2_WIDTH;
+  const Int groupHeight = 1 << MLS_CG_LOG2_HEIGHT;
+
+  if (codingParameters.firstSignificanceMapContext == significanceMapContextSetStart[chanType][CONTEXT_TYPE_SINGLE])
+  {
+    //single context mode
+    memset(ctxInc, significanceMapContextSetStart[chanType][CONTEXT_TYPE_SINGLE], (1 << MLS_CG_SIZE));
+    return;
+  }
+
+  if ((log2BlockWidth == 2) && (log2BlockHeight == 2)) //4x4
+  {
+    for (Int i = 0; i < (1 << MLS_CG_SIZE); i++)
+    {
+      ctxInc[i] = codingParameters.firstSignificanceMapContext + ctxIndMap4x4[i];
+    }
+  }
+  else
+  {
+    const Bool notFirstGroup = (uiCGPosX + uiCGPosY) > 0;
+    const Int  offset        = codingParameters.firstSignificanceMapContext + (notFirstGroup ? notFirstGroupNeighbourhoodContextOffset[chanType] : 0);
+
+    for (Int posYinSubset = 0; posYinSubset < groupHeight; posYinSubset++)
+    {
+      for (Int posXinSubset = 0; posXinSubset < groupWidth; posXinSubset++)
+      {
+        Int cnt = 0;
+
+        switch (patternSigCtx)
+        {
+          case 0: //neither neighbouring group is significant
+            {
+              const Int posTotalInSubset = posXinSubset + posYinSubset;
+              cnt = (posTotalInSubset >= NEIGHBOURHOOD_00_CONTEXT_1_THRESHOLD_4x4) ? 0 : ((posTotalInSubset >= NEIGHBOURHOOD_00_CONTEXT_2_THRESHOLD_4x4) ? 1 : 2);
+            }
+            break;
+          case 1: //right group is significant, below is not
+            cnt = (posYinSubset >= (groupHeight >> 1)) ? 0 : ((posYinSubset >= (groupHeight >> 2)) ? 1 : 2);
+            break;
+          case 2: //below group is significant, right is not
+            cnt = (posXinSubset >= (groupWidth >> 1)) ? 0 : ((posXinSubset >= (groupWidth >> 2)) ? 1 : 2);
+            break;
+          case 3: //both neighbouring groups are significant
+            cnt = 2;
+            break;
+          default:
+            std::cerr << "ERROR: Invalid patternSigCtx \"" << Int(patternSigCtx) << "\" in getSigCtxIncGroup" << std::endl;
+            exit(1);
+            break;
+        }
+
+        ctxInc[(posYinSubset << MLS_CG_LOG2_WIDTH) + posXinSubset] = offset + cnt;
+      }
+    }
+  }
+
+  if ((uiCGPosX + uiCGPosY) == 0)
+  {
+    ctxInc[0] = 0; //special case for the DC context variable
+  }
+}
+
+
 /** Get the best level in RD sense
  * \param rd64CodedCost reference to coded cost
  * \param rd64CodedCost0 reference to cost when coefficient is 0
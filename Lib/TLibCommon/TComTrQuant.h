@@ -163,6 +163,16 @@ public:
                                      const ChannelType                chanType
                                     );
 
+  static Void     getSigCtxIncGroup( Int                              patternSigCtx,
+                                     const TUEntropyCodingParameters &codingParameters,
+                                     const UInt                       uiCGPosX,
+                                     const UInt                       uiCGPosY,
+                                     const Int                        log2BlockWidth,
+                                     const Int                        log2BlockHeight,
+                                     const ChannelType                chanType,
+                                           UChar                     *ctxInc
+                                    );
+
   static UInt getSigCoeffGroupCtxInc  (const UInt*  uiSigCoeffGroupFlag,
                                        const UInt   uiCGPosX,
                                        const UInt   uiCGPosY,
@@ -40,6 +40,10 @@
 #include "TComWeightPrediction.h"
 #include "TComInterpolationFilter.h"
 
+#if SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
 
 static inline Pel weightBidir( Int w0, Pel P0, Int w1, Pel P1, Int round, Int shift, Int offset, Int clipBD)
 {
@@ -52,6 +56,93 @@ static inline Pel weightUnidir( Int w0, Pel P0, Int round, Int shift, Int offset
   return ClipBD( ( (w0*(P0 + IF_INTERNAL_OFFS) + round) >> shift ) + offset, clipBD );
 }
 
+#if SIMD_SSE2 && !RExt__HIGH_BIT_DEPTH_SUPPORT
+/** weightBidir() of eight pairs of samples; vWeights holds (w0, w1) in each 32-bit lane and vAdd the folded constant terms
+ */
+static inline __m128i weightBidirSSE2( __m128i vP0, __m128i vP1, __m128i vWeights, __m128i vAdd, __m128i vShift, __m128i vMaxVal )
+{
+  const __m128i vLo = _mm_sra_epi32( _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( vP0, vP1 ), vWeights ), vAdd ), vShift );
+  const __m128i vHi = _mm_sra_epi32( _mm_add_epi32( _mm_madd_epi16( _mm_unpackhi_epi16( vP0, vP1 ), vWeights ), vAdd ), vShift );
+  return _mm_min_epi16( _mm_max_epi16( _mm_packs_epi32( vLo, vHi ), _mm_setzero_si128() ), vMaxVal );
+}
+
+/** weightUnidir() of eight samples; vWeight holds (w0, 0) in each 32-bit lane and vAdd the folded rounding term
+ */
+static inline __m128i weightUnidirSSE2( __m128i vP0, __m128i vWeight, __m128i vAdd, __m128i vShift, __m128i vOffset, __m128i vMaxVal )
+{
+  const __m128i vZero = _mm_setzero_si128();
+  const __m128i vLo   = _mm_add_epi32( _mm_sra_epi32( _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( vP0, vZero ), vWeight ), vAdd ), vShift ), vOffset );
+  const __m128i vHi   = _mm_add_epi32( _mm_sra_epi32( _mm_add_epi32( _mm_madd_epi16( _mm_unpackhi_epi16( vP0, vZero ), vWeight ), vAdd ), vShift ), vOffset );
+  return _mm_min_epi16( _mm_max_epi16( _mm_packs_epi32( vLo, vHi ), vZero ), vMaxVal );
+}
+#endif
+
+/** weighted bi-prediction of one row of samples
+ */
+static inline Void weightBidirRow( const Pel* pSrc0, const Pel* pSrc1, Pel* pDst, Int iWidth, Int w0, Int w1, Int round, Int shift, Int offset, Int clipBD )
+{
+  Int x = 0;
+
+#if SIMD_SSE2 && !RExt__HIGH_BIT_DEPTH_SUPPORT
+  // the input offsets are folded into the constant term, so only the raw samples are multiplied
+  const __m128i vWeights = _mm_set1_epi32( ( w0 & 0xffff ) | ( w1 << 16 ) );
+  const __m128i vAdd     = _mm_set1_epi32( ( w0 + w1 ) * IF_INTERNAL_OFFS + round + ( offset << ( shift - 1 ) ) );
+  const __m128i vShift   = _mm_cvtsi32_si128( shift );
+  const __m128i vMaxVal  = _mm_set1_epi16( Short( ( 1 << clipBD ) - 1 ) );
+
+  for ( ; x + 8 <= iWidth; x += 8 )
+  {
+    const __m128i vP0 = _mm_loadu_si128( (const __m128i*)( pSrc0 + x ) );
+    const __m128i vP1 = _mm_loadu_si128( (const __m128i*)( pSrc1 + x ) );
+    _mm_storeu_si128( (__m128i*)( pDst + x ), weightBidirSSE2( vP0, vP1, vWeights, vAdd, vShift, vMaxVal ) );
+  }
+  if ( x + 4 <= iWidth )
+  {
+    const __m128i vP0 = _mm_loadl_epi64( (const __m128i*)( pSrc0 + x ) );
+    const __m128i vP1 = _mm_loadl_epi64( (const __m128i*)( pSrc1 + x ) );
+    _mm_storel_epi64( (__m128i*)( pDst + x ), weightBidirSSE2( vP0, vP1, vWeights, vAdd, vShift, vMaxVal ) );
+    x += 4;
+  }
+#endif
+
+  for ( ; x < iWidth; x++ )
+  {
+    pDst[x] = weightBidir(w0, pSrc0[x], w1, pSrc1[x], round, shift, offset, clipBD);
+  }
+}
+
+/** weighted uni-prediction of one row of samples
+ */
+static inline Void weightUnidirRow( const Pel* pSrc0, Pel* pDst, Int iWidth, Int w0, Int round, Int shift, Int offset, Int clipBD )
+{
+  Int x = 0;
+
+#if SIMD_SSE2 && !RExt__HIGH_BIT_DEPTH_SUPPORT
+  const __m128i vWeight = _mm_set1_epi32( w0 & 0xffff );
+  const __m128i vAdd    = _mm_set1_epi32( w0 * IF_INTERNAL_OFFS + round );
+  const __m128i vShift  = _mm_cvtsi32_si128( shift );
+  const __m128i vOffset = _mm_set1_epi32( offset );
+  const __m128i vMaxVal = _mm_set1_epi16( Short( ( 1 << clipBD ) - 1 ) );
+
+  for ( ; x + 8 <= iWidth; x += 8 )
+  {
+    const __m128i vP0 = _mm_loadu_si128( (const __m128i*)( pSrc0 + x ) );
+    _mm_storeu_si128( (__m128i*)( pDst + x ), weightUnidirSSE2( vP0, vWeight, vAdd, vShift, vOffset, vMaxVal ) );
+  }
+  if ( x + 4 <= iWidth )
+  {
+    const __m128i vP0 = _mm_loadl_epi64( (const __m128i*)( pSrc0 + x ) );
+    _mm_storel_epi64( (__m128i*)( pDst + x ), weightUnidirSSE2( vP0, vWeight, vAdd, vShift, vOffset, vMaxVal ) );
+    x += 4;
+  }
+#endif
+
+  for ( ; x < iWidth; x++ )
+  {
+    pDst[x] = weightUnidir(w0, pSrc0[x], round, shift, offset, clipBD);
+  }
+}
+
 // ====================================================================================================================
 // Class definition
 // ====================================================================================================================
@@ -114,19 +205,7 @@ Void TComWeightPrediction::addWeightBi( const TComYuv              *pcYuvSrc0,
 
     for ( Int y = iHeight-1; y >= 0; y-- )
     {
-      // do it in batches of 4 (partial unroll)
-      Int x = iWidth-1;
-      for ( ; x >= 3; )
-      {
-        pDst[x] = weightBidir(w0,pSrc0[x], w1,pSrc1[x], round, shift, offset, clipBD); x--;
-        pDst[x] = weightBidir(w0,pSrc0[x], w1,pSrc1[x], round, shift, offset, clipBD); x--;
-        pDst[x] = weightBidir(w0,pSrc0[x], w1,pSrc1[x], round, shift, offset, clipBD); x--;
-        pDst[x] = weightBidir(w0,pSrc0[x], w1,pSrc1[x], round, shift, offset, clipBD); x--;
-      }
-      for( ; x >= 0; x-- )
-      {
-        pDst[x] = weightBidir(w0,pSrc0[x], w1,pSrc1[x], round, shift, offset, clipBD);
-      }
+      weightBidirRow(pSrc0, pSrc1, pDst, iWidth, w0, w1, round, shift, offset, clipBD);
 
       pSrc0 += iSrc0Stride;
       pSrc1 += iSrc1Stride;
@@ -177,18 +256,7 @@ Void TComWeightPrediction::addWeightUni( const TComYuv        *const pcYuvSrc0,
 
     for (Int y = iHeight-1; y >= 0; y-- )
     {
-      Int x = iWidth-1;
-      for ( ; x >= 3; )
-      {
-        pDst[x] = weightUnidir(w0, pSrc0[x], round, shift, offset, clipBD); x--;
-        pDst[x] = weightUnidir(w0, pSrc0[x], round, shift, offset, clipBD); x--;
-        pDst[x] = weightUnidir(w0, pSrc0[x], round, shift, offset, clipBD); x--;
-        pDst[x] = weightUnidir(w0, pSrc0[x], round, shift, offset, clipBD); x--;
-      }
-      for( ; x >= 0; x--)
-      {
-        pDst[x] = weightUnidir(w0, pSrc0[x], round, shift, offset, clipBD);
-      }
+      weightUnidirRow(pSrc0, pDst, iWidth, w0, round, shift, offset, clipBD);
       pSrc0 += iSrc0Stride;
       pDst  += iDstStride;
     }
@@ -45,32 +45,322 @@
 #include "TComYuv.h"
 #include "TComInterpolationFilter.h"
 
+#if SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
 //! \ingroup TLibCommon
 //! \{
 
+// ====================================================================================================================
+// Local functions
+// ====================================================================================================================
+
+#if SIMD_SSE2 && !RExt__HIGH_BIT_DEPTH_SUPPORT
+/** ClipBD( (src0 + src1 + offset) >> shift ) of eight pairs of intermediate-precision samples
+ */
+static inline __m128i xAvgSSE2( __m128i vSrc0, __m128i vSrc1, __m128i vOffset, __m128i vShift, __m128i vMaxVal )
+{
+  const __m128i vOne = _mm_set1_epi16( 1 );
+  const __m128i vLo  = _mm_sra_epi32( _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( vSrc0, vSrc1 ), vOne ), vOffset ), vShift );
+  const __m128i vHi  = _mm_sra_epi32( _mm_add_epi32( _mm_madd_epi16( _mm_unpackhi_epi16( vSrc0, vSrc1 ), vOne ), vOffset ), vShift );
+  return _mm_min_epi16( _mm_max_epi16( _mm_packs_epi32( vLo, vHi ), _mm_setzero_si128() ), vMaxVal );
+}
+#endif
+
+/** Rounded average of two rows of intermediate-precision samples
+ * \param pSrc0    first source row
+ * \param pSrc1    second source row
+ * \param pDst     destination row
+ * \param iWidth   number of samples
+ * \param iOffset  rounding offset, including the removal of the two intermediate offsets
+ * \param iShift   right shift back to the output bit depth
+ * \param iClipBD  output bit depth
+ */
+static inline Void xAddAvgRow( const Pel* pSrc0, const Pel* pSrc1, Pel* pDst, Int iWidth, Int iOffset, Int iShift, Int iClipBD )
+{
+  Int x = 0;
+
+#if SIMD_SSE2 && !RExt__HIGH_BIT_DEPTH_SUPPORT
+  const __m128i vOffset = _mm_set1_epi32( iOffset );
+  const __m128i vShift  = _mm_cvtsi32_si128( iShift );
+  const __m128i vMaxVal = _mm_set1_epi16( Short( ( 1 << iClipBD ) - 1 ) );
+
+  for ( ; x + 8 <= iWidth; x += 8 )
+  {
+    const __m128i vSrc0 = _mm_loadu_si128( (const __m128i*)( pSrc0 + x ) );
+    const __m128i vSrc1 = _mm_loadu_si128( (const __m128i*)( pSrc1 + x ) );
+    _mm_storeu_si128( (__m128i*)( pDst + x ), xAvgSSE2( vSrc0, vSrc1, vOffset, vShift, vMaxVal ) );
+  }
+  if ( x + 4 <= iWidth )
+  {
+    const __m128i vSrc0 = _mm_loadl_epi64( (const __m128i*)( pSrc0 + x ) );
+    const __m128i vSrc1 = _mm_loadl_epi64( (const __m128i*)( pSrc1 + x ) );
+    _mm_storel_epi64( (__m128i*)( pDst + x ), xAvgSSE2( vSrc0, vSrc1, vOffset, vShift, vMaxVal ) );
+    x += 4;
+  }
+#endif
+
+  for ( ; x < iWidth; x++ )
+  {
+    pDst[x] = ClipBD( rightShift( ( pSrc0[x] + pSrc1[x] + iOffset ), iShift ), iClipBD );
+  }
+}
+
+/** Bi-prediction search target 2 * dst - src of one row, in place
+ * \param pSrc     prediction from the other list
+ * \param pDst     original samples, overwritten with the target
+ * \param iWidth   number of samples
+ * \param iMaxVal  upper clipping bound, or 0 to leave the target unclipped
+ */
+static inline Void xRemoveHighFreqRow( const Pel* pSrc, Pel* pDst, Int iWidth, Int iMaxVal )
+{
+  Int x = 0;
+
+#if SIMD_SSE2 && !RExt__HIGH_BIT_DEPTH_SUPPORT
+  const __m128i vZero   = _mm_setzero_si128();
+  const __m128i vMaxVal = _mm_set1_epi16( Short( iMaxVal ) );
+
+  for ( ; x + 8 <= iWidth; x += 8 )
+  {
+    const __m128i vDst = _mm_loadu_si128( (const __m128i*)( pDst + x ) );
+    __m128i       vRes = _mm_sub_epi16( _mm_add_epi16( vDst, vDst ), _mm_loadu_si128( (const __m128i*)( pSrc + x ) ) );
+    if ( iMaxVal )
+    {
+      vRes = _mm_min_epi16( _mm_max_epi16( vRes, vZero ), vMaxVal );
+    }
+    _mm_storeu_si128( (__m128i*)( pDst + x ), vRes );
+  }
+#endif
+
+  for ( ; x < iWidth; x++ )
+  {
+    const Int iRes = ( 2 * pDst[x] ) - pSrc[x];
+    pDst[x] = iMaxVal ? Clip3( 0, iMaxVal, iRes ) : iRes;
+  }
+}
+
+/** Difference of two rows
+ * \param pSrc0    minuend row
+ * \param pSrc1    subtrahend row
+ * \param pDst     destination row
+ * \param iWidth   number of samples
+ */
+static inline Void xSubtractRow( const Pel* pSrc0, const Pel* pSrc1, Pel* pDst, Int iWidth )
+{
+  Int x = 0;
+
+#if SIMD_SSE2 && !RExt__HIGH_BIT_DEPTH_SUPPORT
+  for ( ; x + 8 <= iWidth; x += 8 )
+  {
+    const __m128i vSrc0 = _mm_loadu_si128( (const __m128i*)( pSrc0 + x ) );
+    const __m128i vSrc1 = _mm_loadu_si128( (const __m128i*)( pSrc1 + x ) );
+    _mm_storeu_si128( (__m128i*)( pDst + x ), _mm_sub_epi16( vSrc0, vSrc1 ) );
+  }
+  if ( x + 4 <= iWidth )
+  {
+    const __m128i vSrc0 = _mm_loadl_epi64( (const __m128i*)( pSrc0 + x ) );
+    const __m128i vSrc1 = _mm_loadl_epi64( (const __m128i*)( pSrc1 + x ) );
+    _mm_storel_epi64( (__m128i*)( pDst + x ), _mm_sub_epi16( vSrc0, vSrc1 ) );
+    x += 4;
+  }
+#endif
+
+  for ( ; x < iWidth; x++ )
+  {
+    pDst[x] = pSrc0[x] - pSrc1[x];
+  }
+}
+
+/** Clipped sum of a prediction row and a residual row
+ * \param pSrc0    prediction row
+ * \param pSrc1    residual row
+ * \param pDst     destination row
+ * \param iWidth   number of samples
+ * \param iMaxVal  upper clipping bound
+ */
+static inline Void xAddClipRow( const Pel* pSrc0, const Pel* pSrc1, Pel* pDst, Int iWidth, Int iMaxVal )
+{
+  Int x = 0;
+
+#if SIMD_SSE2 && !RExt__HIGH_BIT_DEPTH_SUPPORT
+  // saturating the sum to 16 bits does not change the clipped result
+  const __m128i vZero   = _mm_setzero_si128();
+  const __m128i vMaxVal = _mm_set1_epi16( Short( iMaxVal ) );
+
+  for ( ; x + 8 <= iWidth; x += 8 )
+  {
+    const __m128i vSum = _mm_adds_epi16( _mm_loadu_si128( (const __m128i*)( pSrc0 + x ) ), _mm_loadu_si128( (const __m128i*)( pSrc1 + x ) ) );
+    _mm_storeu_si128( (__m128i*)( pDst + x ), _mm_min_epi16( _mm_max_epi16( vSum, vZero ), vMaxVal ) );
+  }
+  if ( x + 4 <= iWidth )
+  {
+    const __m128i vSum = _mm_adds_epi16( _mm_loadl_epi64( (const __m128i*)( pSrc0 + x ) ), _mm_loadl_epi64( (const __m128i*)( pSrc1 + x ) ) );
+    _mm_storel_epi64( (__m128i*)( pDst + x ), _mm_min_epi16( _mm_max_epi16( vSum, vZero ), vMaxVal ) );
+    x += 4;
+  }
+#endif
+
+  for ( ; x < iWidth; x++ )
+  {
+    pDst[x] = Pel( Clip3<Int>( 0, iMaxVal, Int( pSrc0[x] ) + Int( pSrc1[x] ) ) );
+  }
+}
+
+/*
+ * xProcessBlock() applies one of the row kernels above to a block. It is instantiated for the usual block widths,
+ * so that the row loops of the small blocks are fully unrolled by the compiler. The row operations are small
+ * functors that carry the parameters of their kernel.
+ */
+
+/// dst = src0 - src1
+struct SubtractRowOp
+{
+  Void operator() ( const Pel* pSrc0, const Pel* pSrc1, Pel* pDst, Int iWidth ) const { xSubtractRow( pSrc0, pSrc1, pDst, iWidth ); }
+};
+
+/// dst = ClipBD( src0 + src1 )
+struct AddClipRowOp
+{
+  AddClipRowOp( Int iClipBD ) : m_iMaxVal( ( 1 << iClipBD ) - 1 ) {}
+
+  Void operator() ( const Pel* pSrc0, const Pel* pSrc1, Pel* pDst, Int iWidth ) const { xAddClipRow( pSrc0, pSrc1, pDst, iWidth, m_iMaxVal ); }
+
+  Int m_iMaxVal;
+};
+
+/// dst = ClipBD( (src0 + src1 + offset) >> shift ), the rounded average of two intermediate-precision predictions
+struct AddAvgRowOp
+{
+  AddAvgRowOp( Int iOffset, Int iShift, Int iClipBD ) : m_iOffset( iOffset ), m_iShift( iShift ), m_iClipBD( iClipBD ) {}
+
+  Void operator() ( const Pel* pSrc0, const Pel* pSrc1, Pel* pDst, Int iWidth ) const { xAddAvgRow( pSrc0, pSrc1, pDst, iWidth, m_iOffset, m_iShift, m_iClipBD ); }
+
+  Int m_iOffset;
+  Int m_iShift;
+  Int m_iClipBD;
+};
+
+/** Apply a row operation to a block
+ * \param cRowOp      row operation
+ * \param pSrc0       first source block
+ * \param iSrc0Stride stride of the first source block
+ * \param pSrc1       second source block
+ * \param iSrc1Stride stride of the second source block
+ * \param pDst        destination block, which may be one of the source blocks
+ * \param iDstStride  stride of the destination block
+ * \param iWidth      block width, used when iBlkWidth is 0
+ * \param iHeight     block height
+ */
+template <Int iBlkWidth, class RowOp>
+static inline Void xProcessBlockW( const RowOp& cRowOp, const Pel* pSrc0, Int iSrc0Stride, const Pel* pSrc1, Int iSrc1Stride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight )
+{
+  const Int iW = iBlkWidth ? iBlkWidth : iWidth;
+
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    cRowOp( pSrc0, pSrc1, pDst, iW );
+    pSrc0 += iSrc0Stride;
+    pSrc1 += iSrc1Stride;
+    pDst  += iDstStride;
+  }
+}
+
+/// xProcessBlockW() with the width fixed at compile time for the usual block widths
+template <class RowOp>
+static Void xProcessBlock( const RowOp& cRowOp, const Pel* pSrc0, Int iSrc0Stride, const Pel* pSrc1, Int iSrc1Stride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight )
+{
+  switch ( iWidth )
+  {
+    case 4:  xProcessBlockW< 4>( cRowOp, pSrc0, iSrc0Stride, pSrc1, iSrc1Stride, pDst, iDstStride, iWidth, iHeight ); break;
+    case 8:  xProcessBlockW< 8>( cRowOp, pSrc0, iSrc0Stride, pSrc1, iSrc1Stride, pDst, iDstStride, iWidth, iHeight ); break;
+    case 16: xProcessBlockW<16>( cRowOp, pSrc0, iSrc0Stride, pSrc1, iSrc1Stride, pDst, iDstStride, iWidth, iHeight ); break;
+    case 32: xProcessBlockW<32>( cRowOp, pSrc0, iSrc0Stride, pSrc1, iSrc1Stride, pDst, iDstStride, iWidth, iHeight ); break;
+    case 64: xProcessBlockW<64>( cRowOp, pSrc0, iSrc0Stride, pSrc1, iSrc1Stride, pDst, iDstStride, iWidth, iHeight ); break;
+    default: xProcessBlockW< 0>( cRowOp, pSrc0, iSrc0Stride, pSrc1, iSrc1Stride, pDst, iDstStride, iWidth, iHeight ); break;
+  }
+}
+
+/// copy of a block, with the row length fixed at compile time when iBlkWidth is not 0
+template <Int iBlkWidth>
+static inline Void xCopyBlockW( const Pel* pSrc, Int iSrcStride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight )
+{
+  const size_t uiRowBytes = sizeof(Pel) * ( iBlkWidth ? iBlkWidth : iWidth );
+
+  for ( Int y = iHeight; y != 0; y-- )
+  {
+    ::memcpy( pDst, pSrc, uiRowBytes );
+    pSrc += iSrcStride;
+    pDst += iDstStride;
+  }
+}
+
+/// copy of a block, specialised for the usual block widths
+static Void xCopyBlock( const Pel* pSrc, Int iSrcStride, Pel* pDst, Int iDstStride, Int iWidth, Int iHeight )
+{
+  switch ( iWidth )
+  {
+    case 4:  xCopyBlockW< 4>( pSrc, iSrcStride, pDst, iDstStride, iWidth, iHeight ); break;
+    case 8:  xCopyBlockW< 8>( pSrc, iSrcStride, pDst, iDstStride, iWidth, iHeight ); break;
+    case 16: xCopyBlockW<16>( pSrc, iSrcStride, pDst, iDstStride, iWidth, iHeight ); break;
+    case 32: xCopyBlockW<32>( pSrc, iSrcStride, pDst, iDstStride, iWidth, iHeight ); break;
+    case 64: xCopyBlockW<64>( pSrc, iSrcStride, pDst, iDstStride, iWidth, iHeight ); break;
+    default: xCopyBlockW< 0>( pSrc, iSrcStride, pDst, iDstStride, iWidth, iHeight ); break;
+  }
+}
+
 TComYuv::TComYuv()
 {
   for(Int comp=0; comp<MAX_NUM_COMPONENT; comp++)
   {
     m_apiBuf[comp] = NULL;
   }
+  m_bExternalBuffer = false;
 }
 
 TComYuv::~TComYuv()
 {
 }
 
-Void TComYuv::create( UInt iWidth, UInt iHeight, ChromaFormat chromaFormatIDC )
+/// each plane of an external buffer starts on a 64-byte boundary
+static inline UInt getPlaneBufferSize( const UInt uiNumSamples )
+{
+  return (uiNumSamples * sizeof(Pel) + 63) & ~63;
+}
+
+UInt TComYuv::getBufferSize( const UInt iWidth, const UInt iHeight, const ChromaFormat chromaFormatIDC )
+{
+  UInt uiSize = 0;
+  for(Int ch=0; ch<MAX_NUM_COMPONENT; ch++)
+  {
+    const ComponentID compID = ComponentID(ch);
+    uiSize += getPlaneBufferSize( (iWidth >> ::getComponentScaleX(compID, chromaFormatIDC)) * (iHeight >> ::getComponentScaleY(compID, chromaFormatIDC)) );
+  }
+  return uiSize;
+}
+
+Void TComYuv::create( UInt iWidth, UInt iHeight, ChromaFormat chromaFormatIDC, Pel *pBuffer )
 {
   // set width and height
   m_iWidth   = iWidth;
   m_iHeight  = iHeight;
   m_chromaFormatIDC = chromaFormatIDC;
+  m_bExternalBuffer = (pBuffer != NULL);
 
+  UChar *pNext = (UChar*)pBuffer;
   for(Int ch=0; ch<MAX_NUM_COMPONENT; ch++)
   {
-    // memory allocation
-    m_apiBuf[ch]  = (Pel*)xMalloc( Pel, getWidth(ComponentID(ch))*getHeight(ComponentID(ch)) );
+    const UInt uiNumSamples = getWidth(ComponentID(ch))*getHeight(ComponentID(ch));
+    if (m_bExternalBuffer)
+    {
+      m_apiBuf[ch]  = (Pel*)pNext;
+      pNext        += getPlaneBufferSize(uiNumSamples);
+    }
+    else
+    {
+      // memory allocation
+      m_apiBuf[ch]  = (Pel*)xMalloc( Pel, uiNumSamples );
+    }
   }
 }
 
@@ -79,8 +369,10 @@ Void TComYuv::destroy()
   // memory free
   for(Int ch=0; ch<MAX_NUM_COMPONENT; ch++)
   {
-    if (m_apiBuf[ch]!=NULL) { xFree( m_apiBuf[ch] ); m_apiBuf[ch] = NULL; }
+    if (m_apiBuf[ch]!=NULL && !m_bExternalBuffer) { xFree( m_apiBuf[ch] ); }
+    m_apiBuf[ch] = NULL;
   }
+  m_bExternalBuffer = false;
 }
 
 Void TComYuv::clear()
@@ -112,12 +404,7 @@ Void TComYuv::copyToPicComponent  ( const ComponentID ch, TComPicYuv* pcPicYuvDs
   const UInt  iSrcStride  = getStride(ch);
   const UInt  iDstStride  = pcPicYuvDst->getStride(ch);
 
-  for ( Int y = iHeight; y != 0; y-- )
-  {
-    ::memcpy( pDst, pSrc, sizeof(Pel)*iWidth);
-    pDst += iDstStride;
-    pSrc += iSrcStride;
-  }
+  xCopyBlock( pSrc, iSrcStride, pDst, iDstStride, iWidth, iHeight );
 }
 
 
@@ -139,12 +426,7 @@ Void TComYuv::copyFromPicComponent  ( const ComponentID ch, const TComPicYuv* pc
   const Int  iWidth=getWidth(ch);
   const Int  iHeight=getHeight(ch);
 
-  for (Int y = iHeight; y != 0; y-- )
-  {
-    ::memcpy( pDst, pSrc, sizeof(Pel)*iWidth);
-    pDst += iDstStride;
-    pSrc += iSrcStride;
-  }
+  xCopyBlock( pSrc, iSrcStride, pDst, iDstStride, iWidth, iHeight );
 }
 
 
@@ -166,12 +448,7 @@ Void TComYuv::copyToPartComponent( const ComponentID ch, TComYuv* pcYuvDst, cons
   const Int  iWidth=getWidth(ch);
   const Int  iHeight=getHeight(ch);
 
-  for (Int y = iHeight; y != 0; y-- )
-  {
-    ::memcpy( pDst, pSrc, sizeof(Pel)*iWidth);
-    pDst += iDstStride;
-    pSrc += iSrcStride;
-  }
+  xCopyBlock( pSrc, iSrcStride, pDst, iDstStride, iWidth, iHeight );
 }
 
 
@@ -194,12 +471,7 @@ Void TComYuv::copyPartToComponent( const ComponentID ch, TComYuv* pcYuvDst, cons
   const UInt uiHeight = pcYuvDst->getHeight(ch);
   const UInt uiWidth = pcYuvDst->getWidth(ch);
 
-  for ( UInt y = uiHeight; y != 0; y-- )
-  {
-    ::memcpy( pDst, pSrc, sizeof(Pel)*uiWidth);
-    pDst += iDstStride;
-    pSrc += iSrcStride;
-  }
+  xCopyBlock( pSrc, iSrcStride, pDst, iDstStride, uiWidth, uiHeight );
 }
 
 
@@ -224,12 +496,7 @@ Void TComYuv::copyPartToPartComponent  ( const ComponentID ch, TComYuv* pcYuvDst
 
   const UInt  iSrcStride = getStride(ch);
   const UInt  iDstStride = pcYuvDst->getStride(ch);
-  for ( UInt y = iHeightComponent; y != 0; y-- )
-  {
-    ::memcpy( pDst, pSrc, iWidthComponent * sizeof(Pel) );
-    pSrc += iSrcStride;
-    pDst += iDstStride;
-  }
+  xCopyBlock( pSrc, iSrcStride, pDst, iDstStride, iWidthComponent, iHeightComponent );
 }
 
 
@@ -250,12 +517,7 @@ Void TComYuv::copyPartToPartComponentMxN  ( const ComponentID ch, TComYuv* pcYuv
   const UInt  iDstStride = pcYuvDst->getStride(ch);
   const UInt uiHeightComponent=rect.height;
   const UInt uiWidthComponent=rect.width;
-  for ( UInt y = uiHeightComponent; y != 0; y-- )
-  {
-    ::memcpy( pDst, pSrc, uiWidthComponent * sizeof( Pel ) );
-    pSrc += iSrcStride;
-    pDst += iDstStride;
-  }
+  xCopyBlock( pSrc, iSrcStride, pDst, iDstStride, uiWidthComponent, uiHeightComponent );
 }
 
 
@@ -279,22 +541,20 @@ Void TComYuv::addClip( const TComYuv* pcYuvSrc0, const TComYuv* pcYuvSrc1, const
     const Int clipbd = g_bitDepth[toChannelType(ch)];
 #if RExt__O0043_BEST_EFFORT_DECODING
     const Int bitDepthDelta = g_bitDepthInStream[toChannelType(ch)] - g_bitDepth[toChannelType(ch)];
-#endif
 
     for ( Int y = uiPartHeight-1; y >= 0; y-- )
     {
       for ( Int x = uiPartWidth-1; x >= 0; x-- )
       {
-#if RExt__O0043_BEST_EFFORT_DECODING
         pDst[x] = Pel(ClipBD<Int>( Int(pSrc0[x]) + rightShiftEvenRounding<Pel>(pSrc1[x], bitDepthDelta), clipbd));
-#else
-        pDst[x] = Pel(ClipBD<Int>( Int(pSrc0[x]) + Int(pSrc1[x]), clipbd));
-#endif
       }
       pSrc0 += iSrc0Stride;
       pSrc1 += iSrc1Stride;
       pDst  += iDstStride;
     }
+#else
+    xProcessBlock( AddClipRowOp( clipbd ), pSrc0, iSrc0Stride, pSrc1, iSrc1Stride, pDst, iDstStride, uiPartWidth, uiPartHeight );
+#endif
   }
 }
 
@@ -317,16 +577,7 @@ Void TComYuv::subtract( const TComYuv* pcYuvSrc0, const TComYuv* pcYuvSrc1, cons
     const Int  iSrc1Stride = pcYuvSrc1->getStride(ch);
     const Int  iDstStride  = getStride(ch);
 
-    for (Int y = uiPartHeight-1; y >= 0; y-- )
-    {
-      for (Int x = uiPartWidth-1; x >= 0; x-- )
-      {
-        pDst[x] = pSrc0[x] - pSrc1[x];
-      }
-      pSrc0 += iSrc0Stride;
-      pSrc1 += iSrc1Stride;
-      pDst  += iDstStride;
-    }
+    xProcessBlock( SubtractRowOp(), pSrc0, iSrc0Stride, pSrc1, iSrc1Stride, pDst, iDstStride, uiPartWidth, uiPartHeight );
   }
 }
 
@@ -357,36 +608,8 @@ Void TComYuv::addAvg( const TComYuv* pcYuvSrc0, const TComYuv* pcYuvSrc1, const
       assert(0);
       exit(-1);
     }
-    else if (iWidth&2)
-    {
-      for ( Int y = 0; y < iHeight; y++ )
-      {
-        for (Int x=0 ; x < iWidth; x+=2 )
-        {
-          pDst[ x + 0 ] = ClipBD( rightShift(( pSrc0[ x + 0 ] + pSrc1[ x + 0 ] + offset ), shiftNum), clipbd );
-          pDst[ x + 1 ] = ClipBD( rightShift(( pSrc0[ x + 1 ] + pSrc1[ x + 1 ] + offset ), shiftNum), clipbd );
-        }
-        pSrc0 += iSrc0Stride;
-        pSrc1 += iSrc1Stride;
-        pDst  += iDstStride;
-      }
-    }
-    else
-    {
-      for ( Int y = 0; y < iHeight; y++ )
-      {
-        for (Int x=0 ; x < iWidth; x+=4 )
-        {
-          pDst[ x + 0 ] = ClipBD( rightShift(( pSrc0[ x + 0 ] + pSrc1[ x + 0 ] + offset ), shiftNum), clipbd );
-          pDst[ x + 1 ] = ClipBD( rightShift(( pSrc0[ x + 1 ] + pSrc1[ x + 1 ] + offset ), shiftNum), clipbd );
-          pDst[ x + 2 ] = ClipBD( rightShift(( pSrc0[ x + 2 ] + pSrc1[ x + 2 ] + offset ), shiftNum), clipbd );
-          pDst[ x + 3 ] = ClipBD( rightShift(( pSrc0[ x + 3 ] + pSrc1[ x + 3 ] + offset ), shiftNum), clipbd );
-        }
-        pSrc0 += iSrc0Stride;
-        pSrc1 += iSrc1Stride;
-        pDst  += iDstStride;
-      }
-    }
+
+    xProcessBlock( AddAvgRowOp( offset, shiftNum, clipbd ), pSrc0, iSrc0Stride, pSrc1, iSrc1Stride, pDst, iDstStride, iWidth, iHeight );
   }
 }
 
@@ -395,8 +618,10 @@ Void TComYuv::removeHighFreq( const TComYuv* pcYuvSrc, const UInt uiPartIdx, con
   for(Int chan=0; chan<getNumberValidComponents(); chan++)
   {
     const ComponentID ch=ComponentID(chan);
-#if !DISABLING_CLIP_FOR_BIPREDME
-    const ChannelType chType=toChannelType(ch);
+#if DISABLING_CLIP_FOR_BIPREDME
+    const Int iMaxVal = 0;
+#else
+    const Int iMaxVal = ( 1 << g_bitDepth[toChannelType(ch)] ) - 1;
 #endif
 
     const Pel* pSrc  = pcYuvSrc->getAddr(ch, uiPartIdx);
@@ -409,14 +634,7 @@ Void TComYuv::removeHighFreq( const TComYuv* pcYuvSrc, const UInt uiPartIdx, con
 
     for ( Int y = iHeight-1; y >= 0; y-- )
     {
-      for ( Int x = iWidth-1; x >= 0; x-- )
-      {
-#if DISABLING_CLIP_FOR_BIPREDME
-        pDst[x ] = (2 * pDst[x]) - pSrc[x];
-#else
-        pDst[x ] = Clip((2 * pDst[x]) - pSrc[x], chType);
-#endif
-      }
+      xRemoveHighFreqRow( pSrc, pDst, iWidth, iMaxVal );
       pSrc += iSrcStride;
       pDst += iDstStride;
     }
@@ -61,6 +61,7 @@ private:
   // ------------------------------------------------------------------------------------------------------------------
 
   Pel*    m_apiBuf[MAX_NUM_COMPONENT];
+  Bool    m_bExternalBuffer;          ///< planes are carved from a buffer owned by the caller
 
   // ------------------------------------------------------------------------------------------------------------------
   //  Parameter for general YUV buffer usage
@@ -95,7 +96,8 @@ public:
   //  Memory management
   // ------------------------------------------------------------------------------------------------------------------
 
-  Void         create                     ( const UInt iWidth, const UInt iHeight, const ChromaFormat chromaFormatIDC );  ///< Create  YUV buffer
+  Void         create                     ( const UInt iWidth, const UInt iHeight, const ChromaFormat chromaFormatIDC, Pel *pBuffer = NULL );  ///< Create  YUV buffer, optionally in a buffer of getBufferSize() bytes
+  static UInt  getBufferSize              ( const UInt iWidth, const UInt iHeight, const ChromaFormat chromaFormatIDC );  ///< Bytes needed by create() for an external buffer
   Void         destroy                    ();                             ///< Destroy YUV buffer
   Void         clear                      ();                             ///< clear   YUV buffer
 
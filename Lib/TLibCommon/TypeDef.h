@@ -156,6 +156,8 @@
 
 #define FAST_BIT_EST                                      1   ///< G763: Table-based bit estimation for CABAC
 
+#define FAST_CABAC_DECODER                                1   ///< 1 = CABAC decoding engine with a 64-bit value window and bulk bypass decoding, 0 = byte-wise engine (both are bit-exact)
+
 #define MLS_GRP_NUM                                      64     ///< G644 : Max number of coefficient groups, max(16, 64)
 #define MLS_CG_LOG2_WIDTH                                 2
 #define MLS_CG_LOG2_HEIGHT                                2
@@ -262,6 +264,16 @@
 
 #define RExt__O0043_BEST_EFFORT_DECODING                                       0 ///< 0 (default) = disable code related to best effort decoding, 1 = enable code relating to best effort decoding [ decode-side only ].
 
+// This can be disabled by the makefile
+#ifndef ENABLE_SIMD_OPT
+#define ENABLE_SIMD_OPT                                                        1 ///< 1 (default) = use SSE2 intrinsics for selected kernels when the compiler targets SSE2 (results are identical to the C code), 0 = C code only
+#endif
+
+// This can be disabled by the makefile
+#ifndef ENABLE_WORKER_THREADS
+#define ENABLE_WORKER_THREADS                                                  1 ///< 1 (default) = allow optional processing stages to run on std::thread workers, 0 = always run them on the calling thread
+#endif
+
 //------------------------------------------------
 // Backwards-compatibility
 //------------------------------------------------
@@ -298,6 +310,12 @@
 
 #define RExt__PREDICTION_WEIGHTING_ANALYSIS_DC_PRECISION                       0 ///< Additional fixed bit precision used during encoder-side weighting prediction analysis. Currently only used when high_precision_prediction_weighting_flag is set, for backwards compatibility reasons.
 
+#if ENABLE_SIMD_OPT && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#define SIMD_SSE2                                                              1 ///< SSE2 code paths are compiled in
+#else
+#define SIMD_SSE2                                                              0
+#endif
+
 #define MAX_TIMECODE_SEI_SETS                                                  3 ///< Maximum number of time sets
 
 //------------------------------------------------
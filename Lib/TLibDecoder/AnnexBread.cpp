@@ -39,7 +39,9 @@
 
 #include <stdint.h>
 #include <cassert>
+#include <cstring>
 #include <vector>
+#include <algorithm>
 #include "AnnexBread.h"
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
 #include "TLibCommon/TComCodingStatistics.h"
@@ -50,6 +52,111 @@ using namespace std;
 //! \ingroup TLibDecoder
 //! \{
 
+/**
+ * Make at least numBytes unread bytes available in the buffer, if the
+ * input holds that many.  Unread bytes are moved to the start of the
+ * buffer before reading the next block; the buffer grows when it is
+ * too small to hold numBytes.
+ */
+Void InputByteStream::xFill(UInt numBytes)
+{
+  if (m_endOfInput)
+  {
+    return;
+  }
+
+  if (m_bufferPos > 0)
+  {
+    const UInt numUnread = m_bufferEnd - m_bufferPos;
+    memmove(&m_buffer[0], &m_buffer[m_bufferPos], numUnread);
+    m_bufferStreamPos += m_bufferPos;
+    m_bufferPos        = 0;
+    m_bufferEnd        = numUnread;
+  }
+
+  if (m_buffer.size() < numBytes || m_bufferEnd == m_buffer.size())
+  {
+    m_buffer.resize(std::max<size_t>(numBytes, m_buffer.size() * 2));
+  }
+
+  while (m_bufferEnd < numBytes && !m_endOfInput)
+  {
+    m_Input.read(reinterpret_cast<char*>(&m_buffer[m_bufferEnd]), m_buffer.size() - m_bufferEnd);
+    m_bufferEnd += UInt(m_Input.gcount());
+    if (!m_Input)
+    {
+      m_endOfInput = true;
+    }
+  }
+}
+
+/**
+ * Locate the end of the NAL unit that starts at the current position:
+ * returns the number of bytes up to (but not including) the next
+ * byte-aligned three-byte sequence 0x000000, 0x000001 or 0x000002, or
+ * the number of bytes remaining when no such sequence exists before
+ * the end of the input.  On return, all of these bytes are held in the
+ * buffer and can be extracted with readBlock().
+ */
+UInt InputByteStream::scanToStartCodePrefix()
+{
+  UInt numScanned = 0;
+  for (;;)
+  {
+    const UInt numAvailable = m_bufferEnd - m_bufferPos;
+    if (numAvailable >= 3)
+    {
+      const uint8_t* base = &m_buffer[m_bufferPos];
+      const uint8_t* end  = base + numAvailable - 2;
+      const uint8_t* p    = base + numScanned;
+      while (p < end)
+      {
+        p = static_cast<const uint8_t*>(memchr(p, 0, end - p));
+        if (p == NULL)
+        {
+          break;
+        }
+        if (p[1] == 0 && p[2] <= 2)
+        {
+          return UInt(p - base);
+        }
+        p++;
+      }
+      numScanned = numAvailable - 2;
+    }
+
+    if (m_endOfInput)
+    {
+      m_readPastEnd = true;
+      return numAvailable;
+    }
+    xFill(numAvailable + 1);
+  }
+}
+
+/**
+ * Move the read position to pos, an offset previously returned by
+ * getPosition().  The input stream is only repositioned when pos lies
+ * outside the buffered data.
+ */
+Void InputByteStream::setPosition(Int64 pos)
+{
+  if (pos >= m_bufferStreamPos && pos <= m_bufferStreamPos + m_bufferEnd)
+  {
+    m_bufferPos = UInt(pos - m_bufferStreamPos);
+  }
+  else
+  {
+    m_Input.clear();
+    m_Input.seekg(std::streampos(pos));
+    m_bufferStreamPos = pos;
+    m_bufferPos       = 0;
+    m_bufferEnd       = 0;
+    m_endOfInput      = false;
+  }
+  m_readPastEnd = false;
+}
+
 /**
  * Parse an AVC AnnexB Bytestream bs to extract a single nalUnit
  * while accumulating bytestream statistics into stats.
@@ -134,15 +241,11 @@ _byteStreamNALUnit(
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
   TComCodingStatistics::SStat &bodyStats=TComCodingStatistics::GetStatisticEP(STATS__NAL_UNIT_TOTAL_BODY);
 #endif
-  while (bs.eofBeforeNBytes(24/8) || bs.peekBytes(24/8) > 2)
-  {
+  const UInt numBytesInNALunit = bs.scanToStartCodePrefix();
+  bs.readBlock(nalUnit, numBytesInNALunit);
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
-    uint8_t thebyte=bs.readByte();bodyStats.bits+=8;bodyStats.count++;
-    nalUnit.push_back(thebyte);
-#else
-    nalUnit.push_back(bs.readByte());
+  bodyStats.bits += 8*numBytesInNALunit; bodyStats.count += numBytesInNALunit;
 #endif
-  }
 
   /* 5. When the current position in the byte stream is:
    *  - not at the end of the byte stream (as determined by unspecified means)
@@ -42,6 +42,7 @@
 #define __ANNEXBREAD__
 
 #include <stdint.h>
+#include <cassert>
 #include <istream>
 #include <vector>
 
@@ -55,19 +56,25 @@ class InputByteStream
 public:
   /**
    * Create a bytestream reader that will extract bytes from
-   * istream.
+   * istream.  The input is read in blocks into an internal buffer.
    *
    * NB, it isn't safe to access istream while in use by a
    * InputByteStream.
    *
-   * Side-effects: the exception mask of istream is set to eofbit
+   * Side-effects: the exception mask of istream is set to badbit
    */
   InputByteStream(std::istream& istream)
-  : m_NumFutureBytes(0)
-  , m_FutureBytes(0)
-  , m_Input(istream)
+  : m_Input(istream)
+  , m_buffer(INITIAL_BUFFER_SIZE)
+  , m_bufferPos(0)
+  , m_bufferEnd(0)
+  , m_bufferStreamPos(0)
+  , m_endOfInput(false)
+  , m_readPastEnd(false)
   {
-    istream.exceptions(std::istream::eofbit | std::istream::badbit);
+    istream.exceptions(std::istream::badbit);
+    const std::streampos streamPos = istream.tellg();
+    m_bufferStreamPos = (streamPos == std::streampos(-1)) ? 0 : Int64(streamPos);
   }
 
   /**
@@ -76,8 +83,13 @@ public:
    */
   Void reset()
   {
-    m_NumFutureBytes = 0;
-    m_FutureBytes = 0;
+    m_Input.clear();
+    const std::streampos streamPos = m_Input.tellg();
+    m_bufferStreamPos = (streamPos == std::streampos(-1)) ? 0 : Int64(streamPos);
+    m_bufferPos       = 0;
+    m_bufferEnd       = 0;
+    m_endOfInput      = false;
+    m_readPastEnd     = false;
   }
 
   /**
@@ -86,24 +98,15 @@ public:
    */
   Bool eofBeforeNBytes(UInt n)
   {
-    assert(n <= 4);
-    if (m_NumFutureBytes >= n)
+    if (m_bufferEnd - m_bufferPos >= n)
       return false;
 
-    n -= m_NumFutureBytes;
-    try
-    {
-      for (UInt i = 0; i < n; i++)
-      {
-        m_FutureBytes = (m_FutureBytes << 8) | m_Input.get();
-        m_NumFutureBytes++;
-      }
-    }
-    catch (...)
-    {
-      return true;
-    }
-    return false;
+    xFill(n);
+    if (m_bufferEnd - m_bufferPos >= n)
+      return false;
+
+    m_readPastEnd = true;
+    return true;
   }
 
   /**
@@ -120,8 +123,12 @@ public:
    */
   uint32_t peekBytes(UInt n)
   {
-    eofBeforeNBytes(n);
-    return m_FutureBytes >> 8*(m_NumFutureBytes - n);
+    assert(n <= 4);
+    const UInt numAvailable = eofBeforeNBytes(n) ? (m_bufferEnd - m_bufferPos) : n;
+    uint32_t val = 0;
+    for (UInt i = 0; i < n; i++)
+      val = (val << 8) | ((i < numAvailable) ? m_buffer[m_bufferPos + i] : 0);
+    return val;
   }
 
   /**
@@ -132,15 +139,11 @@ public:
    */
   uint8_t readByte()
   {
-    if (!m_NumFutureBytes)
+    if (eofBeforeNBytes(1))
     {
-      uint8_t byte = m_Input.get();
-      return byte;
+      throw std::ios_base::failure("end of bytestream");
     }
-    m_NumFutureBytes--;
-    uint8_t wanted_byte = m_FutureBytes >> 8*m_NumFutureBytes;
-    m_FutureBytes &= ~(0xff << 8*m_NumFutureBytes);
-    return wanted_byte;
+    return m_buffer[m_bufferPos++];
   }
 
   /**
@@ -156,14 +159,46 @@ public:
     return val;
   }
 
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
-  UInt GetNumBufferedBytes() const { return m_NumFutureBytes; }
-#endif
+  /**
+   * consume n bytes from the input, appending them to dst in one
+   * block.  The bytes must already have been located by
+   * scanToStartCodePrefix().
+   */
+  Void readBlock(std::vector<uint8_t>& dst, UInt n)
+  {
+    assert(m_bufferEnd - m_bufferPos >= n);
+    dst.insert(dst.end(), m_buffer.begin() + m_bufferPos, m_buffer.begin() + m_bufferPos + n);
+    m_bufferPos += n;
+  }
+
+  UInt scanToStartCodePrefix();
+
+  /**
+   * returns true once an attempt has been made to read beyond the
+   * end of the input (the equivalent of the istream fail state of
+   * an unbuffered reader)
+   */
+  Bool isEndOfStream() const { return m_readPastEnd; }
+
+  /**
+   * returns the position in the input of the next byte to be read
+   */
+  Int64 getPosition() const { return m_bufferStreamPos + m_bufferPos; }
+
+  Void  setPosition(Int64 pos);
 
 private:
-  UInt m_NumFutureBytes; /* number of valid bytes in m_FutureBytes */
-  uint32_t m_FutureBytes; /* bytes that have been peeked */
-  std::istream& m_Input; /* Input stream to read from */
+  Void xFill(UInt numBytes);
+
+  static const UInt INITIAL_BUFFER_SIZE = 1 << 16;
+
+  std::istream&        m_Input;           ///< input stream to read from
+  std::vector<uint8_t> m_buffer;          ///< block of input data
+  UInt                 m_bufferPos;       ///< index of the next unread byte in m_buffer
+  UInt                 m_bufferEnd;       ///< number of valid bytes in m_buffer
+  Int64                m_bufferStreamPos; ///< position in the input of m_buffer[0]
+  Bool                 m_endOfInput;      ///< the input stream has no more data
+  Bool                 m_readPastEnd;     ///< an attempt has been made to read beyond the end of the input
 };
 
 /**
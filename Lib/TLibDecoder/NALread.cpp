@@ -40,6 +40,7 @@
 #include <vector>
 #include <algorithm>
 #include <ostream>
+#include <cstring>
 
 #include "NALread.h"
 #include "TLibCommon/NAL.h"
@@ -54,42 +55,64 @@ using namespace std;
 //! \{
 static Void convertPayloadToRBSP(vector<uint8_t>& nalUnitBuf, TComInputBitstream *bitstream, Bool isVclNalUnit)
 {
-  UInt zeroCount = 0;
-  vector<uint8_t>::iterator it_read, it_write;
+  assert(!nalUnitBuf.empty());
+  const UInt size = UInt(nalUnitBuf.size());
+  uint8_t *buf = &nalUnitBuf[0];
+  assert(buf[size - 1] != 0x00);
+  UInt readPos   = 0; // first byte not yet copied to the output
+  UInt writePos  = 0;
+  UInt searchPos = 0;
 
-  UInt pos = 0;
   bitstream->clearEmulationPreventionByteLocation();
-  for (it_read = it_write = nalUnitBuf.begin(); it_read != nalUnitBuf.end(); it_read++, it_write++, pos++)
+  // locate each 0x0000 pair with memchr and copy the bytes between
+  // emulation prevention bytes as whole blocks
+  while (searchPos + 2 < size)
   {
-    assert(zeroCount < 2 || *it_read >= 0x03);
-    if (zeroCount == 2 && *it_read == 0x03)
+    const uint8_t *zero = static_cast<const uint8_t*>(memchr(buf + searchPos, 0x00, size - 2 - searchPos));
+    if (zero == NULL)
     {
-      bitstream->pushEmulationPreventionByteLocation( pos );
-      pos++;
-      it_read++;
-      zeroCount = 0;
+      break;
+    }
+    const UInt zeroPos = UInt(zero - buf);
+    searchPos = zeroPos + 1;
+    if (buf[zeroPos + 1] != 0x00)
+    {
+      continue;
+    }
+    assert(buf[zeroPos + 2] >= 0x03);
+    if (buf[zeroPos + 2] != 0x03)
+    {
+      continue;
+    }
+
+    const UInt epbPos = zeroPos + 2;
+    if (writePos != readPos)
+    {
+      memmove(buf + writePos, buf + readPos, epbPos - readPos);
+    }
+    writePos += epbPos - readPos;
+    readPos   = epbPos + 1;
+    searchPos = readPos;
+    bitstream->pushEmulationPreventionByteLocation( epbPos );
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
-      TComCodingStatistics::IncrementStatisticEP(STATS__EMULATION_PREVENTION_3_BYTES, 8, 0);
+    TComCodingStatistics::IncrementStatisticEP(STATS__EMULATION_PREVENTION_3_BYTES, 8, 0);
 #endif
-      if (it_read == nalUnitBuf.end())
-      {
-        break;
-      }
-      assert(*it_read <= 0x03);
-    }
-    zeroCount = (*it_read == 0x00) ? zeroCount+1 : 0;
-    *it_write = *it_read;
+    assert(readPos == size || buf[readPos] <= 0x03);
+  }
+  if (writePos != readPos)
+  {
+    memmove(buf + writePos, buf + readPos, size - readPos);
   }
-  assert(zeroCount == 0);
+  writePos += size - readPos;
 
   if (isVclNalUnit)
   {
     // Remove cabac_zero_word from payload if present
     Int n = 0;
 
-    while (it_write[-1] == 0x00)
+    while (writePos > 0 && buf[writePos - 1] == 0x00)
     {
-      it_write--;
+      writePos--;
       n++;
     }
 
@@ -99,7 +122,7 @@ static Void convertPayloadToRBSP(vector<uint8_t>& nalUnitBuf, TComInputBitstream
     }
   }
 
-  nalUnitBuf.resize(it_write - nalUnitBuf.begin());
+  nalUnitBuf.resize(writePos);
 }
 
 Void readNalUnitHeader(InputNALUnit& nalu)
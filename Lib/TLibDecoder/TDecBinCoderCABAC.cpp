@@ -65,6 +65,286 @@ TDecBinCABAC::uninit()
   m_pcTComBitstream = 0;
 }
 
+#if FAST_CABAC_DECODER
+//! position of the integer part of the value window; the 54 bits below it hold the buffered fraction bits
+static const Int CABAC_WINDOW_SHIFT = 54;
+
+//! renormalisation shift indexed by (range >> 3), covering both LPS and MPS sub-ranges
+static const UChar s_aucRenormTable[64] =
+{
+  6,  5,  4,  4,  3,  3,  3,  3,  2,  2,  2,  2,  2,  2,  2,  2,
+  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+};
+
+Void
+TDecBinCABAC::start()
+{
+  assert( m_pcTComBitstream->getNumBitsUntilByteAligned() == 0 );
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  TComCodingStatistics::UpdateCABACStat(STATS__CABAC_INITIALISATION, 512, 510, 0);
+#endif
+  m_uiRange     = 510;
+  m_uiValue     = 0;
+  m_bitsAvail   = -9; // the first 9 bits read form the integer part of the value
+  m_numPadBytes = 0;
+  xRefill();
+}
+
+Void
+TDecBinCABAC::finish()
+{
+  UInt lastByte;
+
+  m_pcTComBitstream->peekPreviousByte( lastByte );
+  // Check for proper stop/alignment pattern
+  assert( ((lastByte << (7 - m_bitsAvail)) & 0xff) == 0x80 );
+}
+
+/**
+ - Copy CABAC state.
+ .
+ \param pcTDecBinIf The source CABAC engine.
+ */
+Void
+TDecBinCABAC::copyState( TDecBinIf* pcTDecBinIf )
+{
+  TDecBinCABAC* pcTDecBinCABAC = pcTDecBinIf->getTDecBinCABAC();
+  m_uiRange     = pcTDecBinCABAC->m_uiRange;
+  m_uiValue     = pcTDecBinCABAC->m_uiValue;
+  m_bitsAvail   = pcTDecBinCABAC->m_bitsAvail;
+  m_numPadBytes = pcTDecBinCABAC->m_numPadBytes;
+}
+
+/** Fill the value window with as many whole bytes as fit below the valid fraction bits.
+ *  Past the end of the bitstream the window is padded with zero bytes, which are counted so that
+ *  decodeBinTrm can hand back only the bytes that were really read.
+ */
+Void TDecBinCABAC::xRefill()
+{
+  const UInt numBytes = UInt( CABAC_WINDOW_SHIFT - m_bitsAvail ) >> 3;
+  const UInt numRead  = std::min<UInt>( numBytes, m_pcTComBitstream->getNumBytesLeft() );
+
+  for ( UInt i = 0; i < numRead; i++ )
+  {
+    m_uiValue   |= UInt64( m_pcTComBitstream->readByte() ) << ( CABAC_WINDOW_SHIFT - 8 - m_bitsAvail );
+    m_bitsAvail += 8;
+  }
+
+  m_numPadBytes += numBytes - numRead;
+  m_bitsAvail   += ( numBytes - numRead ) << 3;
+}
+
+
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+Void TDecBinCABAC::decodeBin( UInt& ruiBin, ContextModel &rcCtxModel, const TComCodingStatisticsClassType &whichStat )
+#else
+Void TDecBinCABAC::decodeBin( UInt& ruiBin, ContextModel &rcCtxModel )
+#endif
+{
+#ifdef DEBUG_CABAC_BINS
+  const UInt startingRange = m_uiRange;
+#endif
+
+  const UInt   uiLPS       = TComCABACTables::sm_aucLPSTable[ rcCtxModel.getState() ][ ( m_uiRange >> 6 ) - 4 ];
+  const UInt   uiMPSRange  = m_uiRange - uiLPS;
+  const UInt64 scaledRange = UInt64( uiMPSRange ) << CABAC_WINDOW_SHIFT;
+  const UInt   isLPS       = ( m_uiValue >= scaledRange ) ? 1 : 0;
+
+  // both paths share the same update; the selects below compile to conditional moves
+  ruiBin     = rcCtxModel.getMps() ^ isLPS;
+  m_uiValue -= isLPS ? scaledRange : 0;
+  m_uiRange  = isLPS ? uiLPS : uiMPSRange;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  TComCodingStatistics::UpdateCABACStat(whichStat, uiMPSRange+uiLPS, m_uiRange, Int(ruiBin));
+#endif
+#if FAST_BIT_EST
+  rcCtxModel.update( ruiBin );
+#else
+  if ( isLPS )
+  {
+    rcCtxModel.updateLPS();
+  }
+  else
+  {
+    rcCtxModel.updateMPS();
+  }
+#endif
+
+  const Int numBits = s_aucRenormTable[ m_uiRange >> 3 ];
+  m_uiValue  <<= numBits;
+  m_uiRange  <<= numBits;
+  m_bitsAvail -= numBits;
+
+  if ( m_bitsAvail < 8 )
+  {
+    xRefill();
+  }
+
+#ifdef DEBUG_CABAC_BINS
+  if ((g_debugCounter + debugCabacBinWindow) >= debugCabacBinTargetLine)
+    std::cout << g_debugCounter << ": coding bin value " << ruiBin << ", range = [" << startingRange << "->" << m_uiRange << "]\n";
+
+  if (g_debugCounter >= debugCabacBinTargetLine)
+  {
+    Char breakPointThis;
+    breakPointThis = 7;
+  }
+  if (g_debugCounter >= (debugCabacBinTargetLine + debugCabacBinWindow)) exit(0);
+  g_debugCounter++;
+#endif
+}
+
+
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+Void TDecBinCABAC::decodeBinEP( UInt& ruiBin, const TComCodingStatisticsClassType &whichStat )
+#else
+Void TDecBinCABAC::decodeBinEP( UInt& ruiBin )
+#endif
+{
+  m_uiValue += m_uiValue;
+  m_bitsAvail--;
+
+  const UInt64 scaledRange = UInt64( m_uiRange ) << CABAC_WINDOW_SHIFT;
+  ruiBin     = ( m_uiValue >= scaledRange ) ? 1 : 0;
+  m_uiValue -= ruiBin ? scaledRange : 0;
+
+  if ( m_bitsAvail < 8 )
+  {
+    xRefill();
+  }
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  TComCodingStatistics::IncrementStatisticEP(whichStat, 1, Int(ruiBin));
+#endif
+}
+
+/** Decode up to 32 bypass bins in one step.
+ *  Decoding n bypass bins is equivalent to dividing the value, extended by the next n bits of the
+ *  bitstream, by the range: the quotient gives the bins and the remainder is the new value.
+ */
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+Void TDecBinCABAC::decodeBinsEP( UInt& ruiBin, Int numBins, const TComCodingStatisticsClassType &whichStat )
+#else
+Void TDecBinCABAC::decodeBinsEP( UInt& ruiBin, Int numBins )
+#endif
+{
+  if (m_uiRange == 256)
+  {
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+    decodeAlignedBinsEP(ruiBin, numBins, whichStat);
+#else
+    decodeAlignedBinsEP(ruiBin, numBins);
+#endif
+    return;
+  }
+
+  assert( numBins >= 0 && numBins <= 32 );
+  if ( m_bitsAvail < numBins )
+  {
+    xRefill();
+  }
+
+  const Int    shift    = CABAC_WINDOW_SHIFT - numBins;
+  const UInt64 extended = m_uiValue >> shift;
+  const UInt64 bins     = extended / m_uiRange;
+
+  m_uiValue    = ( ( extended - bins * m_uiRange ) << CABAC_WINDOW_SHIFT ) | ( ( m_uiValue & ( ( UInt64( 1 ) << shift ) - 1 ) ) << numBins );
+  m_bitsAvail -= numBins;
+  ruiBin       = UInt( bins );
+
+  if ( m_bitsAvail < 8 )
+  {
+    xRefill();
+  }
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  TComCodingStatistics::IncrementStatisticEP(whichStat, numBins, Int(ruiBin));
+#endif
+}
+
+Void TDecBinCABAC::align()
+{
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  TComCodingStatistics::UpdateCABACStat(STATS__CABAC_EP_BIT_ALIGNMENT, m_uiRange, 256, 0);
+#endif
+  m_uiRange = 256;
+}
+
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+Void TDecBinCABAC::decodeAlignedBinsEP( UInt& ruiBins, Int numBins, const class TComCodingStatisticsClassType &whichStat )
+#else
+Void TDecBinCABAC::decodeAlignedBinsEP( UInt& ruiBins, Int numBins )
+#endif
+{
+  assert(m_uiRange == 256); //aligned decode only works when range = 256
+  assert( numBins >= 0 && numBins <= 32 );
+
+  if ( m_bitsAvail < numBins )
+  {
+    xRefill();
+  }
+
+  // with a range of 256 the division by the range reduces to a shift: the bins are simply the
+  // next numBins bits of the bitstream, and the integer part keeps its top bit clear
+  const Int    shift    = CABAC_WINDOW_SHIFT - numBins;
+  const UInt64 extended = m_uiValue >> shift;
+
+  ruiBins      = UInt( extended >> 8 );
+  m_uiValue    = ( ( extended & 0xff ) << CABAC_WINDOW_SHIFT ) | ( ( m_uiValue & ( ( UInt64( 1 ) << shift ) - 1 ) ) << numBins );
+  m_bitsAvail -= numBins;
+
+  if ( m_bitsAvail < 8 )
+  {
+    xRefill();
+  }
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+  TComCodingStatistics::IncrementStatisticEP(whichStat, numBins, Int(ruiBins));
+#endif
+}
+
+Void
+TDecBinCABAC::decodeBinTrm( UInt& ruiBin )
+{
+  m_uiRange -= 2;
+  const UInt64 scaledRange = UInt64( m_uiRange ) << CABAC_WINDOW_SHIFT;
+  if( m_uiValue >= scaledRange )
+  {
+    ruiBin = 1;
+
+    // Terminating: hand the whole bytes still buffered in the window back to the bitstream, so that
+    // finish(), the trailing bits and PCM samples see the same read position as the byte-wise engine.
+    const UInt numBufferedBytes = UInt( m_bitsAvail ) >> 3;
+    assert( numBufferedBytes >= m_numPadBytes );
+    m_pcTComBitstream->rewindBytes( numBufferedBytes - m_numPadBytes );
+    m_bitsAvail  &= 7;
+    m_numPadBytes = 0;
+    m_uiValue    &= ~( ( UInt64( 1 ) << ( CABAC_WINDOW_SHIFT - m_bitsAvail ) ) - 1 );
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+    TComCodingStatistics::UpdateCABACStat(STATS__CABAC_TRM_BITS, m_uiRange+2, 2, ruiBin);
+    TComCodingStatistics::IncrementStatisticEP(STATS__BYTE_ALIGNMENT_BITS, m_bitsAvail + 1, 0);
+#endif
+  }
+  else
+  {
+    ruiBin = 0;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+    TComCodingStatistics::UpdateCABACStat(STATS__CABAC_TRM_BITS, m_uiRange+2, m_uiRange, ruiBin);
+#endif
+    if ( m_uiRange < 256 )
+    {
+      m_uiRange += m_uiRange;
+      m_uiValue += m_uiValue;
+
+      if ( --m_bitsAvail < 8 )
+      {
+        xRefill();
+      }
+    }
+  }
+}
+
+#else
+
 Void
 TDecBinCABAC::start()
 {
@@ -362,6 +642,8 @@ TDecBinCABAC::decodeBinTrm( UInt& ruiBin )
   }
 }
 
+#endif
+
 /** Read a PCM code.
  * \param uiLength code bit-depth
  * \param ruiCode pointer to PCM code value
@@ -78,10 +78,20 @@ public:
   TDecBinCABAC* getTDecBinCABAC()  { return this; }
 
 private:
+#if FAST_CABAC_DECODER
+  Void  xRefill           ();
+
+  TComInputBitstream* m_pcTComBitstream;
+  UInt                m_uiRange;
+  UInt64              m_uiValue;      ///< value window: 9 integer bits at bits 54..62, fraction bits below
+  Int                 m_bitsAvail;    ///< number of valid fraction bits held in m_uiValue
+  UInt                m_numPadBytes;  ///< zero bytes appended to the window past the end of the bitstream
+#else
   TComInputBitstream* m_pcTComBitstream;
   UInt                m_uiRange;
   UInt                m_uiValue;
   Int                 m_bitsNeeded;
+#endif
 };
 
 //! \}
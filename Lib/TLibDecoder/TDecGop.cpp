@@ -49,7 +49,7 @@ extern Bool g_md5_mismatch; ///< top level flag to signal when there is a decode
 
 //! \ingroup TLibDecoder
 //! \{
-static Void calcAndPrintHashStatus(TComPicYuv& pic, const SEIDecodedPictureHash* pictureHashSEI);
+static Void calcAndPrintHashStatus(TComPicYuv& pic, const SEIDecodedPictureHash* pictureHashSEI, Bool bParallelPlanes);
 // ====================================================================================================================
 // Constructor / destructor / initialization / destroy
 // ====================================================================================================================
@@ -57,6 +57,8 @@ static Void calcAndPrintHashStatus(TComPicYuv& pic, const SEIDecodedPictureHash*
 TDecGop::TDecGop()
 {
   m_dDecTime = 0;
+  m_decodedPictureHashSEIEnabled = 0;
+  m_bParallelPictureHash = false;
   m_pcSbacDecoders = NULL;
   m_pcBinCABACs = NULL;
 }
@@ -169,8 +171,12 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
   if( pcSlice->getSPS()->getUseSAO() )
   {
     m_pcSAO->reconstructBlkSAOParams(rpcPic, rpcPic->getPicSym()->getSAOBlkParam());
-    m_pcSAO->SAOProcess(rpcPic);
-    m_pcSAO->PCMLFDisableProcess(rpcPic);
+    m_pcSAO->SAOProcessCtuRows(rpcPic);
+  }
+  else
+  {
+    rpcPic->getPicYuvRec()->setBorderExtension(false);
+    rpcPic->getPicYuvRec()->extendPicBorder();
   }
 
   rpcPic->compressMotion();
@@ -204,7 +210,7 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
     {
       printf ("Warning: Got multiple decoded picture hash SEI messages. Using first.");
     }
-    calcAndPrintHashStatus(*rpcPic->getPicYuvRec(), hash);
+    calcAndPrintHashStatus(*rpcPic->getPicYuvRec(), hash, m_bParallelPictureHash);
   }
 
   printf("\n");
@@ -228,7 +234,7 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
  *            ***ERROR*** - calculated hash does not match the SEI message
  *            unk         - no SEI message was available for comparison
  */
-static Void calcAndPrintHashStatus(TComPicYuv& pic, const SEIDecodedPictureHash* pictureHashSEI)
+static Void calcAndPrintHashStatus(TComPicYuv& pic, const SEIDecodedPictureHash* pictureHashSEI, Bool bParallelPlanes)
 {
   /* calculate MD5sum for entire reconstructed picture */
   TComDigest recon_digest;
@@ -242,19 +248,19 @@ static Void calcAndPrintHashStatus(TComPicYuv& pic, const SEIDecodedPictureHash*
       case SEIDecodedPictureHash::MD5:
         {
           hashType = "MD5";
-          numChar = calcMD5(pic, recon_digest);
+          numChar = calcMD5(pic, recon_digest, bParallelPlanes);
           break;
         }
       case SEIDecodedPictureHash::CRC:
         {
           hashType = "CRC";
-          numChar = calcCRC(pic, recon_digest);
+          numChar = calcCRC(pic, recon_digest, bParallelPlanes);
           break;
         }
       case SEIDecodedPictureHash::CHECKSUM:
         {
           hashType = "Checksum";
-          numChar = calcChecksum(pic, recon_digest);
+          numChar = calcChecksum(pic, recon_digest, bParallelPlanes);
           break;
         }
       default:
@@ -81,6 +81,7 @@ private:
   TComSampleAdaptiveOffset*     m_pcSAO;
   Double                m_dDecTime;
   Int                   m_decodedPictureHashSEIEnabled;  ///< Checksum(3)/CRC(2)/MD5(1)/disable(0) acting on decoded picture hash SEI message
+  Bool                  m_bParallelPictureHash;          ///< hash the colour planes of each picture concurrently
 
 public:
   TDecGop();
@@ -100,6 +101,7 @@ public:
   Void  filterPicture  (TComPic*& rpcPic );
 
   Void setDecodedPictureHashSEIEnabled(Int enabled) { m_decodedPictureHashSEIEnabled = enabled; }
+  Void setParallelPictureHash(Bool b)               { m_bParallelPictureHash = b; }
 
 };
 
@@ -1380,18 +1380,26 @@ Void TDecSbac::parseCoeffNxN(  TComTU &rTu, ComponentID compID )
   UInt uiPosLastX, uiPosLastY;
   parseLastSignificantXY( uiPosLastX, uiPosLastY, uiWidth, uiHeight, compID, codingParameters.scanType );
   UInt uiBlkPosLast      = uiPosLastX + (uiPosLastY<<uiLog2BlockWidth);
-  pcCoef[ uiBlkPosLast ] = 1;
 
-  //===== decode significance flags =====
-  UInt uiScanPosLast;
-  for( uiScanPosLast = 0; uiScanPosLast < uiMaxNumCoeffM1; uiScanPosLast++ )
+  //===== locate the last significant coefficient in scan order =====
+  // search the group scan and the 4x4 scan within the group rather than the whole block scan
+  const UInt  uiCGBlkPosLast  = (uiPosLastX >> MLS_CG_LOG2_WIDTH) + ((uiPosLastY >> MLS_CG_LOG2_HEIGHT) * codingParameters.widthInGroups);
+  const UInt  uiPosInCGLast   = (uiPosLastX & ((1 << MLS_CG_LOG2_WIDTH) - 1)) + ((uiPosLastY & ((1 << MLS_CG_LOG2_HEIGHT) - 1)) << MLS_CG_LOG2_WIDTH);
+  const UInt *scanInCG        = g_scanOrder[ SCAN_UNGROUPED ][ codingParameters.scanType ][ MLS_CG_LOG2_WIDTH ][ MLS_CG_LOG2_HEIGHT ];
+  UInt uiCGScanPosLast = 0;
+  while( codingParameters.scanCG[ uiCGScanPosLast ] != uiCGBlkPosLast )
   {
-    UInt uiBlkPos = codingParameters.scan[ uiScanPosLast ];
-    if( uiBlkPosLast == uiBlkPos )
-    {
-      break;
-    }
+    uiCGScanPosLast++;
+  }
+  UInt uiScanPosInCGLast = 0;
+  while( scanInCG[ uiScanPosInCGLast ] != uiPosInCGLast )
+  {
+    uiScanPosInCGLast++;
   }
+  const UInt uiScanPosLast = (uiCGScanPosLast << MLS_CG_SIZE) + uiScanPosInCGLast;
+  assert( uiScanPosLast <= uiMaxNumCoeffM1 && codingParameters.scan[ uiScanPosLast ] == uiBlkPosLast );
+
+  //===== decode significance flags =====
 
   ContextModel * const baseCoeffGroupCtx = m_cCUSigCoeffGroupSCModel.get( 0, isChroma(chType) );
   ContextModel * const baseCtx = m_cCUSigSCModel.get( 0, 0 ) + getSignificanceMapContextOffset(compID);
@@ -1446,38 +1454,47 @@ Void TDecSbac::parseCoeffNxN(  TComTU &rTu, ComponentID compID )
     }
 
     // decode significant_coeff_flag
-    const Int patternSigCtx = TComTrQuant::calcPatternSigCtx(uiSigCoeffGroupFlag, iCGPosX, iCGPosY, codingParameters.widthInGroups, codingParameters.heightInGroups);
-
-    UInt uiBlkPos, uiSig, uiCtxSig;
-    for( ; iScanPosSig >= iSubPos; iScanPosSig-- )
+    // the coefficient buffer is cleared when the CTU is initialised, so only the non-zero levels are written below
+    if( uiSigCoeffGroupFlag[ iCGBlkPos ] )
     {
-      uiBlkPos  = codingParameters.scan[ iScanPosSig ];
-      uiSig     = 0;
+      const Int patternSigCtx = TComTrQuant::calcPatternSigCtx(uiSigCoeffGroupFlag, iCGPosX, iCGPosY, codingParameters.widthInGroups, codingParameters.heightInGroups);
+
+      UChar auiCtxSigInCG[ 1 << MLS_CG_SIZE ];
+      TComTrQuant::getSigCtxIncGroup( patternSigCtx, codingParameters, iCGPosX, iCGPosY, uiLog2BlockWidth, uiLog2BlockHeight, chType, auiCtxSigInCG );
 
-      if( uiSigCoeffGroupFlag[ iCGBlkPos ] )
+      UInt uiBlkPos, uiSig;
+      for( ; iScanPosSig >= iSubPos; iScanPosSig-- )
       {
+        uiBlkPos  = codingParameters.scan[ iScanPosSig ];
+
         if( iScanPosSig > iSubPos || iSubSet == 0  || numNonZero )
         {
-          uiCtxSig  = TComTrQuant::getSigCtxInc( patternSigCtx, codingParameters, iScanPosSig, uiLog2BlockWidth, uiLog2BlockHeight, chType );
+          const UInt uiPosY = uiBlkPos >> uiLog2BlockWidth;
+          const UInt uiPosX = uiBlkPos - (uiPosY << uiLog2BlockWidth);
+          const UInt uiCtxSig = auiCtxSigInCG[ (uiPosX & ((1 << MLS_CG_LOG2_WIDTH) - 1)) + ((uiPosY & ((1 << MLS_CG_LOG2_HEIGHT) - 1)) << MLS_CG_LOG2_WIDTH) ];
           m_pcTDecBinIf->decodeBin( uiSig, baseCtx[ uiCtxSig ] RExt__DECODER_DEBUG_BIT_STATISTICS_PASS_OPT_ARG(ctype_map) );
         }
         else
         {
           uiSig = 1;
         }
-      }
-      pcCoef[ uiBlkPos ] = uiSig;
-      if( uiSig )
-      {
-        pos[ numNonZero ] = uiBlkPos;
-        numNonZero ++;
-        if( lastNZPosInCG == -1 )
+
+        if( uiSig )
         {
-          lastNZPosInCG = iScanPosSig;
+          pos[ numNonZero ] = uiBlkPos;
+          numNonZero ++;
+          if( lastNZPosInCG == -1 )
+          {
+            lastNZPosInCG = iScanPosSig;
+          }
+          firstNZPosInCG = iScanPosSig;
         }
-        firstNZPosInCG = iScanPosSig;
       }
     }
+    else
+    {
+      iScanPosSig = iSubPos - 1;
+    }
 
     if( numNonZero > 0 )
     {
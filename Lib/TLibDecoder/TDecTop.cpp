@@ -56,6 +56,9 @@ TDecTop::TDecTop()
   }
   g_bJustDoIt = g_bEncDecTraceDisable;
   g_nSymbolCounter = 0;
+#endif
+#if FAST_BIT_EST
+  ContextModel::buildNextStateTable();
 #endif
   m_associatedIRAPType = NAL_UNIT_INVALID;
   m_pocCRA = 0;
@@ -122,6 +125,14 @@ Void TDecTop::deletePicBuffer ( )
     delete pcPic;
     pcPic = NULL;
   }
+  m_cListPic.clear();
+
+  for (iterPic = m_cListFreePic.begin(); iterPic != m_cListFreePic.end(); iterPic++)
+  {
+    (*iterPic)->destroy();
+    delete *iterPic;
+  }
+  m_cListFreePic.clear();
 
   m_cSAO.destroy();
 
@@ -131,6 +142,68 @@ Void TDecTop::deletePicBuffer ( )
   destroyROM();
 }
 
+/** Hand a picture that has been removed from the picture list back to the decoder. The picture is kept,
+ *  with its allocations, for reuse by a later xGetNewPicBuffer() call.
+ */
+Void TDecTop::releasePicBuffer( TComPic* pcPic )
+{
+  m_cListFreePic.pushBack( pcPic );
+}
+
+/** Prepare pcPic for a new picture: when its buffers already match the dimensions of the active SPS, only
+ *  the picture metadata is reset; otherwise the picture is reallocated.
+ */
+Void TDecTop::xInitPicBuffer( TComPic* pcPic, TComSlice* pcSlice, Window &conformanceWindow, Window &defaultDisplayWindow, Int *numReorderPics )
+{
+  TComSPS *sps = pcSlice->getSPS();
+  if (pcPic->isCompatible( sps->getPicWidthInLumaSamples(), sps->getPicHeightInLumaSamples(), sps->getChromaFormatIdc(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth ))
+  {
+    pcPic->reinit( conformanceWindow, defaultDisplayWindow, numReorderPics );
+  }
+  else
+  {
+    pcPic->destroy();
+    pcPic->create ( sps->getPicWidthInLumaSamples(), sps->getPicHeightInLumaSamples(), sps->getChromaFormatIdc(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth,
+                    conformanceWindow, defaultDisplayWindow, numReorderPics, true);
+  }
+}
+
+/** Take a picture from the pool of free pictures, allocating a new one if the pool is empty. On first use
+ *  for a given SPS, the pool is filled up to the DPB size of the highest temporal layer, so that all picture
+ *  buffers are allocated up front rather than while decoding.
+ */
+TComPic* TDecTop::xGetPicFromPool( TComSlice* pcSlice, Window &conformanceWindow, Window &defaultDisplayWindow, Int *numReorderPics )
+{
+  TComSPS *sps = pcSlice->getSPS();
+  const UInt uiMaxDecPicBuffering = sps->getMaxDecPicBuffering(sps->getMaxTLayers()-1);
+  while (m_cListPic.size() + m_cListFreePic.size() < uiMaxDecPicBuffering)
+  {
+    TComPic *pcPic = new TComPic();
+    pcPic->create ( sps->getPicWidthInLumaSamples(), sps->getPicHeightInLumaSamples(), sps->getChromaFormatIdc(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth,
+                    conformanceWindow, defaultDisplayWindow, numReorderPics, true);
+    m_cListFreePic.pushBack( pcPic );
+  }
+
+  if (m_cListFreePic.empty())
+  {
+    TComPic *pcPic = new TComPic();
+    pcPic->create ( sps->getPicWidthInLumaSamples(), sps->getPicHeightInLumaSamples(), sps->getChromaFormatIdc(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth,
+                    conformanceWindow, defaultDisplayWindow, numReorderPics, true);
+    return pcPic;
+  }
+
+  TComPic *pcPic = m_cListFreePic.popFront();
+  xInitPicBuffer( pcPic, pcSlice, conformanceWindow, defaultDisplayWindow, numReorderPics );
+
+  // a released picture may still carry the state of its previous use
+  pcPic->setReconMark( false );
+  pcPic->setOutputMark( false );
+  pcPic->setIsLongTerm( false );
+  pcPic->setCheckLTMSBPresent( false );
+  pcPic->setTLayer( 0 );
+  return pcPic;
+}
+
 Void TDecTop::xGetNewPicBuffer ( TComSlice* pcSlice, TComPic*& rpcPic )
 {
   Int  numReorderPics[MAX_TLAYER];
@@ -145,11 +218,7 @@ Void TDecTop::xGetNewPicBuffer ( TComSlice* pcSlice, TComPic*& rpcPic )
   m_iMaxRefPicNum = pcSlice->getSPS()->getMaxDecPicBuffering(pcSlice->getTLayer());     // m_uiMaxDecPicBuffering has the space for the picture currently being decoded
   if (m_cListPic.size() < (UInt)m_iMaxRefPicNum)
   {
-    rpcPic = new TComPic();
-
-    rpcPic->create ( pcSlice->getSPS()->getPicWidthInLumaSamples(), pcSlice->getSPS()->getPicHeightInLumaSamples(), pcSlice->getSPS()->getChromaFormatIdc(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth,
-                     conformanceWindow, defaultDisplayWindow, numReorderPics, true);
-
+    rpcPic = xGetPicFromPool( pcSlice, conformanceWindow, defaultDisplayWindow, numReorderPics );
     m_cListPic.pushBack( rpcPic );
 
     return;
@@ -181,12 +250,11 @@ Void TDecTop::xGetNewPicBuffer ( TComSlice* pcSlice, TComPic*& rpcPic )
   {
     //There is no room for this picture, either because of faulty encoder or dropped NAL. Extend the buffer.
     m_iMaxRefPicNum++;
-    rpcPic = new TComPic();
+    rpcPic = xGetPicFromPool( pcSlice, conformanceWindow, defaultDisplayWindow, numReorderPics );
     m_cListPic.pushBack( rpcPic );
+    return;
   }
-  rpcPic->destroy();
-  rpcPic->create ( pcSlice->getSPS()->getPicWidthInLumaSamples(), pcSlice->getSPS()->getPicHeightInLumaSamples(), pcSlice->getSPS()->getChromaFormatIdc(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth,
-                   conformanceWindow, defaultDisplayWindow, numReorderPics, true);
+  xInitPicBuffer( rpcPic, pcSlice, conformanceWindow, defaultDisplayWindow, numReorderPics );
 }
 
 Void TDecTop::executeLoopFilters(Int& poc, TComList<TComPic*>*& rpcListPic)
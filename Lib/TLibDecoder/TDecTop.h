@@ -71,6 +71,7 @@ private:
   Int                     m_pocRandomAccess;   ///< POC number of the random access point (the first IDR or CRA picture)
 
   TComList<TComPic*>      m_cListPic;         //  Dynamic buffer
+  TComList<TComPic*>      m_cListFreePic;     ///< allocated pictures released from the DPB, kept for reuse
   ParameterSetManagerDecoder m_parameterSetManagerDecoder;  // storage for parameter sets
   TComSlice*              m_apcSlicePilot;
 
@@ -118,10 +119,12 @@ public:
   Void  destroy ();
 
   Void setDecodedPictureHashSEIEnabled(Int enabled) { m_cGopDecoder.setDecodedPictureHashSEIEnabled(enabled); }
+  Void setParallelPictureHash(Bool b)               { m_cGopDecoder.setParallelPictureHash(b); }
 
   Void  init();
   Bool  decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay);
   Void  deletePicBuffer();
+  Void  releasePicBuffer( TComPic* pcPic );
 
   
   TComSPS* getActiveSPS() { return m_parameterSetManagerDecoder.getActiveSPS(); }
@@ -146,6 +149,8 @@ public:
 
 protected:
   Void  xGetNewPicBuffer  (TComSlice* pcSlice, TComPic*& rpcPic);
+  TComPic* xGetPicFromPool (TComSlice* pcSlice, Window &conformanceWindow, Window &defaultDisplayWindow, Int *numReorderPics);
+  Void  xInitPicBuffer    (TComPic* pcPic, TComSlice* pcSlice, Window &conformanceWindow, Window &defaultDisplayWindow, Int *numReorderPics);
   Void  xCreateLostPicture (Int iLostPOC);
 
   Void      xActivateParameterSets();
@@ -65,24 +65,30 @@ private:
   UInt      m_uiNumPic;
   Double    m_dFrmRate; //--CFG_KDY
   Double    m_MSEyuvframe[MAX_NUM_COMPONENT]; // sum of MSEs
+  Double    m_dSSIMSum[MAX_NUM_COMPONENT];    // sum of SSIMs, only accumulated when they are calculated
 
 public:
   virtual ~TEncAnalyze()  {}
   TEncAnalyze() { clear(); }
 
-  Void  addResult( Double psnr[MAX_NUM_COMPONENT], Double bits, const Double MSEyuvframe[MAX_NUM_COMPONENT])
+  Void  addResult( Double psnr[MAX_NUM_COMPONENT], Double bits, const Double MSEyuvframe[MAX_NUM_COMPONENT], const Double* ssim = NULL)
   {
     m_dAddBits  += bits;
     for(UInt i=0; i<MAX_NUM_COMPONENT; i++)
     {
       m_dPSNRSum[i] += psnr[i];
       m_MSEyuvframe[i] += MSEyuvframe[i];
+      if (ssim != NULL)
+      {
+        m_dSSIMSum[i] += ssim[i];
+      }
     }
 
     m_uiNumPic++;
   }
 
   Double  getPsnr(ComponentID compID) const { return  m_dPSNRSum[compID];  }
+  Double  getSsim(ComponentID compID) const { return  m_dSSIMSum[compID];  }
   Double  getBits()                   const { return  m_dAddBits;   }
   Void    setBits(Double numBits)     { m_dAddBits=numBits; }
   UInt    getNumPic()                 const { return  m_uiNumPic;   }
@@ -95,10 +101,23 @@ public:
     {
       m_dPSNRSum[i] = 0;
       m_MSEyuvframe[i] = 0;
+      m_dSSIMSum[i] = 0;
     }
     m_uiNumPic = 0;
   }
 
+  /// print the average SSIM of each component
+  Void    printOutSSIM ( const ChromaFormat chFmt )
+  {
+    printf( "Average SSIM:\t" );
+    for (UInt comp=0; comp<getNumberValidComponents(chFmt); comp++)
+    {
+      const ComponentID compID = ComponentID(comp);
+      printf( " %c %8.6lf", (compID==COMPONENT_Y ? 'Y' : compID==COMPONENT_Cb ? 'U' : 'V'), getNumPic() ? getSsim(compID) / (Double)getNumPic() : 0.0 );
+    }
+    printf( "\n" );
+  }
+
 
   Void calculateCombinedValues(const ChromaFormat chFmt, Double &PSNRyuv, Double &MSEyuv)
   {
@@ -354,13 +373,6 @@ public:
   }
 };
 
-extern TEncAnalyze             m_gcAnalyzeAll;
-extern TEncAnalyze             m_gcAnalyzeI;
-extern TEncAnalyze             m_gcAnalyzeP;
-extern TEncAnalyze             m_gcAnalyzeB;
-
-extern TEncAnalyze             m_gcAnalyzeAll_in;
-
 //! \}
 
 #endif // !defined(AFX_TENCANALYZE_H__C79BCAA2_6AC8_4175_A0FE_CF02F5829233__INCLUDED_)
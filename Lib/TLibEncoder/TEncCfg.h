@@ -113,6 +113,8 @@ protected:
   Bool      m_printMSEBasedSequencePSNR;
   Bool      m_printFrameMSE;
   Bool      m_printSequenceMSE;
+  Bool      m_printSSIM;                                 ///< also calculate and print the SSIM of each picture
+  Bool      m_bParallelQualityMetrics;                   ///< measure the colour planes of each picture concurrently
 
   /* profile & level */
   Profile::Name m_profile;
@@ -135,6 +137,8 @@ protected:
   Int       m_extraRPSs;
   Int       m_maxDecPicBuffering[MAX_TLAYER];
   Int       m_numReorderPics[MAX_TLAYER];
+  Bool      m_sceneCutDetection;                ///< insert an IRAP picture and restart the GOP at detected scene cuts
+  Int       m_sceneCutThreshold;                ///< increase of the mean 8x8 luma block difference (8-bit units) signalling a cut
 
   Int       m_iQP;                              //  if (AdaptiveQP == OFF)
 
@@ -167,6 +171,8 @@ protected:
   Int       m_iFastSearch;                      //  0:Full search  1:Diamond  2:PMVFAST
   Int       m_iSearchRange;                     //  0:Full frame
   Int       m_bipredSearchRange;
+  Double    m_bipredMinGain;
+  Double    m_bipredSkipRatio;
 
   //====== Quality control ========
   Int       m_iMaxDeltaQP;                      //  Max. absolute delta QP (1:default)
@@ -183,10 +189,14 @@ protected:
   Bool      m_useExtendedPrecision;
   Bool      m_useHighPrecisionPredictionWeighting;
   Bool      m_bUseAdaptiveQP;
+  Bool      m_bUseAdaptiveQPThread;
   Int       m_iQPAdaptationRange;
 
   //====== Tool list ========
   Bool      m_bUseASR;
+  Bool      m_bUseCtuSearchControl;
+  Double    m_dRefPruneThreshold;
+  Int       m_analysisReuseLevel;                             ///< use of the CU decisions of another encode: 0: search around them, 1: code them
   Bool      m_bUseHADME;
   Bool      m_useRDOQ;
   Bool      m_useRDOQTS;
@@ -196,6 +206,8 @@ protected:
   Bool      m_useFastDecisionForMerge;
   Bool      m_bUseCbfFastMode;
   Bool      m_useEarlySkipDetection;
+  Int       m_fastMergeTopK;
+  Bool      m_useAdaptiveSkipTermination;
   Bool      m_useCrossComponentPrediction;
   Bool      m_reconBasedCrossCPredictionEstimate;
   UInt      m_saoOffsetBitShift[MAX_NUM_CHANNEL_TYPE];
@@ -238,6 +250,7 @@ protected:
   Int       m_iWaveFrontSubstreams;
 
   Int       m_decodedPictureHashSEIEnabled;              ///< Checksum(3)/CRC(2)/MD5(1)/disable(0) acting on decoded picture hash SEI message
+  Bool      m_bParallelPictureHash;                      ///< hash the colour planes of each picture concurrently
   Int       m_bufferingPeriodSEIEnabled;
   Int       m_pictureTimingSEIEnabled;
   Int       m_recoveryPointSEIEnabled;
@@ -304,6 +317,7 @@ protected:
   //====== Weighted Prediction ========
   Bool      m_useWeightedPred;       //< Use of Weighting Prediction (P_SLICE)
   Bool      m_useWeightedBiPred;    //< Use of Bi-directional Weighting Prediction (B_SLICE)
+  Bool      m_useWPFastSelect;      //< Estimate the SADs of the WP on/off decision on a subsampled picture
   UInt      m_log2ParallelMergeLevelMinus2;       ///< Parallel merge estimation region
   UInt      m_maxNumMergeCand;                    ///< Maximum number of merge candidates
   Int       m_useScalingListId;            ///< Using quantization matrix i.e. 0=off, 1=default, 2=file.
@@ -317,6 +331,13 @@ protected:
   Bool      m_RCUseLCUSeparateModel;
   Int       m_RCInitialQP;
   Bool      m_RCForceIntraQP;
+  Bool      m_RCCtuRowLevelRC;                            ///< with LCU level RC, choose lambda and QP once per CTU row
+  Int       m_RCCpbSize;                                  ///< size in bits of the modelled coded picture buffer, 0 for no buffer constraint
+  Int       m_RCCpbInitialDelay;                          ///< initial CPB removal delay in ms
+  Int       m_RCSmoothWindowSize;                         ///< pictures over which a deviation from the sequence budget is recovered
+  Int       m_RCCtuSmoothWindowSize;                      ///< CTUs (or CTU rows) over which a deviation from the picture budget is recovered
+  Double    m_RCAlphaUpdate;                              ///< R-lambda model alpha learning rate, 0 for automatic
+  Double    m_RCBetaUpdate;                               ///< R-lambda model beta learning rate, 0 for automatic
   Bool      m_TransquantBypassEnableFlag;                     ///< transquant_bypass_enable_flag setting in PPS.
   Bool      m_CUTransquantBypassFlagForce;                    ///< if transquant_bypass_enable_flag, then, if true, all CU transquant bypass flags will be set to true.
 
@@ -392,6 +413,12 @@ public:
   Bool      getPrintSequenceMSE             ()         const { return m_printSequenceMSE;           }
   Void      setPrintSequenceMSE             (Bool value)     { m_printSequenceMSE = value;          }
 
+  Bool      getPrintSSIM                    ()         const { return m_printSSIM;                  }
+  Void      setPrintSSIM                    (Bool value)     { m_printSSIM = value;                 }
+
+  Bool      getParallelQualityMetrics       ()         const { return m_bParallelQualityMetrics;    }
+  Void      setParallelQualityMetrics       (Bool value)     { m_bParallelQualityMetrics = value;   }
+
   //====== Coding Structure ========
   Void      setIntraPeriod                  ( Int   i )      { m_uiIntraPeriod = (UInt)i; }
   Void      setDecodingRefreshType          ( Int   i )      { m_uiDecodingRefreshType = (UInt)i; }
@@ -401,6 +428,8 @@ public:
   GOPEntry  getGOPEntry                     ( Int   i )      { return m_GOPList[i]; }
   Void      setMaxDecPicBuffering           ( UInt u, UInt tlayer ) { m_maxDecPicBuffering[tlayer] = u;    }
   Void      setNumReorderPics               ( Int  i, UInt tlayer ) { m_numReorderPics[tlayer] = i;    }
+  Void      setSceneCutDetection            ( Bool b )      { m_sceneCutDetection = b; }
+  Void      setSceneCutThreshold            ( Int  i )      { m_sceneCutThreshold = i; }
 
   Void      setQP                           ( Int   i )      { m_iQP = i; }
 
@@ -431,6 +460,8 @@ public:
   Void      setFastSearch                   ( Int   i )      { m_iFastSearch = i; }
   Void      setSearchRange                  ( Int   i )      { m_iSearchRange = i; }
   Void      setBipredSearchRange            ( Int   i )      { m_bipredSearchRange = i; }
+  Void      setBipredMinGain                ( Double d )     { m_bipredMinGain = d; }
+  Void      setBipredSkipRatio              ( Double d )     { m_bipredSkipRatio = d; }
 
   //====== Quality control ========
   Void      setMaxDeltaQP                   ( Int   i )      { m_iMaxDeltaQP = i; }
@@ -457,6 +488,7 @@ public:
   Void      setUseHighPrecisionPredictionWeighting(Bool value) { m_useHighPrecisionPredictionWeighting = value; }
 
   Void      setUseAdaptiveQP                ( Bool  b )      { m_bUseAdaptiveQP = b; }
+  Void      setUseAdaptiveQPThread          ( Bool  b )      { m_bUseAdaptiveQPThread = b; }
   Void      setQPAdaptationRange            ( Int   i )      { m_iQPAdaptationRange = i; }
 
   //====== Sequence ========
@@ -474,6 +506,8 @@ public:
   Int       getGOPSize                      ()      { return  m_iGOPSize; }
   Int       getMaxDecPicBuffering           (UInt tlayer) { return m_maxDecPicBuffering[tlayer]; }
   Int       getNumReorderPics               (UInt tlayer) { return m_numReorderPics[tlayer]; }
+  Bool      getSceneCutDetection            ()      { return  m_sceneCutDetection; }
+  Int       getSceneCutThreshold            ()      { return  m_sceneCutThreshold; }
   Int       getQP                           ()      { return  m_iQP; }
 
   Int       getPad                          ( Int i )      { assert (i < 2 );                      return  m_aiPad[i]; }
@@ -495,15 +529,21 @@ public:
   //==== Motion search ========
   Int       getFastSearch                   ()      { return  m_iFastSearch; }
   Int       getSearchRange                  ()      { return  m_iSearchRange; }
+  Double    getBipredMinGain                ()      { return  m_bipredMinGain; }
+  Double    getBipredSkipRatio              ()      { return  m_bipredSkipRatio; }
 
   //==== Quality control ========
   Int       getMaxDeltaQP                   ()      { return  m_iMaxDeltaQP; }
   Int       getMaxCuDQPDepth                ()      { return  m_iMaxCuDQPDepth; }
   Bool      getUseAdaptiveQP                ()      { return  m_bUseAdaptiveQP; }
+  Bool      getUseAdaptiveQPThread          ()      { return  m_bUseAdaptiveQPThread; }
   Int       getQPAdaptationRange            ()      { return  m_iQPAdaptationRange; }
 
   //==== Tool list ========
   Void      setUseASR                       ( Bool  b )     { m_bUseASR     = b; }
+  Void      setUseCtuSearchControl          ( Bool  b )     { m_bUseCtuSearchControl = b; }
+  Void      setRefPruneThreshold            ( Double d )    { m_dRefPruneThreshold = d; }
+  Void      setAnalysisReuseLevel           ( Int   i )     { m_analysisReuseLevel = i; }
   Void      setUseHADME                     ( Bool  b )     { m_bUseHADME   = b; }
   Void      setUseRDOQ                      ( Bool  b )     { m_useRDOQ    = b; }
   Void      setUseRDOQTS                    ( Bool  b )     { m_useRDOQTS  = b; }
@@ -513,6 +553,8 @@ public:
   Void      setUseFastDecisionForMerge      ( Bool  b )     { m_useFastDecisionForMerge = b; }
   Void      setUseCbfFastMode            ( Bool  b )     { m_bUseCbfFastMode = b; }
   Void      setUseEarlySkipDetection        ( Bool  b )     { m_useEarlySkipDetection = b; }
+  Void      setFastMergeTopK                ( Int   i )     { m_fastMergeTopK = i; }
+  Void      setUseAdaptiveSkipTermination   ( Bool  b )     { m_useAdaptiveSkipTermination = b; }
   Void      setUseConstrainedIntraPred      ( Bool  b )     { m_bUseConstrainedIntraPred = b; }
   Void      setPCMInputBitDepthFlag         ( Bool  b )     { m_bPCMInputBitDepthFlag = b; }
   Void      setPCMFilterDisableFlag         ( Bool  b )     {  m_bPCMFilterDisableFlag = b; }
@@ -522,6 +564,9 @@ public:
   Void      setdQPs                         ( Int*  p )     { m_aidQP       = p; }
   Void      setDeltaQpRD                    ( UInt  u )     {m_uiDeltaQpRD  = u; }
   Bool      getUseASR                       ()      { return m_bUseASR;     }
+  Bool      getUseCtuSearchControl          ()      { return m_bUseCtuSearchControl; }
+  Double    getRefPruneThreshold            ()      { return m_dRefPruneThreshold; }
+  Int       getAnalysisReuseLevel           ()      { return m_analysisReuseLevel; }
   Bool      getUseHADME                     ()      { return m_bUseHADME;   }
   Bool      getUseRDOQ                      ()      { return m_useRDOQ;    }
   Bool      getUseRDOQTS                    ()      { return m_useRDOQTS;  }
@@ -531,6 +576,8 @@ public:
   Bool      getUseFastDecisionForMerge      ()      { return m_useFastDecisionForMerge; }
   Bool      getUseCbfFastMode               ()      { return m_bUseCbfFastMode; }
   Bool      getUseEarlySkipDetection        ()      { return m_useEarlySkipDetection; }
+  Int       getFastMergeTopK                ()      { return m_fastMergeTopK; }
+  Bool      getUseAdaptiveSkipTermination   ()      { return m_useAdaptiveSkipTermination; }
   Bool      getUseConstrainedIntraPred      ()      { return m_bUseConstrainedIntraPred; }
   Bool      getPCMInputBitDepthFlag         ()      { return m_bPCMInputBitDepthFlag;   }
   Bool      getPCMFilterDisableFlag         ()      { return m_bPCMFilterDisableFlag;   }
@@ -604,6 +651,8 @@ public:
   Int   getWaveFrontSubstreams()                                     { return m_iWaveFrontSubstreams; }
   Void  setDecodedPictureHashSEIEnabled(Int b)                       { m_decodedPictureHashSEIEnabled = b; }
   Int   getDecodedPictureHashSEIEnabled()                            { return m_decodedPictureHashSEIEnabled; }
+  Void  setParallelPictureHash(Bool b)                               { m_bParallelPictureHash = b; }
+  Bool  getParallelPictureHash()                                     { return m_bParallelPictureHash; }
   Void  setBufferingPeriodSEIEnabled(Int b)                          { m_bufferingPeriodSEIEnabled = b; }
   Int   getBufferingPeriodSEIEnabled()                               { return m_bufferingPeriodSEIEnabled; }
   Void  setPictureTimingSEIEnabled(Int b)                            { m_pictureTimingSEIEnabled = b; }
@@ -735,6 +784,8 @@ public:
   Void         setWPBiPred            ( Bool b )                     { m_useWeightedBiPred = b;    }
   Bool         getUseWP               ()                             { return m_useWeightedPred;   }
   Bool         getWPBiPred            ()                             { return m_useWeightedBiPred; }
+  Void         setUseWPFastSelect     ( Bool b )                     { m_useWPFastSelect = b;      }
+  Bool         getUseWPFastSelect     ()                             { return m_useWPFastSelect;   }
   Void         setLog2ParallelMergeLevelMinus2   ( UInt u )          { m_log2ParallelMergeLevelMinus2       = u;    }
   UInt         getLog2ParallelMergeLevelMinus2   ()                  { return m_log2ParallelMergeLevelMinus2;       }
   Void         setMaxNumMergeCand                ( UInt u )          { m_maxNumMergeCand = u;      }
@@ -761,6 +812,20 @@ public:
   Void         setInitialQP           ( Int QP )                     { m_RCInitialQP = QP;             }
   Bool         getForceIntraQP        ()                             { return m_RCForceIntraQP;        }
   Void         setForceIntraQP        ( Bool b )                     { m_RCForceIntraQP = b;           }
+  Bool         getRCCtuRowLevelRC     ()                             { return m_RCCtuRowLevelRC;       }
+  Void         setRCCtuRowLevelRC     ( Bool b )                     { m_RCCtuRowLevelRC = b;          }
+  Int          getRCCpbSize           ()                             { return m_RCCpbSize;             }
+  Void         setRCCpbSize           ( Int i )                      { m_RCCpbSize = i;                }
+  Int          getRCCpbInitialDelay   ()                             { return m_RCCpbInitialDelay;     }
+  Void         setRCCpbInitialDelay   ( Int i )                      { m_RCCpbInitialDelay = i;        }
+  Int          getRCSmoothWindowSize  ()                             { return m_RCSmoothWindowSize;    }
+  Void         setRCSmoothWindowSize  ( Int i )                      { m_RCSmoothWindowSize = i;       }
+  Int          getRCCtuSmoothWindowSize()                            { return m_RCCtuSmoothWindowSize; }
+  Void         setRCCtuSmoothWindowSize( Int i )                     { m_RCCtuSmoothWindowSize = i;    }
+  Double       getRCAlphaUpdate       ()                             { return m_RCAlphaUpdate;         }
+  Void         setRCAlphaUpdate       ( Double d )                   { m_RCAlphaUpdate = d;            }
+  Double       getRCBetaUpdate        ()                             { return m_RCBetaUpdate;          }
+  Void         setRCBetaUpdate        ( Double d )                   { m_RCBetaUpdate = d;             }
   Bool         getTransquantBypassEnableFlag()                       { return m_TransquantBypassEnableFlag; }
   Void         setTransquantBypassEnableFlag(Bool flag)              { m_TransquantBypassEnableFlag = flag; }
   Bool         getCUTransquantBypassFlagForceValue()                 { return m_CUTransquantBypassFlagForce; }
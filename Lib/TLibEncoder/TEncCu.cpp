@@ -77,25 +77,51 @@ Void TEncCu::create(UChar uhTotalDepth, UInt uiMaxWidth, UInt uiMaxHeight, Chrom
 	m_ppcRecoYuvTemp = new TComYuv*[m_uhTotalDepth - 1];
 	m_ppcOrigYuv = new TComYuv*[m_uhTotalDepth - 1];
 
+	// all the working buffers come from one arena, with the buffers of each depth next to each other
+	size_t arenaSize = 0;
+	for (i = 0; i < m_uhTotalDepth - 1; i++)
+	{
+		const UInt uiNumPartitions = 1 << ((m_uhTotalDepth - i - 1) << 1);
+		const UInt uiWidth = uiMaxWidth >> i;
+		const UInt uiHeight = uiMaxHeight >> i;
+
+		arenaSize += 2 * TComMemArena::getAlignedSize(TComDataCU::getBufferSize(chromaFormat, uiNumPartitions, uiWidth, uiHeight, false));
+		arenaSize += 7 * TComMemArena::getAlignedSize(TComYuv::getBufferSize(uiWidth, uiHeight, chromaFormat));
+	}
+	m_cArena.create(arenaSize);
+
 	UInt uiNumPartitions;
 	for (i = 0; i < m_uhTotalDepth - 1; i++)
 	{
 		uiNumPartitions = 1 << ((m_uhTotalDepth - i - 1) << 1);
 		UInt uiWidth = uiMaxWidth >> i;
 		UInt uiHeight = uiMaxHeight >> i;
+		const UInt uiCUBufferSize = TComDataCU::getBufferSize(chromaFormat, uiNumPartitions, uiWidth, uiHeight, false);
+		const UInt uiYuvBufferSize = TComYuv::getBufferSize(uiWidth, uiHeight, chromaFormat);
 
-		m_ppcBestCU[i] = new TComDataCU; m_ppcBestCU[i]->create(chromaFormat, uiNumPartitions, uiWidth, uiHeight, false, uiMaxWidth >> (m_uhTotalDepth - 1));
-		m_ppcTempCU[i] = new TComDataCU; m_ppcTempCU[i]->create(chromaFormat, uiNumPartitions, uiWidth, uiHeight, false, uiMaxWidth >> (m_uhTotalDepth - 1));
+		m_ppcBestCU[i] = new TComDataCU; m_ppcBestCU[i]->create(chromaFormat, uiNumPartitions, uiWidth, uiHeight, false, uiMaxWidth >> (m_uhTotalDepth - 1)
+#if ADAPTIVE_QP_SELECTION
+			, false
+#endif
+			, m_cArena.allocate(uiCUBufferSize));
+		m_ppcTempCU[i] = new TComDataCU; m_ppcTempCU[i]->create(chromaFormat, uiNumPartitions, uiWidth, uiHeight, false, uiMaxWidth >> (m_uhTotalDepth - 1)
+#if ADAPTIVE_QP_SELECTION
+			, false
+#endif
+			, m_cArena.allocate(uiCUBufferSize));
+		// merge estimation, AMVP and the AMP shapes ask for the same candidate lists at each CU position
+		m_ppcBestCU[i]->enableCandidateCache();
+		m_ppcTempCU[i]->enableCandidateCache();
 
-		m_ppcPredYuvBest[i] = new TComYuv; m_ppcPredYuvBest[i]->create(uiWidth, uiHeight, chromaFormat);
-		m_ppcResiYuvBest[i] = new TComYuv; m_ppcResiYuvBest[i]->create(uiWidth, uiHeight, chromaFormat);
-		m_ppcRecoYuvBest[i] = new TComYuv; m_ppcRecoYuvBest[i]->create(uiWidth, uiHeight, chromaFormat);
+		m_ppcPredYuvBest[i] = new TComYuv; m_ppcPredYuvBest[i]->create(uiWidth, uiHeight, chromaFormat, (Pel*)m_cArena.allocate(uiYuvBufferSize));
+		m_ppcResiYuvBest[i] = new TComYuv; m_ppcResiYuvBest[i]->create(uiWidth, uiHeight, chromaFormat, (Pel*)m_cArena.allocate(uiYuvBufferSize));
+		m_ppcRecoYuvBest[i] = new TComYuv; m_ppcRecoYuvBest[i]->create(uiWidth, uiHeight, chromaFormat, (Pel*)m_cArena.allocate(uiYuvBufferSize));
 
-		m_ppcPredYuvTemp[i] = new TComYuv; m_ppcPredYuvTemp[i]->create(uiWidth, uiHeight, chromaFormat);
-		m_ppcResiYuvTemp[i] = new TComYuv; m_ppcResiYuvTemp[i]->create(uiWidth, uiHeight, chromaFormat);
-		m_ppcRecoYuvTemp[i] = new TComYuv; m_ppcRecoYuvTemp[i]->create(uiWidth, uiHeight, chromaFormat);
+		m_ppcPredYuvTemp[i] = new TComYuv; m_ppcPredYuvTemp[i]->create(uiWidth, uiHeight, chromaFormat, (Pel*)m_cArena.allocate(uiYuvBufferSize));
+		m_ppcResiYuvTemp[i] = new TComYuv; m_ppcResiYuvTemp[i]->create(uiWidth, uiHeight, chromaFormat, (Pel*)m_cArena.allocate(uiYuvBufferSize));
+		m_ppcRecoYuvTemp[i] = new TComYuv; m_ppcRecoYuvTemp[i]->create(uiWidth, uiHeight, chromaFormat, (Pel*)m_cArena.allocate(uiYuvBufferSize));
 
-		m_ppcOrigYuv[i] = new TComYuv; m_ppcOrigYuv[i]->create(uiWidth, uiHeight, chromaFormat);
+		m_ppcOrigYuv[i] = new TComYuv; m_ppcOrigYuv[i]->create(uiWidth, uiHeight, chromaFormat, (Pel*)m_cArena.allocate(uiYuvBufferSize));
 	}
 
 	m_bEncodeDQP = false;
@@ -200,6 +226,8 @@ Void TEncCu::destroy()
 		delete[] m_ppcOrigYuv;
 		m_ppcOrigYuv = NULL;
 	}
+
+	m_cArena.destroy();
 }
 
 /** \param    pcEncTop      pointer of encoder class
@@ -221,6 +249,9 @@ Void TEncCu::init(TEncTop* pcEncTop)
 	m_pcRDGoOnSbacCoder = pcEncTop->getRDGoOnSbacCoder();
 
 	m_pcRateCtrl = pcEncTop->getRateCtrl();
+
+	m_pcCuAnalysisInput = pcEncTop->getCuAnalysisInput();
+	m_pcAnalysisCtu = NULL;
 }
 
 // ====================================================================================================================
@@ -237,6 +268,10 @@ Void TEncCu::compressCU(TComDataCU*& rpcCU)
 	m_ppcBestCU[0]->initCU(rpcCU->getPic(), rpcCU->getAddr());//CUݽṹĳʼʼģǴȥĲm_ppcBestCU[0]rpcCUӳʼ
 	m_ppcTempCU[0]->initCU(rpcCU->getPic(), rpcCU->getAddr());
 
+	// decisions of the reference encode for this CTU, used to constrain the search
+	m_pcAnalysisCtu = (m_pcCuAnalysisInput != NULL) ? m_pcCuAnalysisInput->getCtu(rpcCU->getSlice()->getPOC(), rpcCU->getAddr()) : NULL;
+	m_pcPredSearch->setAnalysisCtu(m_pcAnalysisCtu);
+
 	// analysis of CU
 	DEBUG_STRING_NEW(sDebug)
 
@@ -455,9 +490,20 @@ Void TEncCu::xCompressCU(TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt ui
 	Bool bSliceStart = pcSlice->getSliceSegmentCurStartCUAddr() > rpcTempCU->getSCUAddr() && pcSlice->getSliceSegmentCurStartCUAddr() < rpcTempCU->getSCUAddr() + rpcTempCU->getTotalNumPart();
 	Bool bSliceEnd = (pcSlice->getSliceSegmentCurEndCUAddr() > rpcTempCU->getSCUAddr() && pcSlice->getSliceSegmentCurEndCUAddr() < rpcTempCU->getSCUAddr() + rpcTempCU->getTotalNumPart());
 	Bool bInsidePicture = (uiRPelX < rpcBestCU->getSlice()->getSPS()->getPicWidthInLumaSamples()) && (uiBPelY < rpcBestCU->getSlice()->getSPS()->getPicHeightInLumaSamples());
+
+	// search hints from a reference encode: do not split below the reference CUs, and only split (without testing
+	// any mode) while the CU is more than one level larger than all the reference CUs it covers. When the decisions
+	// are reused, the reference CU sizes are kept and only the mode of the reference CU is coded
+	const TEncCuAnalysisUnit* pcHint = xGetAnalysisUnit(rpcBestCU, uiDepth);
+	UInt uiHintMinDepth = 0;
+	UInt uiHintMaxDepth = g_uiMaxCUDepth;
+	const Bool bDepthHint = !bSliceEnd && !bSliceStart && bInsidePicture && xGetAnalysisDepthRange(rpcBestCU, uiDepth, uiHintMinDepth, uiHintMaxDepth);
+	const Bool bReuse = m_pcEncCfg->getAnalysisReuseLevel() > 0;
+	const Bool bForceSplit = bDepthHint && (bReuse ? uiDepth < uiHintMinDepth : uiDepth + 1 < uiHintMinDepth);
+	const Bool bReuseHint = bReuse && pcHint != NULL;
 	// We need to split, so don't try these modes.
 	//sliceͷsliceβҲͼıԵٳЩģʽ
-	if (!bSliceEnd && !bSliceStart && bInsidePicture)
+	if (!bSliceEnd && !bSliceStart && bInsidePicture && !bForceSplit)
 	{
 		for (Int iQP = iMinQP; iQP <= iMaxQP; iQP++)//ԸQPȽskipģʽԤ
 		{
@@ -485,7 +531,12 @@ Void TEncCu::xCompressCU(TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt ui
 
 			// do inter modes, SKIP and 2Nx2N
 			// 2Nx2N˶ҲAMVPMerge֡skipģʽʵMerge2Nx2NһʣskipҲ2Nx2N
-			if (rpcBestCU->getSlice()->getSliceType() != I_SLICE)
+			if (bReuseHint)
+			{
+				xCheckRDCostAnalysis(rpcBestCU, rpcTempCU, pcHint DEBUG_STRING_PASS_INTO(sDebug));
+				rpcTempCU->initEstData(uiDepth, iQP, bIsLosslessMode);
+			}
+			else if (rpcBestCU->getSlice()->getSliceType() != I_SLICE)
 			{
 				// 2Nx2N
 				if (m_pcEncCfg->getUseEarlySkipDetection())
@@ -496,9 +547,15 @@ Void TEncCu::xCompressCU(TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt ui
 				// SKIP
 				xCheckRDCostMerge2Nx2N(rpcBestCU, rpcTempCU DEBUG_STRING_PASS_INTO(sDebug), &earlyDetectionSkipMode);//by Merge for inter_2Nx2N
 				rpcTempCU->initEstData(uiDepth, iQP, bIsLosslessMode);
+				// without ESD, only AdaptiveSkipTermination sets earlyDetectionSkipMode in the merge check; it also skips the AMVP 2Nx2N check
+				const Bool bSkipTerminated = earlyDetectionSkipMode;
+				if (pcHint != NULL && pcHint->skipFlag && rpcBestCU->isSkipped(0))
+				{
+					earlyDetectionSkipMode = true; // SKIP in the reference encode as well
+				}
 				//Merge2Nx2N㷨earlyDetectionSkipModeһʱᱻλΪtrue
 
-				if (!m_pcEncCfg->getUseEarlySkipDetection())//skipȿ㷨CBF־㷨CFMصĲֹֿ֡㣬ҿԷֱ𿪹ء
+				if (!m_pcEncCfg->getUseEarlySkipDetection() && !bSkipTerminated)//skipȿ㷨CBF־㷨CFMصĲֹֿ֡㣬ҿԷֱ𿪹ء
 				{
 					// 2Nx2N, NxN
 					xCheckRDCostInter(rpcBestCU, rpcTempCU, SIZE_2Nx2N DEBUG_STRING_PASS_INTO(sDebug));
@@ -516,7 +573,7 @@ Void TEncCu::xCompressCU(TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt ui
 			}
 		}
 
-		if (!earlyDetectionSkipMode)//˼ӦǣûskipģʽٽģʽĲԡskipټⷽȷskipģʽʱearlyDetectionSkipMode־λtrue
+		if (!earlyDetectionSkipMode && !bReuseHint)//˼ӦǣûskipģʽٽģʽĲԡskipټⷽȷskipģʽʱearlyDetectionSkipMode־λtrue
 		{
 			for (Int iQP = iMinQP; iQP <= iMaxQP; iQP++)//ԸQP
 			{
@@ -978,11 +1035,12 @@ Void TEncCu::xCompressCU(TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt ui
 				// do normal intra modes
 				// speedup for inter frames
 				Double intraCost = 0.0;
+				const Bool bIntraHinted = (pcHint == NULL || pcHint->predMode == MODE_INTRA);
 
-				if ((rpcBestCU->getSlice()->getSliceType() == I_SLICE) ||
+				if (bIntraHinted && ((rpcBestCU->getSlice()->getSliceType() == I_SLICE) ||
 					(rpcBestCU->getCbf(0, COMPONENT_Y) != 0) ||
 					((rpcBestCU->getCbf(0, COMPONENT_Cb) != 0) && (numberValidComponents > COMPONENT_Cb)) ||
-					((rpcBestCU->getCbf(0, COMPONENT_Cr) != 0) && (numberValidComponents > COMPONENT_Cr))) // avoid very complex intra if it is unlikely
+					((rpcBestCU->getCbf(0, COMPONENT_Cr) != 0) && (numberValidComponents > COMPONENT_Cr)))) // avoid very complex intra if it is unlikely
 				{
 					xCheckRDCostIntra(rpcBestCU, rpcTempCU, intraCost, SIZE_2Nx2N DEBUG_STRING_PASS_INTO(sDebug));
 					rpcTempCU->initEstData(uiDepth, iQP, bIsLosslessMode);
@@ -1034,8 +1092,14 @@ Void TEncCu::xCompressCU(TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt ui
 		{
 			bSubBranch = true;
 		}
+
+		// the reference encode did not split below this depth
+		if (bDepthHint && uiHintMaxDepth <= uiDepth)
+		{
+			bSubBranch = false;
+		}
 	}
-	else if (!(bSliceEnd && bInsidePicture))
+	else if (!bForceSplit && !(bSliceEnd && bInsidePicture))
 	{
 		bBoundary = true;
 	}
@@ -1603,9 +1667,31 @@ Void TEncCu::xCheckRDCostMerge2Nx2N(TComDataCU*& rpcBestCU, TComDataCU*& rpcTemp
 	rpcTempCU->getInterMergeCandidates(0, 0, cMvFieldNeighbours, uhInterDirNeighbours, numValidMergeCand);
 
 	Int mergeCandBuffer[MRG_MAX_NUM_CANDS];
+	Int mergeCandOrder[MRG_MAX_NUM_CANDS];
 	for (UInt ui = 0; ui < numValidMergeCand; ++ui)
 	{
 		mergeCandBuffer[ui] = 0;
+		mergeCandOrder[ui] = ui;
+	}
+
+	// staged evaluation: rank the candidates by the SATD of their prediction and give only the best ones a full RD check
+	const Bool bSkipNeighbourhood = m_pcEncCfg->getUseAdaptiveSkipTermination() && xIsSkipNeighbourhood(rpcTempCU);
+	Int numFullRDCand = numValidMergeCand;
+	if (m_pcEncCfg->getFastMergeTopK() > 0 && m_pcEncCfg->getFastMergeTopK() < numValidMergeCand)
+	{
+		numFullRDCand = m_pcEncCfg->getFastMergeTopK();
+	}
+	if (numFullRDCand < numValidMergeCand || bSkipNeighbourhood)
+	{
+		xRankMergeCandidates(rpcTempCU, cMvFieldNeighbours, uhInterDirNeighbours, numValidMergeCand, mergeCandOrder);
+	}
+
+	// the reference encode merged this CU: only its candidate is checked
+	const TEncCuAnalysisUnit* pcHint = xGetAnalysisUnit(rpcTempCU, uhDepth);
+	if (pcHint != NULL && pcHint->mergeFlag && pcHint->partSize == SIZE_2Nx2N && pcHint->mergeIdx < numValidMergeCand)
+	{
+		mergeCandOrder[0] = pcHint->mergeIdx;
+		numFullRDCand = 1;
 	}
 
 	Bool bestIsSkip = false;
@@ -1623,8 +1709,11 @@ Void TEncCu::xCheckRDCostMerge2Nx2N(TComDataCU*& rpcBestCU, TComDataCU*& rpcTemp
 
 		for (UInt uiNoResidual = 0; uiNoResidual < iteration; ++uiNoResidual)
 		{
-			for (UInt uiMergeCand = 0; uiMergeCand < numValidMergeCand; ++uiMergeCand)
+			// in a SKIP neighbourhood only the best ranked candidate is tried with a residual
+			const Int numRDCand = (uiNoResidual == 0 && bSkipNeighbourhood) ? 1 : numFullRDCand;
+			for (Int iRank = 0; iRank < numRDCand; ++iRank)
 			{
+				const UInt uiMergeCand = mergeCandOrder[iRank];
 				if (!(uiNoResidual == 1 && mergeCandBuffer[uiMergeCand] == 1))
 				{
 					if (!(bestIsSkip && uiNoResidual == 0))
@@ -1707,9 +1796,188 @@ Void TEncCu::xCheckRDCostMerge2Nx2N(TComDataCU*& rpcBestCU, TComDataCU*& rpcTemp
 				}
 			}
 		}
+
+	if (bSkipNeighbourhood && rpcBestCU->isSkipped(0))
+	{
+		*earlyDetectionSkipMode = true;
+	}
 	DEBUG_STRING_APPEND(sDebug, bestStr)
 }
 
+/** sort the merge candidates by the SATD cost of their prediction
+ * \param pcCU                 CU with the merge 2Nx2N parameters set
+ * \param pcMvFieldNeighbours  motion of the merge candidates (two entries per candidate)
+ * \param puhInterDirNeighbours inter direction of the merge candidates
+ * \param iNumCand             number of merge candidates
+ * \param piCandOrder          returns the candidate indices in increasing order of cost
+ */
+Void TEncCu::xRankMergeCandidates(TComDataCU* pcCU, TComMvField* pcMvFieldNeighbours, UChar* puhInterDirNeighbours, Int iNumCand, Int* piCandOrder)
+{
+	const UChar uhDepth = pcCU->getDepth(0);
+	const UInt  numberValidComponents = pcCU->getPic()->getNumberValidComponents();
+	TComYuv*    pcPredYuv = m_ppcPredYuvTemp[uhDepth];
+	TComYuv*    pcOrgYuv = m_ppcOrigYuv[uhDepth];
+	Distortion  auiCost[MRG_MAX_NUM_CANDS];
+
+	m_pcRdCost->getMotionCost(true, 0, pcCU->getCUTransquantBypass(0));
+
+	for (Int iCand = 0; iCand < iNumCand; iCand++)
+	{
+		pcCU->setInterDirSubParts(puhInterDirNeighbours[iCand], 0, 0, uhDepth);
+		pcCU->getCUMvField(REF_PIC_LIST_0)->setAllMvField(pcMvFieldNeighbours[0 + 2 * iCand], SIZE_2Nx2N, 0, 0);
+		pcCU->getCUMvField(REF_PIC_LIST_1)->setAllMvField(pcMvFieldNeighbours[1 + 2 * iCand], SIZE_2Nx2N, 0, 0);
+		m_pcPredSearch->motionCompensation(pcCU, pcPredYuv);
+
+		Distortion uiSATD = 0;
+		for (UInt comp = 0; comp < numberValidComponents; comp++)
+		{
+			const ComponentID compID = ComponentID(comp);
+			uiSATD += m_pcRdCost->getDistPart(g_bitDepth[toChannelType(compID)], pcPredYuv->getAddr(compID), pcPredYuv->getStride(compID),
+			                                  pcOrgYuv->getAddr(compID), pcOrgYuv->getStride(compID), pcPredYuv->getWidth(compID), pcPredYuv->getHeight(compID), compID, DF_HADS);
+		}
+
+		// truncated unary merge index
+		const UInt uiBits = iCand + (iCand < pcCU->getSlice()->getMaxNumMergeCand() - 1 ? 1 : 0);
+		auiCost[iCand] = uiSATD + m_pcRdCost->getCost(uiBits);
+
+		Int iPos = iCand;
+		while (iPos > 0 && auiCost[piCandOrder[iPos - 1]] > auiCost[iCand])
+		{
+			piCandOrder[iPos] = piCandOrder[iPos - 1];
+			iPos--;
+		}
+		piCandOrder[iPos] = iCand;
+	}
+}
+
+/** check whether the left, above and co-located CUs are all coded in SKIP mode
+ * \param pcCU CU to be coded
+ * \returns true if at least two of these neighbours are available and all of them are SKIP
+ */
+Bool TEncCu::xIsSkipNeighbourhood(TComDataCU* pcCU)
+{
+	const UInt  uiAbsZorderIdx = pcCU->getZorderIdxInCU();
+	Int         iNumAvailable = 0;
+	Int         iNumSkipped = 0;
+	UInt        uiPartIdx;
+	TComDataCU* pcNeighbour;
+
+	pcNeighbour = pcCU->getPULeft(uiPartIdx, uiAbsZorderIdx);
+	if (pcNeighbour != NULL)
+	{
+		iNumAvailable++;
+		iNumSkipped += pcNeighbour->isSkipped(uiPartIdx) ? 1 : 0;
+	}
+
+	pcNeighbour = pcCU->getPUAbove(uiPartIdx, uiAbsZorderIdx);
+	if (pcNeighbour != NULL)
+	{
+		iNumAvailable++;
+		iNumSkipped += pcNeighbour->isSkipped(uiPartIdx) ? 1 : 0;
+	}
+
+	pcNeighbour = pcCU->getCUColocated(REF_PIC_LIST_0);
+	if (pcNeighbour != NULL && pcNeighbour->getSlice() != NULL && uiAbsZorderIdx < pcNeighbour->getTotalNumPart())
+	{
+		iNumAvailable++;
+		iNumSkipped += pcNeighbour->isSkipped(uiAbsZorderIdx) ? 1 : 0;
+	}
+
+	return iNumAvailable >= 2 && iNumSkipped == iNumAvailable;
+}
+
+/** get the decisions of the reference encode for a CU it coded at the same position and depth
+ * \param pcCU    CU to be coded
+ * \param uiDepth depth of the CU
+ * \returns NULL if there are no hints for the CTU or the reference encode coded the area with other CU sizes
+ */
+const TEncCuAnalysisUnit* TEncCu::xGetAnalysisUnit(TComDataCU* pcCU, UInt uiDepth)
+{
+	if (m_pcAnalysisCtu == NULL)
+	{
+		return NULL;
+	}
+
+	const TEncCuAnalysisUnit* pcUnit = m_pcAnalysisCtu + pcCU->getZorderIdxInCU();
+	if (pcUnit->depth != uiDepth || (pcUnit->predMode == MODE_INTER && pcCU->getSlice()->isIntra()))
+	{
+		return NULL;
+	}
+	return pcUnit;
+}
+
+/** code a CU with the mode the reference encode chose for it
+ * \param rpcBestCU best CU
+ * \param rpcTempCU CU to be tested
+ * \param pcHint    decisions of the reference encode for the CU
+ *
+ * Partitions that are not available for the CU in this encode are replaced by 2Nx2N.
+ */
+Void TEncCu::xCheckRDCostAnalysis(TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, const TEncCuAnalysisUnit* pcHint DEBUG_STRING_FN_DECLARE(sDebug))
+{
+	const UInt uiDepth    = rpcTempCU->getDepth(0);
+	const Bool bMaxDepth  = uiDepth == g_uiMaxCUDepth - g_uiAddCUDepth;
+	PartSize   ePartSize  = PartSize(pcHint->partSize);
+
+	if (pcHint->predMode == MODE_INTRA)
+	{
+		if (ePartSize != SIZE_NxN || !bMaxDepth || rpcTempCU->getWidth(0) <= (1 << rpcTempCU->getSlice()->getSPS()->getQuadtreeTULog2MinSize()))
+		{
+			ePartSize = SIZE_2Nx2N;
+		}
+		Double dIntraCost;
+		xCheckRDCostIntra(rpcBestCU, rpcTempCU, dIntraCost, ePartSize DEBUG_STRING_PASS_INTO(sDebug));
+		return;
+	}
+
+	if ((ePartSize == SIZE_NxN && (!bMaxDepth || rpcTempCU->getWidth(0) == 8)) ||
+		(ePartSize >= SIZE_2NxnU && !rpcTempCU->getSlice()->getSPS()->getAMPAcc(uiDepth)))
+	{
+		ePartSize = SIZE_2Nx2N;
+	}
+
+	if (ePartSize == SIZE_2Nx2N && pcHint->mergeFlag)
+	{
+		Bool bEarlySkip = false;
+		xCheckRDCostMerge2Nx2N(rpcBestCU, rpcTempCU DEBUG_STRING_PASS_INTO(sDebug), &bEarlySkip);
+	}
+	else
+	{
+		xCheckRDCostInter(rpcBestCU, rpcTempCU, ePartSize DEBUG_STRING_PASS_INTO(sDebug));
+	}
+}
+
+/** get the range of depths of the reference encode CUs inside a CU
+ * \param pcCU        CU to be coded
+ * \param uiDepth     depth of the CU
+ * \param ruiMinDepth returns the smallest depth
+ * \param ruiMaxDepth returns the largest depth
+ * \returns false if there are no hints for the CTU
+ */
+Bool TEncCu::xGetAnalysisDepthRange(TComDataCU* pcCU, UInt uiDepth, UInt& ruiMinDepth, UInt& ruiMaxDepth)
+{
+	if (m_pcAnalysisCtu == NULL)
+	{
+		return false;
+	}
+
+	const UInt uiFirstPart = pcCU->getZorderIdxInCU();
+	ruiMinDepth = m_pcAnalysisCtu[uiFirstPart].depth;
+	ruiMaxDepth = ruiMinDepth;
+
+	// otherwise a single reference CU covers the whole area
+	if (ruiMinDepth > uiDepth)
+	{
+		const UInt uiNumParts = pcCU->getPic()->getNumPartInCU() >> (uiDepth << 1);
+		for (UInt uiPart = uiFirstPart + 1; uiPart < uiFirstPart + uiNumParts; uiPart++)
+		{
+			ruiMinDepth = std::min<UInt>(ruiMinDepth, m_pcAnalysisCtu[uiPart].depth);
+			ruiMaxDepth = std::max<UInt>(ruiMaxDepth, m_pcAnalysisCtu[uiPart].depth);
+		}
+	}
+	return true;
+}
+
 
 #if AMP_MRG
 Void TEncCu::xCheckRDCostInter(TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, PartSize ePartSize DEBUG_STRING_FN_DECLARE(sDebug), Bool bUseMRG)
@@ -1722,6 +1990,13 @@ Void TEncCu::xCheckRDCostInter(TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, P
 
 		UChar uhDepth = rpcTempCU->getDepth(0);
 
+	// the reference encode coded this CU with another partitioning
+	const TEncCuAnalysisUnit* pcHint = xGetAnalysisUnit(rpcTempCU, uhDepth);
+	if (pcHint != NULL && ePartSize != SIZE_2Nx2N && (pcHint->predMode != MODE_INTER || pcHint->partSize != ePartSize))
+	{
+		return;
+	}
+
 	rpcTempCU->setDepthSubParts(uhDepth, 0);
 
 	rpcTempCU->setSkipFlagSubParts(false, 0, uhDepth);
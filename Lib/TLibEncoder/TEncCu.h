@@ -45,6 +45,7 @@
 #include "TLibCommon/TComTrQuant.h"
 #include "TLibCommon/TComBitCounter.h"
 #include "TLibCommon/TComDataCU.h"
+#include "TLibCommon/TComMemArena.h"
 
 #include "TEncEntropy.h"
 #include "TEncSearch.h"
@@ -77,6 +78,7 @@ private:
   TComYuv**               m_ppcResiYuvTemp; ///< Temporary Residual Yuv for each depth
   TComYuv**               m_ppcRecoYuvTemp; ///< Temporary Reconstruction Yuv for each depth
   TComYuv**               m_ppcOrigYuv;     ///< Original Yuv for each depth
+  TComMemArena            m_cArena;         ///< holds the data of all the CUs and Yuvs above, laid out depth by depth
 
   //  Data : encoder control
   Bool                    m_bEncodeDQP;
@@ -100,6 +102,10 @@ private:
   TEncSbac*               m_pcRDGoOnSbacCoder;
   TEncRateCtrl*           m_pcRateCtrl;
 
+  // search hints from the CU decisions of a reference encode
+  TEncCuAnalysis*         m_pcCuAnalysisInput; ///< NULL if the encode runs a full search
+  const TEncCuAnalysisUnit* m_pcAnalysisCtu;   ///< decisions of the reference encode for the current CTU, NULL if none
+
 public:
   /// copy parameters from encoder class
   Void  init                ( TEncTop* pcEncTop );
@@ -133,6 +139,12 @@ protected:
   Void  xCheckBestMode      ( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt uiDepth DEBUG_STRING_FN_DECLARE(sParent) DEBUG_STRING_FN_DECLARE(sTest) DEBUG_STRING_PASS_INTO(Bool bAddSizeInfo=true));
 
   Void  xCheckRDCostMerge2Nx2N( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU DEBUG_STRING_FN_DECLARE(sDebug), Bool *earlyDetectionSkipMode );
+  Void  xRankMergeCandidates( TComDataCU* pcCU, TComMvField* pcMvFieldNeighbours, UChar* puhInterDirNeighbours, Int iNumCand, Int* piCandOrder );
+  Bool  xIsSkipNeighbourhood( TComDataCU* pcCU );
+
+  const TEncCuAnalysisUnit* xGetAnalysisUnit( TComDataCU* pcCU, UInt uiDepth );
+  Bool  xGetAnalysisDepthRange( TComDataCU* pcCU, UInt uiDepth, UInt& ruiMinDepth, UInt& ruiMaxDepth );
+  Void  xCheckRDCostAnalysis( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, const TEncCuAnalysisUnit* pcHint DEBUG_STRING_FN_DECLARE(sDebug) );
 
 #if AMP_MRG
   Void  xCheckRDCostInter   ( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, PartSize ePartSize DEBUG_STRING_FN_DECLARE(sDebug), Bool bUseMRG = false  );
@@ -0,0 +1,455 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2014, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncCuAnalysis.cpp
+    \brief    store of final CU decisions used as search hints by other encodes
+*/
+
+#include "TEncCuAnalysis.h"
+
+#include <vector>
+
+//! \ingroup TLibEncoder
+//! \{
+
+static const Char ANALYSIS_FILE_MAGIC[4]    = { 'H', 'M', 'C', 'A' };
+static const UInt ANALYSIS_FILE_VERSION     = 1;
+static const UInt ANALYSIS_FILE_HEADER_SIZE = 16;
+static const UInt ANALYSIS_PICTURE_HEADER_SIZE = 8;
+
+static inline Void writeValue( std::vector<UChar>& rBuffer, UInt uiValue, UInt uiNumBytes )
+{
+  for ( UInt i = 0; i < uiNumBytes; i++ )
+  {
+    rBuffer.push_back( UChar( uiValue >> ( 8 * i ) ) );
+  }
+}
+
+static inline UInt readValue( const UChar*& rpcData, UInt uiNumBytes )
+{
+  UInt uiValue = 0;
+  for ( UInt i = 0; i < uiNumBytes; i++ )
+  {
+    uiValue |= UInt( *rpcData++ ) << ( 8 * i );
+  }
+  return uiValue;
+}
+
+// ====================================================================================================================
+// Constructor / destructor / create / destroy
+// ====================================================================================================================
+
+TEncCuAnalysis::TEncCuAnalysis()
+: m_uiNumCtus     ( 0 )
+, m_uiNumPartInCtu( 0 )
+, m_iNumUsers     ( 0 )
+, m_bLoadFile     ( false )
+, m_bEndOfFile    ( false )
+{
+}
+
+TEncCuAnalysis::~TEncCuAnalysis()
+{
+  destroy();
+}
+
+/** \param uiNumCtus      number of CTUs in a picture
+ *  \param uiNumPartInCtu number of minimum partitions in a CTU
+ *  \param iNumUsers      number of encoders that release each picture, 0 if pictures are only saved to the analysis file
+ */
+Void TEncCuAnalysis::create( UInt uiNumCtus, UInt uiNumPartInCtu, Int iNumUsers )
+{
+  destroy();
+
+  m_uiNumCtus      = uiNumCtus;
+  m_uiNumPartInCtu = uiNumPartInCtu;
+  m_iNumUsers      = iNumUsers;
+}
+
+Void TEncCuAnalysis::destroy()
+{
+  for ( std::map<Int, Picture>::iterator it = m_pictures.begin(); it != m_pictures.end(); it++ )
+  {
+    delete [] it->second.pcUnits;
+  }
+  m_pictures.clear();
+
+  if ( m_cFile.is_open() )
+  {
+    m_cFile.close();
+  }
+  m_bLoadFile  = false;
+  m_bEndOfFile = false;
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** \param fileName name of the analysis file
+ *  \param bLoad    load pictures from the file on demand, otherwise save each stored picture to it
+ *  \returns false if the file cannot be opened, or a loaded file has no valid header for the picture and CTU size
+ */
+Bool TEncCuAnalysis::openFile( const std::string& fileName, Bool bLoad )
+{
+  m_bLoadFile  = bLoad;
+  m_bEndOfFile = false;
+  m_cFile.open( fileName.c_str(), std::fstream::binary | ( bLoad ? std::fstream::in : std::fstream::out ) );
+  if ( !m_cFile.is_open() )
+  {
+    return false;
+  }
+
+  if ( !bLoad )
+  {
+    std::vector<UChar> header( ANALYSIS_FILE_MAGIC, ANALYSIS_FILE_MAGIC + 4 );
+    writeValue( header, ANALYSIS_FILE_VERSION, 4 );
+    writeValue( header, m_uiNumCtus,           4 );
+    writeValue( header, m_uiNumPartInCtu,      4 );
+    m_cFile.write( reinterpret_cast<const Char*>( &header[0] ), header.size() );
+    return m_cFile.good();
+  }
+
+  UChar header[ANALYSIS_FILE_HEADER_SIZE];
+  if ( !m_cFile.read( reinterpret_cast<Char*>( header ), ANALYSIS_FILE_HEADER_SIZE ) || memcmp( header, ANALYSIS_FILE_MAGIC, 4 ) != 0 )
+  {
+    m_cFile.close();
+    return false;
+  }
+  const UChar* pcData    = header + 4;
+  const UInt   uiVersion = readValue( pcData, 4 );
+  const UInt   uiNumCtus = readValue( pcData, 4 );
+  const UInt   uiNumPart = readValue( pcData, 4 );
+  if ( uiVersion != ANALYSIS_FILE_VERSION || uiNumCtus != m_uiNumCtus || uiNumPart != m_uiNumPartInCtu )
+  {
+    m_cFile.close();
+    return false;
+  }
+  return true;
+}
+
+Void TEncCuAnalysis::storePicture( TComPic* pcPic )
+{
+  assert( pcPic->getNumCUsInFrame() == m_uiNumCtus && pcPic->getNumPartInCU() == m_uiNumPartInCtu );
+
+  Picture& rcPicture = m_pictures[pcPic->getPOC()];
+  if ( rcPicture.pcUnits == NULL )
+  {
+    rcPicture.pcUnits = new TEncCuAnalysisUnit[m_uiNumCtus * m_uiNumPartInCtu];
+  }
+  rcPicture.iUsersLeft = m_iNumUsers;
+
+  TEncCuAnalysisUnit* pcUnit = rcPicture.pcUnits;
+  for ( UInt uiCtuAddr = 0; uiCtuAddr < m_uiNumCtus; uiCtuAddr++ )
+  {
+    TComDataCU*          pcCU       = pcPic->getCU( uiCtuAddr );
+    const TComCUMvField* pcMvField0 = pcCU->getCUMvField( REF_PIC_LIST_0 );
+    const TComCUMvField* pcMvField1 = pcCU->getCUMvField( REF_PIC_LIST_1 );
+
+    for ( UInt uiPartIdx = 0; uiPartIdx < m_uiNumPartInCtu; uiPartIdx++, pcUnit++ )
+    {
+      pcUnit->depth     = pcCU->getDepth( uiPartIdx );
+      pcUnit->partSize  = UChar( pcCU->getPartitionSize( uiPartIdx ) );
+      pcUnit->predMode  = UChar( pcCU->getPredictionMode( uiPartIdx ) );
+      pcUnit->skipFlag  = pcCU->getSkipFlag( uiPartIdx ) ? 1 : 0;
+      pcUnit->mergeFlag = pcCU->getMergeFlag( uiPartIdx ) ? 1 : 0;
+      pcUnit->mergeIdx  = pcCU->getMergeIndex( uiPartIdx );
+      pcUnit->interDir  = pcCU->getInterDir( uiPartIdx );
+
+      pcUnit->refIdx[REF_PIC_LIST_0] = Char( pcMvField0->getRefIdx( uiPartIdx ) );
+      pcUnit->refIdx[REF_PIC_LIST_1] = Char( pcMvField1->getRefIdx( uiPartIdx ) );
+      pcUnit->mv[REF_PIC_LIST_0][0]  = Short( pcMvField0->getMv( uiPartIdx ).getHor() );
+      pcUnit->mv[REF_PIC_LIST_0][1]  = Short( pcMvField0->getMv( uiPartIdx ).getVer() );
+      pcUnit->mv[REF_PIC_LIST_1][0]  = Short( pcMvField1->getMv( uiPartIdx ).getHor() );
+      pcUnit->mv[REF_PIC_LIST_1][1]  = Short( pcMvField1->getMv( uiPartIdx ).getVer() );
+    }
+  }
+
+  if ( m_cFile.is_open() && !m_bLoadFile )
+  {
+    xSavePicture( pcPic->getPOC(), rcPicture.pcUnits );
+  }
+
+  // nobody else uses the picture
+  if ( m_iNumUsers == 0 )
+  {
+    delete [] rcPicture.pcUnits;
+    m_pictures.erase( pcPic->getPOC() );
+  }
+}
+
+/** \param iPOC      POC of the picture
+ *  \param uiCtuAddr CTU address in raster order
+ *  \returns pointer to the m_uiNumPartInCtu units of the CTU in z-scan order
+ *
+ * When loading from an analysis file, pictures are read until the requested one is found. Pictures read
+ * ahead are kept until they are released.
+ */
+const TEncCuAnalysisUnit* TEncCuAnalysis::getCtu( Int iPOC, UInt uiCtuAddr )
+{
+  std::map<Int, Picture>::const_iterator it = m_pictures.find( iPOC );
+  while ( it == m_pictures.end() && m_bLoadFile && !m_bEndOfFile && xLoadPicture() )
+  {
+    it = m_pictures.find( iPOC );
+  }
+
+  if ( it == m_pictures.end() || uiCtuAddr >= m_uiNumCtus )
+  {
+    return NULL;
+  }
+  return it->second.pcUnits + uiCtuAddr * m_uiNumPartInCtu;
+}
+
+Void TEncCuAnalysis::releasePicture( Int iPOC )
+{
+  std::map<Int, Picture>::iterator it = m_pictures.find( iPOC );
+  if ( it == m_pictures.end() || m_iNumUsers == 0 )
+  {
+    return;
+  }
+  if ( --it->second.iUsersLeft <= 0 )
+  {
+    delete [] it->second.pcUnits;
+    m_pictures.erase( it );
+  }
+}
+
+// ====================================================================================================================
+// Protected member functions
+// ====================================================================================================================
+
+/** get the prediction unit covering a minimum partition of a CU
+ * \param uiPartSize PartSize of the CU
+ * \param uiPartIdx  minimum partition in z-scan order relative to the CU
+ * \param uiNumParts number of minimum partitions of the CU
+ * \returns index of the prediction unit, in the order of TComDataCU::getPartIndexAndSize
+ */
+UInt TEncCuAnalysis::xGetPuIdx( UInt uiPartSize, UInt uiPartIdx, UInt uiNumParts ) const
+{
+  // position in minimum partitions from the z-scan index
+  UInt uiX    = 0;
+  UInt uiY    = 0;
+  UInt uiSize = 1;
+  for ( UInt uiBit = 0; uiSize * uiSize < uiNumParts; uiBit++, uiSize <<= 1 )
+  {
+    uiX |= ( ( uiPartIdx >> ( 2 * uiBit     ) ) & 1 ) << uiBit;
+    uiY |= ( ( uiPartIdx >> ( 2 * uiBit + 1 ) ) & 1 ) << uiBit;
+  }
+
+  switch ( uiPartSize )
+  {
+    case SIZE_2NxN:  return ( uiY >= uiSize / 2 ) ? 1 : 0;
+    case SIZE_Nx2N:  return ( uiX >= uiSize / 2 ) ? 1 : 0;
+    case SIZE_NxN:   return ( uiY >= uiSize / 2 ? 2 : 0 ) + ( uiX >= uiSize / 2 ? 1 : 0 );
+    case SIZE_2NxnU: return ( uiY >= uiSize / 4 ) ? 1 : 0;
+    case SIZE_2NxnD: return ( uiY >= uiSize * 3 / 4 ) ? 1 : 0;
+    case SIZE_nLx2N: return ( uiX >= uiSize / 4 ) ? 1 : 0;
+    case SIZE_nRx2N: return ( uiX >= uiSize * 3 / 4 ) ? 1 : 0;
+    default:         return 0;
+  }
+}
+
+Void TEncCuAnalysis::xSavePicture( Int iPOC, const TEncCuAnalysisUnit* pcUnits )
+{
+  std::vector<UChar> payload;
+
+  for ( UInt uiCtuAddr = 0; uiCtuAddr < m_uiNumCtus; uiCtuAddr++ )
+  {
+    const TEncCuAnalysisUnit* pcCtu = pcUnits + uiCtuAddr * m_uiNumPartInCtu;
+
+    for ( UInt uiPartIdx = 0; uiPartIdx < m_uiNumPartInCtu; )
+    {
+      const TEncCuAnalysisUnit& rcCU       = pcCtu[uiPartIdx];
+      const UInt                uiNumParts = m_uiNumPartInCtu >> ( rcCU.depth << 1 );
+
+      writeValue( payload, rcCU.depth | ( rcCU.partSize << 3 ) | ( rcCU.predMode << 6 ) | ( rcCU.skipFlag << 7 ), 1 );
+
+      if ( rcCU.predMode == MODE_INTER )
+      {
+        // each prediction unit at its first minimum partition in z-scan order
+        UInt uiNextPU = 0;
+        for ( UInt uiPart = 0; uiPart < uiNumParts; uiPart++ )
+        {
+          if ( xGetPuIdx( rcCU.partSize, uiPart, uiNumParts ) != uiNextPU )
+          {
+            continue;
+          }
+          const TEncCuAnalysisUnit& rcPU = pcCtu[uiPartIdx + uiPart];
+          writeValue( payload, rcPU.mergeFlag | ( rcPU.mergeIdx << 1 ) | ( rcPU.interDir << 4 ), 1 );
+          for ( UInt uiList = 0; uiList < NUM_REF_PIC_LIST_01; uiList++ )
+          {
+            if ( rcPU.interDir & ( 1 << uiList ) )
+            {
+              writeValue( payload, UChar( rcPU.refIdx[uiList] ), 1 );
+              writeValue( payload, UShort( rcPU.mv[uiList][0] ), 2 );
+              writeValue( payload, UShort( rcPU.mv[uiList][1] ), 2 );
+            }
+          }
+          uiNextPU++;
+        }
+      }
+
+      uiPartIdx += uiNumParts;
+    }
+  }
+
+  std::vector<UChar> header;
+  writeValue( header, UInt( iPOC ),          4 );
+  writeValue( header, UInt( payload.size() ), 4 );
+  m_cFile.write( reinterpret_cast<const Char*>( &header[0] ), header.size() );
+  m_cFile.write( reinterpret_cast<const Char*>( &payload[0] ), payload.size() );
+}
+
+/** read the next picture of the analysis file
+ * \returns false at the end of the file, or if the picture record is corrupt, after which no more pictures are read
+ */
+Bool TEncCuAnalysis::xLoadPicture()
+{
+  UChar header[ANALYSIS_PICTURE_HEADER_SIZE];
+  if ( !m_cFile.read( reinterpret_cast<Char*>( header ), ANALYSIS_PICTURE_HEADER_SIZE ) )
+  {
+    m_bEndOfFile = true;
+    return false;
+  }
+  const UChar* pcHeader  = header;
+  const Int    iPOC      = Int( readValue( pcHeader, 4 ) );
+  const UInt   uiSize    = readValue( pcHeader, 4 );
+
+  std::vector<UChar> payload( uiSize + 1 );
+  if ( !m_cFile.read( reinterpret_cast<Char*>( &payload[0] ), uiSize ) )
+  {
+    m_bEndOfFile = true;
+    return false;
+  }
+
+  TEncCuAnalysisUnit* pcUnits = new TEncCuAnalysisUnit[m_uiNumCtus * m_uiNumPartInCtu];
+  const UChar*        pcData  = &payload[0];
+  const UChar*        pcEnd   = pcData + uiSize;
+  Bool                bValid  = true;
+
+  for ( UInt uiCtuAddr = 0; uiCtuAddr < m_uiNumCtus && bValid; uiCtuAddr++ )
+  {
+    TEncCuAnalysisUnit* pcCtu = pcUnits + uiCtuAddr * m_uiNumPartInCtu;
+
+    for ( UInt uiPartIdx = 0; uiPartIdx < m_uiNumPartInCtu && bValid; )
+    {
+      if ( pcData >= pcEnd )
+      {
+        bValid = false;
+        break;
+      }
+      const UInt uiCode     = readValue( pcData, 1 );
+      const UInt uiDepth    = uiCode & 7;
+      const UInt uiNumParts = m_uiNumPartInCtu >> ( uiDepth << 1 );
+      if ( uiNumParts == 0 || ( uiNumParts << ( uiDepth << 1 ) ) != m_uiNumPartInCtu || uiPartIdx % uiNumParts != 0 )
+      {
+        bValid = false;
+        break;
+      }
+
+      TEncCuAnalysisUnit cCU;
+      cCU.depth     = UChar( uiDepth );
+      cCU.partSize  = UChar( ( uiCode >> 3 ) & 7 );
+      cCU.predMode  = UChar( ( uiCode >> 6 ) & 1 );
+      cCU.skipFlag  = UChar( uiCode >> 7 );
+      cCU.mergeFlag = 0;
+      cCU.mergeIdx  = 0;
+      cCU.interDir  = 0;
+      for ( UInt uiList = 0; uiList < NUM_REF_PIC_LIST_01; uiList++ )
+      {
+        cCU.refIdx[uiList] = NOT_VALID;
+        cCU.mv[uiList][0]  = 0;
+        cCU.mv[uiList][1]  = 0;
+      }
+
+      // prediction units in the order they were saved
+      TEncCuAnalysisUnit acPU[4] = { cCU, cCU, cCU, cCU };
+      if ( cCU.predMode == MODE_INTER )
+      {
+        const UInt uiNumPUs = ( cCU.partSize == SIZE_2Nx2N ) ? 1 : ( cCU.partSize == SIZE_NxN ) ? 4 : 2;
+        for ( UInt uiPU = 0; uiPU < uiNumPUs && bValid; uiPU++ )
+        {
+          if ( pcData >= pcEnd )
+          {
+            bValid = false;
+            break;
+          }
+          const UInt uiPUCode = readValue( pcData, 1 );
+          acPU[uiPU].mergeFlag = UChar( uiPUCode & 1 );
+          acPU[uiPU].mergeIdx  = UChar( ( uiPUCode >> 1 ) & 7 );
+          acPU[uiPU].interDir  = UChar( uiPUCode >> 4 );
+          if ( acPU[uiPU].interDir < 1 || acPU[uiPU].interDir > 3 || acPU[uiPU].mergeIdx >= MRG_MAX_NUM_CANDS )
+          {
+            bValid = false;
+            break;
+          }
+          for ( UInt uiList = 0; uiList < NUM_REF_PIC_LIST_01; uiList++ )
+          {
+            if ( acPU[uiPU].interDir & ( 1 << uiList ) )
+            {
+              if ( pcEnd - pcData < 5 )
+              {
+                bValid = false;
+                break;
+              }
+              acPU[uiPU].refIdx[uiList] = Char( readValue( pcData, 1 ) );
+              acPU[uiPU].mv[uiList][0]  = Short( readValue( pcData, 2 ) );
+              acPU[uiPU].mv[uiList][1]  = Short( readValue( pcData, 2 ) );
+            }
+          }
+        }
+      }
+
+      for ( UInt uiPart = 0; uiPart < uiNumParts; uiPart++ )
+      {
+        pcCtu[uiPartIdx + uiPart] = acPU[xGetPuIdx( cCU.partSize, uiPart, uiNumParts )];
+      }
+      uiPartIdx += uiNumParts;
+    }
+  }
+
+  if ( !bValid || pcData != pcEnd )
+  {
+    delete [] pcUnits;
+    m_bEndOfFile = true;
+    return false;
+  }
+
+  Picture& rcPicture = m_pictures[iPOC];
+  delete [] rcPicture.pcUnits;
+  rcPicture.pcUnits    = pcUnits;
+  rcPicture.iUsersLeft = m_iNumUsers;
+  return true;
+}
+
+//! \}
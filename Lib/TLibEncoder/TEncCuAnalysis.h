@@ -0,0 +1,128 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2014, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncCuAnalysis.h
+    \brief    store of final CU decisions used as search hints by other encodes (header)
+*/
+
+#ifndef __TENCCUANALYSIS__
+#define __TENCCUANALYSIS__
+
+#include <map>
+#include <fstream>
+#include <string>
+
+#include "TLibCommon/CommonDef.h"
+#include "TLibCommon/TComPic.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// final decisions of one minimum partition of a CTU
+struct TEncCuAnalysisUnit
+{
+  UChar depth;                                  ///< CU depth
+  UChar partSize;                               ///< PartSize of the CU
+  UChar predMode;                               ///< PredMode of the CU
+  UChar skipFlag;
+  UChar mergeFlag;
+  UChar mergeIdx;
+  UChar interDir;                               ///< 1: list 0, 2: list 1, 3: bi-prediction
+  Char  refIdx[NUM_REF_PIC_LIST_01];
+  Short mv    [NUM_REF_PIC_LIST_01][2];         ///< horizontal and vertical MV in quarter samples
+};
+
+/**
+ * Per-picture store of the final CU decisions of an encode.
+ *
+ * The encoder that produces the decisions stores each picture when it has been coded, before its motion
+ * field is compressed. Encoders of the same source that use the decisions look them up by POC and CTU
+ * address and release the picture once it has been coded. A picture is freed when all of its users have
+ * released it.
+ *
+ * The decisions can also be saved to an analysis file, which a later encode of the same source loads
+ * picture by picture as it looks them up. The file starts with a header (the characters "HMCA", the
+ * format version, the number of CTUs of a picture and of minimum partitions of a CTU, all 32 bit),
+ * followed by one record per picture (POC, payload size, payload). The payload lists the CUs of each CTU
+ * in z-scan order, one byte each (depth, partition size, prediction mode, skip flag), followed for inter
+ * CUs by each prediction unit (merge flag and index, inter direction, reference index and MV for each
+ * list used). Multi-byte values are little endian.
+ */
+class TEncCuAnalysis
+{
+private:
+  /// decisions of one picture
+  struct Picture
+  {
+    TEncCuAnalysisUnit* pcUnits;                ///< m_uiNumCtus * m_uiNumPartInCtu units in z-scan order per CTU
+    Int                 iUsersLeft;             ///< number of encoders that have not released the picture
+  };
+
+  UInt                  m_uiNumCtus;
+  UInt                  m_uiNumPartInCtu;
+  Int                   m_iNumUsers;            ///< number of encoders using each picture, 0: pictures are only saved to the file
+  std::map<Int, Picture> m_pictures;            ///< stored pictures by POC
+
+  std::fstream          m_cFile;                ///< analysis file
+  Bool                  m_bLoadFile;            ///< pictures are loaded from the file, otherwise stored pictures are saved to it
+  Bool                  m_bEndOfFile;
+
+  Void  xSavePicture   ( Int iPOC, const TEncCuAnalysisUnit* pcUnits );
+  Bool  xLoadPicture   ();
+  UInt  xGetPuIdx      ( UInt uiPartSize, UInt uiPartIdx, UInt uiNumParts ) const;
+
+public:
+  TEncCuAnalysis();
+  virtual ~TEncCuAnalysis();
+
+  Void  create         ( UInt uiNumCtus, UInt uiNumPartInCtu, Int iNumUsers );
+  Void  destroy        ();
+
+  /// open an analysis file after create(), false if it cannot be opened or was saved for another picture or CTU size
+  Bool  openFile       ( const std::string& fileName, Bool bLoad );
+
+  /// copy the decisions of all CTUs of a coded picture
+  Void  storePicture   ( TComPic* pcPic );
+  /// get the decisions of a CTU, NULL if the picture is neither stored nor in the analysis file
+  const TEncCuAnalysisUnit* getCtu( Int iPOC, UInt uiCtuAddr );
+  /// called by each user once it has coded the picture
+  Void  releasePicture ( Int iPOC );
+};
+
+//! \}
+
+#endif // __TENCCUANALYSIS__
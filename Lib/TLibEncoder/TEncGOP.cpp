@@ -42,6 +42,7 @@
 #include "TEncTop.h"
 #include "TEncGOP.h"
 #include "TEncAnalyze.h"
+#include "TEncPicQuality.h"
 #include "libmd5/MD5.h"
 #include "TLibCommon/SEI.h"
 #include "TLibCommon/NAL.h"
@@ -78,6 +79,7 @@ Int getLSB(Int poc, Int maxLSB)
 TEncGOP::TEncGOP()
 {
   m_iLastIDR            = 0;
+  m_iLastSceneCutPOC    = 0;
   m_iGopSize            = 0;
   m_iNumPicCoded        = 0; //Niko
   m_bFirst              = true;
@@ -694,9 +696,9 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     Int iTimeOffset;
     Int pocCurr;
 
-    if(iPOCLast == 0) //case first frame or first top field
+    if(iPOCLast == m_iLastSceneCutPOC) //case first frame or first top field, or first picture of a new scene
     {
-      pocCurr=0;
+      pocCurr=iPOCLast;
       iTimeOffset = 1;
     }
     else if(iPOCLast == 1 && isField) //case first bottom field, just like the first frame, the poc computation is not right anymore, we set the right value
@@ -710,7 +712,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       iTimeOffset = m_pcCfg->getGOPEntry(iGOPid).m_POC;
     }
 
-    if(pocCurr>=m_pcCfg->getFramesToBeEncoded())
+    if(pocCurr>=m_pcCfg->getFramesToBeEncoded() || pocCurr>iPOCLast) // end of sequence, or GOP shortened by a scene cut
     {
 #if EFFICIENT_FIELD_IRAP
       if(IRAPtoReorder)
@@ -1098,6 +1100,7 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
           {
             bits = 200;
           }
+          bits = m_pcRateCtrl->getRCPic()->clipTargetBitsToCpb( bits );
           m_pcRateCtrl->getRCPic()->setTargetBits( bits );
         }
 
@@ -1882,8 +1885,22 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       }
     } // end iteration over slices
 
+    // hand the CU decisions over to other encodes of the source before the motion field is compressed
+    if ( m_pcEncTop->getCuAnalysisOutput() != NULL )
+    {
+      m_pcEncTop->getCuAnalysisOutput()->storePicture( pcPic );
+    }
+    if ( m_pcEncTop->getCuAnalysisInput() != NULL )
+    {
+      m_pcEncTop->getCuAnalysisInput()->releasePicture( pcPic->getPOC() );
+    }
+
     pcPic->compressMotion();
 
+    // the reconstruction is final: extend its margins so that it is available as a reference
+    pcPic->getPicYuvRec()->setBorderExtension(false);
+    pcPic->getPicYuvRec()->extendPicBorder();
+
     //-- For time output for each slice
     Double dEncTime = (Double)(clock()-iBeforeTime) / CLOCKS_PER_SEC;
 
@@ -1895,19 +1912,19 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       if(m_pcCfg->getDecodedPictureHashSEIEnabled() == 1)
       {
         sei_recon_picture_digest.method = SEIDecodedPictureHash::MD5;
-        UInt numChar=calcMD5(*pcPic->getPicYuvRec(), sei_recon_picture_digest.m_digest);
+        UInt numChar=calcMD5(*pcPic->getPicYuvRec(), sei_recon_picture_digest.m_digest, m_pcCfg->getParallelPictureHash());
         digestStr = digestToString(sei_recon_picture_digest.m_digest, numChar);
       }
       else if(m_pcCfg->getDecodedPictureHashSEIEnabled() == 2)
       {
         sei_recon_picture_digest.method = SEIDecodedPictureHash::CRC;
-        UInt numChar=calcCRC(*pcPic->getPicYuvRec(), sei_recon_picture_digest.m_digest);
+        UInt numChar=calcCRC(*pcPic->getPicYuvRec(), sei_recon_picture_digest.m_digest, m_pcCfg->getParallelPictureHash());
         digestStr = digestToString(sei_recon_picture_digest.m_digest, numChar);
       }
       else if(m_pcCfg->getDecodedPictureHashSEIEnabled() == 3)
       {
         sei_recon_picture_digest.method = SEIDecodedPictureHash::CHECKSUM;
-        UInt numChar=calcChecksum(*pcPic->getPicYuvRec(), sei_recon_picture_digest.m_digest);
+        UInt numChar=calcChecksum(*pcPic->getPicYuvRec(), sei_recon_picture_digest.m_digest, m_pcCfg->getParallelPictureHash());
         digestStr = digestToString(sei_recon_picture_digest.m_digest, numChar);
       }
       OutputNALUnit nalu(NAL_UNIT_SUFFIX_SEI, pcSlice->getTLayer());
@@ -2022,6 +2039,11 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       m_pcRateCtrl->getRCPic()->addToPictureLsit( m_pcRateCtrl->getPicList() );
 
       m_pcRateCtrl->getRCSeq()->updateAfterPic( actualTotalBits );
+      if ( m_pcRateCtrl->getRCSeq()->getUseCpb() )
+      {
+        Bool noUnderflow = m_pcRateCtrl->getRCSeq()->updateCpbAfterPic( actualTotalBits );
+        printf( " [CPB %d bits%s]", m_pcRateCtrl->getRCSeq()->getCpbFullness(), noUnderflow ? "" : ", underflow" );
+      }
       if ( pcSlice->getSliceType() != I_SLICE )
       {
         m_pcRateCtrl->getRCGOP()->updateAfterPicture( actualTotalBits );
@@ -2204,6 +2226,13 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     xResetNonNestedSEIPresentFlags();
     xResetNestedSEIPresentFlags();
 
+    // the access unit is complete: hand it to the sink straight away instead of keeping it until the end of the GOP
+    if ( m_pcEncTop->getAccessUnitSink() )
+    {
+      m_pcEncTop->getAccessUnitSink()->accessUnitEncoded( accessUnit );
+      accessUnitsInGOP.pop_back();
+    }
+
     pcPic->getPicYuvRec()->copyToPic(pcPicYuvRecOut);
 
     pcPic->setReconMark   ( true );
@@ -2271,6 +2300,10 @@ Void TEncGOP::printOutSummary(UInt uiNumAllPicCoded, Bool isField, const Bool pr
   //-- all
   printf( "\n\nSUMMARY --------------------------------------------------------\n" );
   m_gcAnalyzeAll.printOut('a', chFmt, printMSEBasedSNR, printSequenceMSE);
+  if (m_pcCfg->getPrintSSIM())
+  {
+    m_gcAnalyzeAll.printOutSSIM(chFmt);
+  }
 
   printf( "\n\nI Slices--------------------------------------------------------\n" );
   m_gcAnalyzeI.printOut('i', chFmt, printMSEBasedSNR, printSequenceMSE);
@@ -2335,7 +2368,7 @@ Void TEncGOP::xInitGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rcLis
 {
   assert( iNumPicRcvd > 0 );
   //  Exception for the first frames
-  if ( ( isField && (iPOCLast == 0 || iPOCLast == 1) ) || (!isField  && (iPOCLast == 0))  )
+  if ( ( isField && (iPOCLast == 0 || iPOCLast == 1) ) || (!isField  && (iPOCLast == m_iLastSceneCutPOC))  )
   {
     m_iGopSize    = 1;
   }
@@ -2400,24 +2433,11 @@ UInt64 TEncGOP::xFindDistortionFrame (TComPicYuv* pcPic0, TComPicYuv* pcPic1)
   for(Int chan=0; chan<pcPic0 ->getNumberValidComponents(); chan++)
   {
     const ComponentID ch=ComponentID(chan);
-    Pel*  pSrc0   = pcPic0 ->getAddr(ch);
-    Pel*  pSrc1   = pcPic1 ->getAddr(ch);
-    UInt  uiShift     = 2 * DISTORTION_PRECISION_ADJUSTMENT(g_bitDepth[toChannelType(ch)]-8);
+    const Int   bitDepth = g_bitDepth[toChannelType(ch)];
+    UInt  uiShift     = 2 * DISTORTION_PRECISION_ADJUSTMENT(bitDepth-8);
 
-    const Int   iStride = pcPic0->getStride(ch);
-    const Int   iWidth  = pcPic0->getWidth(ch);
-    const Int   iHeight = pcPic0->getHeight(ch);
-
-    for(Int y = 0; y < iHeight; y++ )
-    {
-      for(Int x = 0; x < iWidth; x++ )
-      {
-        Intermediate_Int iTemp = pSrc0[x] - pSrc1[x];
-        uiTotalDiff += UInt64((iTemp*iTemp) >> uiShift);
-      }
-      pSrc0 += iStride;
-      pSrc1 += iStride;
-    }
+    uiTotalDiff += TEncPicQuality::calcSSE( pcPic0->getAddr(ch), pcPic0->getStride(ch), pcPic1->getAddr(ch), pcPic1->getStride(ch),
+                                            pcPic0->getWidth(ch), pcPic0->getHeight(ch), bitDepth, uiShift );
   }
 
   return uiTotalDiff;
@@ -2478,29 +2498,20 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
   //===== calculate PSNR =====
   Double MSEyuvframe[MAX_NUM_COMPONENT] = {0, 0, 0};
 
+  const Bool printSSIM = m_pcCfg->getPrintSSIM();
+  TEncPicQualityResult cQuality;
+  TEncPicQuality::calcPicture( (conversion!=IPCOLOURSPACE_UNCHANGED) ? pcPic->getPicYuvTrueOrg() : pcPic->getPicYuvOrg(), &picd,
+                               m_pcEncTop->getPad(0), m_pcEncTop->getPad(1), printSSIM, m_pcCfg->getParallelQualityMetrics(), cQuality );
+
   for(Int chan=0; chan<pcPicD->getNumberValidComponents(); chan++)
   {
     const ComponentID ch=ComponentID(chan);
-    const Pel*  pOrg    = (conversion!=IPCOLOURSPACE_UNCHANGED) ? pcPic ->getPicYuvTrueOrg()->getAddr(ch) : pcPic ->getPicYuvOrg()->getAddr(ch);
-    Pel*  pRec    = picd.getAddr(ch);
-    const Int   iStride = pcPicD->getStride(ch);
-
     const Int   iWidth  = pcPicD->getWidth (ch) - (m_pcEncTop->getPad(0) >> pcPic->getComponentScaleX(ch));
     const Int   iHeight = pcPicD->getHeight(ch) - (m_pcEncTop->getPad(1) >> pcPic->getComponentScaleY(ch));
 
     Int   iSize   = iWidth*iHeight;
 
-    UInt64 uiSSDtemp=0;
-    for(Int y = 0; y < iHeight; y++ )
-    {
-      for(Int x = 0; x < iWidth; x++ )
-      {
-        Intermediate_Int iDiff = (Intermediate_Int)( pOrg[x] - pRec[x] );
-        uiSSDtemp   += iDiff * iDiff;
-      }
-      pOrg += iStride;
-      pRec += iStride;
-    }
+    const UInt64 uiSSDtemp = cQuality.uiSSE[ch];
     const Int maxval = 255 << (g_bitDepth[toChannelType(ch)] - 8);
     const Double fRefValue = (Double) maxval * maxval * iSize;
     dPSNR[ch]         = ( uiSSDtemp ? 10.0 * log10( fRefValue / (Double)uiSSDtemp ) : 999.99 );
@@ -2529,19 +2540,20 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
   m_vRVM_RP.push_back( uibits );
 
   //===== add PSNR =====
-  m_gcAnalyzeAll.addResult (dPSNR, (Double)uibits, MSEyuvframe);
+  const Double* pdSSIM = printSSIM ? cQuality.dSSIM : NULL;
+  m_gcAnalyzeAll.addResult (dPSNR, (Double)uibits, MSEyuvframe, pdSSIM);
   TComSlice*  pcSlice = pcPic->getSlice(0);
   if (pcSlice->isIntra())
   {
-    m_gcAnalyzeI.addResult (dPSNR, (Double)uibits, MSEyuvframe);
+    m_gcAnalyzeI.addResult (dPSNR, (Double)uibits, MSEyuvframe, pdSSIM);
   }
   if (pcSlice->isInterP())
   {
-    m_gcAnalyzeP.addResult (dPSNR, (Double)uibits, MSEyuvframe);
+    m_gcAnalyzeP.addResult (dPSNR, (Double)uibits, MSEyuvframe, pdSSIM);
   }
   if (pcSlice->isInterB())
   {
-    m_gcAnalyzeB.addResult (dPSNR, (Double)uibits, MSEyuvframe);
+    m_gcAnalyzeB.addResult (dPSNR, (Double)uibits, MSEyuvframe, pdSSIM);
   }
 
   Char c = (pcSlice->isIntra() ? 'I' : pcSlice->isInterP() ? 'P' : 'B');
@@ -2569,6 +2581,10 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
   {
     printf(" [Y MSE %6.4lf  U MSE %6.4lf  V MSE %6.4lf]", MSEyuvframe[COMPONENT_Y], MSEyuvframe[COMPONENT_Cb], MSEyuvframe[COMPONENT_Cr] );
   }
+  if (printSSIM)
+  {
+    printf(" [SSIM Y %6.4lf  U %6.4lf  V %6.4lf]", cQuality.dSSIM[COMPONENT_Y], cQuality.dSSIM[COMPONENT_Cb], cQuality.dSSIM[COMPONENT_Cr] );
+  }
   printf(" [ET %5.0f ]", dEncTime );
 
 #if JH_IS_DEBUGING
@@ -2641,21 +2657,10 @@ Void TEncGOP::xCalculateInterlacedAddPSNR( TComPic* pcPicOrgFirstField, TComPic*
       TComPic *pcPic=apcPicOrgFields[fieldNum];
       TComPicYuv *pcPicD=apcPicRecFields[fieldNum];
 
-      const Pel*  pOrg    = (conversion!=IPCOLOURSPACE_UNCHANGED) ? pcPic ->getPicYuvTrueOrg()->getAddr(ch) : pcPic ->getPicYuvOrg()->getAddr(ch);
-      Pel*  pRec    = pcPicD->getAddr(ch);
-      const Int   iStride = pcPicD->getStride(ch);
-
+      const TComPicYuv *pcPicOrg = (conversion!=IPCOLOURSPACE_UNCHANGED) ? pcPic->getPicYuvTrueOrg() : pcPic->getPicYuvOrg();
 
-      for(Int y = 0; y < iHeight; y++ )
-      {
-        for(Int x = 0; x < iWidth; x++ )
-        {
-          Intermediate_Int iDiff = (Intermediate_Int)( pOrg[x] - pRec[x] );
-          uiSSDtemp   += iDiff * iDiff;
-        }
-        pOrg += iStride;
-        pRec += iStride;
-      }
+      uiSSDtemp += TEncPicQuality::calcSSE( pcPicOrg->getAddr(ch), pcPicOrg->getStride(ch), pcPicD->getAddr(ch), pcPicD->getStride(ch),
+                                            iWidth, iHeight, g_bitDepth[toChannelType(ch)] );
     }
     const Int maxval = 255 << (g_bitDepth[toChannelType(ch)] - 8);
     const Double fRefValue = (Double) maxval * maxval * iSize*2;
@@ -2691,6 +2696,11 @@ NalUnitType TEncGOP::getNalUnitType(Int pocCurr, Int lastIDR, Bool isField)
   {
     return NAL_UNIT_CODED_SLICE_IDR_W_RADL;
   }
+  if (pocCurr == m_iLastSceneCutPOC)
+  {
+    // the first picture of a new scene is always a random access point
+    return (m_pcCfg->getDecodingRefreshType() == 1) ? NAL_UNIT_CODED_SLICE_CRA : NAL_UNIT_CODED_SLICE_IDR_W_RADL;
+  }
 
 #if EFFICIENT_FIELD_IRAP
   if(isField && pocCurr == 1)
@@ -2701,9 +2711,9 @@ NalUnitType TEncGOP::getNalUnitType(Int pocCurr, Int lastIDR, Bool isField)
 #endif
 
 #if ALLOW_RECOVERY_POINT_AS_RAP
-  if(m_pcCfg->getDecodingRefreshType() != 3 && (pocCurr - isField) % m_pcCfg->getIntraPeriod() == 0)
+  if(m_pcCfg->getDecodingRefreshType() != 3 && (pocCurr - m_iLastSceneCutPOC - isField) % m_pcCfg->getIntraPeriod() == 0)
 #else
-  if ((pocCurr - isField) % m_pcCfg->getIntraPeriod() == 0)
+  if ((pocCurr - m_iLastSceneCutPOC - isField) % m_pcCfg->getIntraPeriod() == 0)
 #endif
   {
     if (m_pcCfg->getDecodingRefreshType() == 1)
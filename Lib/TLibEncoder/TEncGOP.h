@@ -77,6 +77,7 @@ private:
   UInt                    m_ltRefPicPocLsbSps[MAX_NUM_LONG_TERM_REF_PICS];
   Bool                    m_ltRefPicUsedByCurrPicFlag[MAX_NUM_LONG_TERM_REF_PICS];
   Int                     m_iLastIDR;
+  Int                     m_iLastSceneCutPOC;             ///< POC of the picture starting the current scene (0 if no cut was detected)
   Int                     m_iGopSize;
   Int                     m_iNumPicCoded;
   Bool                    m_bFirst;
@@ -126,6 +127,13 @@ private:
   Bool                    m_pictureTimingSEIPresentInAU;
   Bool                    m_nestedBufferingPeriodSEIPresentInAU;
   Bool                    m_nestedPictureTimingSEIPresentInAU;
+
+  // quality and rate statistics of the sequence (kept per encoder, so that several encoders can run in one process)
+  TEncAnalyze             m_gcAnalyzeAll;
+  TEncAnalyze             m_gcAnalyzeI;
+  TEncAnalyze             m_gcAnalyzeP;
+  TEncAnalyze             m_gcAnalyzeB;
+  TEncAnalyze             m_gcAnalyzeAll_in;
 public:
   TEncGOP();
   virtual ~TEncGOP();
@@ -140,6 +148,8 @@ public:
 
 
   Int   getGOPSize()          { return  m_iGopSize;  }
+  Int   getLastSceneCutPOC()  { return  m_iLastSceneCutPOC; }
+  Void  setLastSceneCutPOC( Int poc ) { m_iLastSceneCutPOC = poc; }
 
   TComList<TComPic*>*   getListPic()      { return m_pcListPic; }
 
@@ -0,0 +1,275 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2014, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncPicQuality.cpp
+    \brief    objective quality measurement of reconstructed pictures
+*/
+
+#include <vector>
+#include <algorithm>
+
+#include "TEncPicQuality.h"
+
+#if SIMD_SSE2
+#include <emmintrin.h>
+#endif
+#if ENABLE_WORKER_THREADS
+#include <thread>
+#endif
+
+//! \ingroup TLibEncoder
+//! \{
+
+// ====================================================================================================================
+// Local functions
+// ====================================================================================================================
+
+/// sums over a 4x4 block, used to build the 8x8 SSIM windows
+struct SSIMBlockSums
+{
+  UInt64 uiSumOrg;
+  UInt64 uiSumRec;
+  UInt64 uiSumSq;     ///< sum of the squares of both blocks
+  UInt64 uiSumCross;
+};
+
+static Void xCalcSSIMBlockSums( const Pel* pOrg, Int iOrgStride, const Pel* pRec, Int iRecStride, Int iNumBlocks, SSIMBlockSums* pSums )
+{
+  for ( Int bx = 0; bx < iNumBlocks; bx++, pOrg += 4, pRec += 4 )
+  {
+    UInt64 uiSumOrg = 0, uiSumRec = 0, uiSumSq = 0, uiSumCross = 0;
+    for ( Int y = 0; y < 4; y++ )
+    {
+      for ( Int x = 0; x < 4; x++ )
+      {
+        const UInt64 a = pOrg[y * iOrgStride + x];
+        const UInt64 b = pRec[y * iRecStride + x];
+        uiSumOrg   += a;
+        uiSumRec   += b;
+        uiSumSq    += a * a + b * b;
+        uiSumCross += a * b;
+      }
+    }
+    pSums[bx].uiSumOrg   = uiSumOrg;
+    pSums[bx].uiSumRec   = uiSumRec;
+    pSums[bx].uiSumSq    = uiSumSq;
+    pSums[bx].uiSumCross = uiSumCross;
+  }
+}
+
+/** Measure one component of a picture
+ * \param compID   component to measure
+ * \param pcResult receives the SSE and, with bCalcSSIM, the SSIM of the component
+ */
+static Void xCalcComponentQuality( const TComPicYuv* pcOrg, const TComPicYuv* pcRec, ComponentID compID, Int iPadX, Int iPadY, Bool bCalcSSIM, TEncPicQualityResult* pcResult )
+{
+  const Int iWidth   = pcRec->getWidth (compID) - (iPadX >> pcRec->getComponentScaleX(compID));
+  const Int iHeight  = pcRec->getHeight(compID) - (iPadY >> pcRec->getComponentScaleY(compID));
+  const Int bitDepth = g_bitDepth[toChannelType(compID)];
+
+  pcResult->uiSSE[compID] = TEncPicQuality::calcSSE( pcOrg->getAddr(compID), pcOrg->getStride(compID), pcRec->getAddr(compID), pcRec->getStride(compID), iWidth, iHeight, bitDepth );
+  if ( bCalcSSIM )
+  {
+    pcResult->dSSIM[compID] = TEncPicQuality::calcSSIM( pcOrg->getAddr(compID), pcOrg->getStride(compID), pcRec->getAddr(compID), pcRec->getStride(compID), iWidth, iHeight, bitDepth );
+  }
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** Sum of squared differences
+ * \param pOrg       top-left sample of the original block
+ * \param iOrgStride stride of pOrg
+ * \param pRec       top-left sample of the reconstructed block
+ * \param iRecStride stride of pRec
+ * \param iWidth     block width
+ * \param iHeight    block height
+ * \param bitDepth   bit depth of the samples
+ * \param uiShift    right shift applied to each squared difference
+ */
+UInt64 TEncPicQuality::calcSSE( const Pel* pOrg, Int iOrgStride, const Pel* pRec, Int iRecStride, Int iWidth, Int iHeight, Int bitDepth, UInt uiShift )
+{
+  UInt64 uiTotal = 0;
+
+#if SIMD_SSE2 && !RExt__HIGH_BIT_DEPTH_SUPPORT
+  // with up to 12-bit samples each 32-bit lane gains less than 2^25 per 8 samples, so 64 iterations cannot overflow it
+  if ( uiShift == 0 && bitDepth <= 12 )
+  {
+    const __m128i vZero  = _mm_setzero_si128();
+    __m128i       vTotal = vZero;
+    const Int     iWidth8 = iWidth & ~7;
+
+    for ( Int y = 0; y < iHeight; y++, pOrg += iOrgStride, pRec += iRecStride )
+    {
+      Int x = 0;
+      while ( x < iWidth8 )
+      {
+        const Int iEnd = std::min( iWidth8, x + 8 * 64 );
+        __m128i   vSum = vZero;
+        for ( ; x < iEnd; x += 8 )
+        {
+          const __m128i vDiff = _mm_sub_epi16( _mm_loadu_si128( (const __m128i*)( pOrg + x ) ), _mm_loadu_si128( (const __m128i*)( pRec + x ) ) );
+          vSum = _mm_add_epi32( vSum, _mm_madd_epi16( vDiff, vDiff ) );
+        }
+        vTotal = _mm_add_epi64( vTotal, _mm_unpacklo_epi32( vSum, vZero ) );
+        vTotal = _mm_add_epi64( vTotal, _mm_unpackhi_epi32( vSum, vZero ) );
+      }
+      for ( ; x < iWidth; x++ )
+      {
+        const Int iDiff = pOrg[x] - pRec[x];
+        uiTotal += UInt64( iDiff * iDiff );
+      }
+    }
+
+    vTotal = _mm_add_epi64( vTotal, _mm_unpackhi_epi64( vTotal, vTotal ) );
+    UInt64 uiSimdTotal;
+    _mm_storel_epi64( (__m128i*)&uiSimdTotal, vTotal );
+    return uiTotal + uiSimdTotal;
+  }
+#endif
+
+  for ( Int y = 0; y < iHeight; y++, pOrg += iOrgStride, pRec += iRecStride )
+  {
+    for ( Int x = 0; x < iWidth; x++ )
+    {
+      const Intermediate_Int iDiff = pOrg[x] - pRec[x];
+      uiTotal += UInt64( ( iDiff * iDiff ) >> uiShift );
+    }
+  }
+  return uiTotal;
+}
+
+/** Mean SSIM over 8x8 windows placed every 4 samples in each direction
+ * \param pOrg       top-left sample of the original block
+ * \param iOrgStride stride of pOrg
+ * \param pRec       top-left sample of the reconstructed block
+ * \param iRecStride stride of pRec
+ * \param iWidth     block width
+ * \param iHeight    block height
+ * \param bitDepth   bit depth of the samples
+ * \returns SSIM in [-1, 1]; 1 if the block is smaller than one window
+ */
+Double TEncPicQuality::calcSSIM( const Pel* pOrg, Int iOrgStride, const Pel* pRec, Int iRecStride, Int iWidth, Int iHeight, Int bitDepth )
+{
+  const Int iNumBlocksX = iWidth  >> 2;
+  const Int iNumBlocksY = iHeight >> 2;
+  if ( iNumBlocksX < 2 || iNumBlocksY < 2 )
+  {
+    return 1.0;
+  }
+
+  const Double dMaxVal = Double( ( 1 << bitDepth ) - 1 );
+  const Double dC1     = ( 0.01 * dMaxVal ) * ( 0.01 * dMaxVal );
+  const Double dC2     = ( 0.03 * dMaxVal ) * ( 0.03 * dMaxVal );
+  const Double dScale  = 1.0 / 64.0;
+
+  // block sums of the previous and current row of 4x4 blocks
+  std::vector<SSIMBlockSums> acSums[2];
+  acSums[0].resize( iNumBlocksX );
+  acSums[1].resize( iNumBlocksX );
+
+  Double dSSIMSum = 0;
+  for ( Int by = 0; by < iNumBlocksY; by++ )
+  {
+    SSIMBlockSums* pCurr = &acSums[by & 1][0];
+    const SSIMBlockSums* pPrev = &acSums[( by + 1 ) & 1][0];
+    xCalcSSIMBlockSums( pOrg + 4 * by * iOrgStride, iOrgStride, pRec + 4 * by * iRecStride, iRecStride, iNumBlocksX, pCurr );
+    if ( by == 0 )
+    {
+      continue;
+    }
+
+    for ( Int bx = 0; bx < iNumBlocksX - 1; bx++ )
+    {
+      const Double dSumOrg   = Double( pPrev[bx].uiSumOrg   + pPrev[bx + 1].uiSumOrg   + pCurr[bx].uiSumOrg   + pCurr[bx + 1].uiSumOrg   );
+      const Double dSumRec   = Double( pPrev[bx].uiSumRec   + pPrev[bx + 1].uiSumRec   + pCurr[bx].uiSumRec   + pCurr[bx + 1].uiSumRec   );
+      const Double dSumSq    = Double( pPrev[bx].uiSumSq    + pPrev[bx + 1].uiSumSq    + pCurr[bx].uiSumSq    + pCurr[bx + 1].uiSumSq    );
+      const Double dSumCross = Double( pPrev[bx].uiSumCross + pPrev[bx + 1].uiSumCross + pCurr[bx].uiSumCross + pCurr[bx + 1].uiSumCross );
+
+      const Double dMeanOrg  = dSumOrg * dScale;
+      const Double dMeanRec  = dSumRec * dScale;
+      const Double dVarSum   = dSumSq * dScale - dMeanOrg * dMeanOrg - dMeanRec * dMeanRec;
+      const Double dCovar    = dSumCross * dScale - dMeanOrg * dMeanRec;
+
+      dSSIMSum += ( ( 2 * dMeanOrg * dMeanRec + dC1 ) * ( 2 * dCovar + dC2 ) )
+                / ( ( dMeanOrg * dMeanOrg + dMeanRec * dMeanRec + dC1 ) * ( dVarSum + dC2 ) );
+    }
+  }
+
+  return dSSIMSum / Double( ( iNumBlocksX - 1 ) * ( iNumBlocksY - 1 ) );
+}
+
+/** Measure all valid components of a reconstructed picture
+ * \param pcOrg     original picture
+ * \param pcRec     reconstructed picture
+ * \param iPadX     luma samples of padding at the right edge, excluded from the measurement
+ * \param iPadY     luma samples of padding at the bottom edge, excluded from the measurement
+ * \param bCalcSSIM also calculate the SSIM of each component
+ * \param bParallel measure the chroma planes on worker threads
+ * \param rcResult  returns the measurements
+ */
+Void TEncPicQuality::calcPicture( const TComPicYuv* pcOrg, const TComPicYuv* pcRec, Int iPadX, Int iPadY, Bool bCalcSSIM, Bool bParallel, TEncPicQualityResult& rcResult )
+{
+  const UInt numComp = pcRec->getNumberValidComponents();
+
+  for ( UInt comp = 0; comp < MAX_NUM_COMPONENT; comp++ )
+  {
+    rcResult.uiSSE[comp] = 0;
+    rcResult.dSSIM[comp] = 0;
+  }
+
+#if ENABLE_WORKER_THREADS
+  if ( bParallel && numComp > 1 )
+  {
+    std::thread acWorkers[MAX_NUM_COMPONENT];
+    for ( UInt comp = 1; comp < numComp; comp++ )
+    {
+      acWorkers[comp] = std::thread( xCalcComponentQuality, pcOrg, pcRec, ComponentID( comp ), iPadX, iPadY, bCalcSSIM, &rcResult );
+    }
+    xCalcComponentQuality( pcOrg, pcRec, COMPONENT_Y, iPadX, iPadY, bCalcSSIM, &rcResult );
+    for ( UInt comp = 1; comp < numComp; comp++ )
+    {
+      acWorkers[comp].join();
+    }
+    return;
+  }
+#endif
+
+  for ( UInt comp = 0; comp < numComp; comp++ )
+  {
+    xCalcComponentQuality( pcOrg, pcRec, ComponentID( comp ), iPadX, iPadY, bCalcSSIM, &rcResult );
+  }
+}
+
+//! \}
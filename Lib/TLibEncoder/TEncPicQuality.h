@@ -0,0 +1,76 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2014, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TEncPicQuality.h
+    \brief    objective quality measurement of reconstructed pictures (header)
+*/
+
+#ifndef __TENCPICQUALITY__
+#define __TENCPICQUALITY__
+
+#include "TLibCommon/CommonDef.h"
+#include "TLibCommon/TComPicYuv.h"
+
+//! \ingroup TLibEncoder
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// per-component distortion of a picture against its original
+struct TEncPicQualityResult
+{
+  UInt64 uiSSE[MAX_NUM_COMPONENT];    ///< sum of squared errors
+  Double dSSIM[MAX_NUM_COMPONENT];    ///< mean SSIM over 8x8 windows spaced 4 samples apart, only if requested
+};
+
+/// picture quality measurement (SSE, SSIM)
+class TEncPicQuality
+{
+public:
+  /// sum of squared differences of two blocks, each square shifted right by uiShift
+  static UInt64 calcSSE  ( const Pel* pOrg, Int iOrgStride, const Pel* pRec, Int iRecStride, Int iWidth, Int iHeight, Int bitDepth, UInt uiShift = 0 );
+
+  /// mean structural similarity of two blocks
+  static Double calcSSIM ( const Pel* pOrg, Int iOrgStride, const Pel* pRec, Int iRecStride, Int iWidth, Int iHeight, Int bitDepth );
+
+  /** Measure every valid component of pcRec against pcOrg, skipping iPadX/iPadY luma samples of padding at the
+   *  right/bottom. With bParallel, the chroma planes are measured on worker threads (if ENABLE_WORKER_THREADS).
+   */
+  static Void   calcPicture( const TComPicYuv* pcOrg, const TComPicYuv* pcRec, Int iPadX, Int iPadY, Bool bCalcSSIM, Bool bParallel, TEncPicQualityResult& rcResult );
+};
+
+//! \}
+
+#endif // __TENCPICQUALITY__
@@ -40,14 +40,99 @@
 
 #include "TEncPreanalyzer.h"
 
+#if SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
 using namespace std;
 
 //! \ingroup TLibEncoder
 //! \{
 
+// ====================================================================================================================
+// Local functions
+// ====================================================================================================================
+
+/** Sum and sum of squares of the samples of a rectangular block
+ * \param pSrc     top-left sample of the block
+ * \param iStride  picture stride
+ * \param iWidth   block width
+ * \param iHeight  block height
+ * \param ruiSum   returns the sum of the samples
+ * \param ruiSumSq returns the sum of the squared samples
+ */
+static Void xCalcBlockMoments( const Pel* pSrc, Int iStride, Int iWidth, Int iHeight, UInt64& ruiSum, UInt64& ruiSumSq )
+{
+#if SIMD_SSE2 && !RExt__HIGH_BIT_DEPTH_SUPPORT
+  // 32-bit lane accumulators hold the squares of one 32-sample row of up to 12-bit data
+  if ( ( ( iWidth & 7 ) == 0 || iWidth == 4 ) && iWidth <= 32 && g_bitDepth[CHANNEL_TYPE_LUMA] <= 12 )
+  {
+    const __m128i vOne   = _mm_set1_epi16( 1 );
+    const __m128i vZero  = _mm_setzero_si128();
+    __m128i       vSum   = vZero;
+    __m128i       vSumSq = vZero;
+
+    for ( Int y = 0; y < iHeight; y++, pSrc += iStride )
+    {
+      __m128i vRowSq;
+      if ( iWidth == 4 )
+      {
+        const __m128i vSrc = _mm_loadl_epi64( (const __m128i*)pSrc );
+        vSum   = _mm_add_epi32( vSum, _mm_madd_epi16( vSrc, vOne ) );
+        vRowSq = _mm_madd_epi16( vSrc, vSrc );
+      }
+      else
+      {
+        vRowSq = vZero;
+        for ( Int x = 0; x < iWidth; x += 8 )
+        {
+          const __m128i vSrc = _mm_loadu_si128( (const __m128i*)( pSrc + x ) );
+          vSum   = _mm_add_epi32( vSum,   _mm_madd_epi16( vSrc, vOne ) );
+          vRowSq = _mm_add_epi32( vRowSq, _mm_madd_epi16( vSrc, vSrc ) );
+        }
+      }
+      vSumSq = _mm_add_epi64( vSumSq, _mm_unpacklo_epi32( vRowSq, vZero ) );
+      vSumSq = _mm_add_epi64( vSumSq, _mm_unpackhi_epi32( vRowSq, vZero ) );
+    }
+
+    vSum   = _mm_add_epi32( vSum, _mm_shuffle_epi32( vSum, 0x4e ) );
+    vSum   = _mm_add_epi32( vSum, _mm_shuffle_epi32( vSum, 0xb1 ) );
+    vSumSq = _mm_add_epi64( vSumSq, _mm_unpackhi_epi64( vSumSq, vSumSq ) );
+
+    UInt64 uiSumSq;
+    _mm_storel_epi64( (__m128i*)&uiSumSq, vSumSq );
+    ruiSum   = (UInt)_mm_cvtsi128_si32( vSum );
+    ruiSumSq = uiSumSq;
+    return;
+  }
+#endif
+
+  UInt64 uiSum   = 0;
+  UInt64 uiSumSq = 0;
+  for ( Int y = 0; y < iHeight; y++, pSrc += iStride )
+  {
+    for ( Int x = 0; x < iWidth; x++ )
+    {
+      uiSum   += pSrc[x];
+      uiSumSq += pSrc[x] * pSrc[x];
+    }
+  }
+  ruiSum   = uiSum;
+  ruiSumSq = uiSumSq;
+}
+
+// ====================================================================================================================
+// Constructor / destructor / create / destroy
+// ====================================================================================================================
+
 /** Constructor
  */
 TEncPreanalyzer::TEncPreanalyzer()
+: m_bUseWorkerThread( false )
+#if ENABLE_WORKER_THREADS
+, m_bWorkerBusy( false )
+, m_bTerminate( false )
+#endif
 {
 }
 
@@ -55,11 +140,91 @@ TEncPreanalyzer::TEncPreanalyzer()
  */
 TEncPreanalyzer::~TEncPreanalyzer()
 {
+  destroy();
+}
+
+/** Start the worker thread if requested
+ * \param bUseWorkerThread analyze pictures on a separate thread
+ */
+Void TEncPreanalyzer::create( Bool bUseWorkerThread )
+{
+#if ENABLE_WORKER_THREADS
+  m_bUseWorkerThread = bUseWorkerThread;
+  if ( m_bUseWorkerThread && !m_cWorker.joinable() )
+  {
+    m_bTerminate  = false;
+    m_bWorkerBusy = false;
+    m_cWorker     = std::thread( &TEncPreanalyzer::xWorkerLoop, this );
+  }
+#else
+  m_bUseWorkerThread = false;
+#endif
+}
+
+/** Finish the pending pictures and stop the worker thread
+ */
+Void TEncPreanalyzer::destroy()
+{
+#if ENABLE_WORKER_THREADS
+  if ( m_cWorker.joinable() )
+  {
+    {
+      std::lock_guard<std::mutex> cLock( m_cMutex );
+      m_bTerminate = true;
+    }
+    m_cJobAvailable.notify_one();
+    m_cWorker.join();
+  }
+#endif
+  m_bUseWorkerThread = false;
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** Analyze a source picture, either directly or by handing it over to the worker thread
+ * \param pcEPic Picture object to be analyzed
+ */
+Void TEncPreanalyzer::preanalyze( TEncPic* pcEPic )
+{
+#if ENABLE_WORKER_THREADS
+  if ( m_bUseWorkerThread )
+  {
+    {
+      std::lock_guard<std::mutex> cLock( m_cMutex );
+      m_cJobs.push_back( pcEPic );
+    }
+    m_cJobAvailable.notify_one();
+    return;
+  }
+#endif
+  xPreanalyze( pcEPic );
+}
+
+/** Block until all pictures handed over to preanalyze() have been analyzed
+ */
+Void TEncPreanalyzer::waitForCompletion()
+{
+#if ENABLE_WORKER_THREADS
+  if ( m_bUseWorkerThread )
+  {
+    std::unique_lock<std::mutex> cLock( m_cMutex );
+    while ( !m_cJobs.empty() || m_bWorkerBusy )
+    {
+      m_cJobsDone.wait( cLock );
+    }
+  }
+#endif
 }
 
 /** Analyze source picture and compute local image characteristics used for QP adaptation
  * \param pcEPic Picture object to be analyzed
  * \return Void
+ *
+ * The sums and sums of squares of the quadrants of all complete AQ parts are gathered in a single pass over the luma
+ * plane at the finest AQ depth and aggregated upwards for the coarser depths. Only the AQ parts cut by the right or
+ * bottom picture boundary, whose quadrants do not line up with the finer depth, are measured separately.
  */
 Void TEncPreanalyzer::xPreanalyze( TEncPic* pcEPic )
 {
@@ -68,55 +233,46 @@ Void TEncPreanalyzer::xPreanalyze( TEncPic* pcEPic )
   const Int iHeight = pcPicYuv->getHeight(COMPONENT_Y);
   const Int iStride = pcPicYuv->getStride(COMPONENT_Y);
 
+  xCalcQuadrantMoments( pcEPic );
+
   for ( UInt d = 0; d < pcEPic->getMaxAQDepth(); d++ )
   {
     const Pel* pLineY = pcPicYuv->getAddr(COMPONENT_Y);
     TEncPicQPAdaptationLayer* pcAQLayer = pcEPic->getAQLayer(d);
     const UInt uiAQPartWidth = pcAQLayer->getAQPartWidth();
     const UInt uiAQPartHeight = pcAQLayer->getAQPartHeight();
+    const UInt uiNumQuadInWidth = m_auiSum[d].empty() ? 0 : iWidth / ( uiAQPartWidth >> 1 );
     TEncQPAdaptationUnit* pcAQU = pcAQLayer->getQPAdaptationUnit();
 
     Double dSumAct = 0.0;
-    for ( UInt y = 0; y < iHeight; y += uiAQPartHeight )
+    for ( UInt y = 0, py = 0; y < iHeight; y += uiAQPartHeight, py++ )
     {
       const UInt uiCurrAQPartHeight = min(uiAQPartHeight, iHeight-y);
-      for ( UInt x = 0; x < iWidth; x += uiAQPartWidth, pcAQU++ )
+      for ( UInt x = 0, px = 0; x < iWidth; x += uiAQPartWidth, px++, pcAQU++ )
       {
         const UInt uiCurrAQPartWidth = min(uiAQPartWidth, iWidth-x);
-        const Pel* pBlkY = &pLineY[x];
-        UInt64 uiSum[4] = {0, 0, 0, 0};
-        UInt64 uiSumSq[4] = {0, 0, 0, 0};
-        UInt uiNumPixInAQPart = 0;
-        UInt by = 0;
-        for ( ; by < uiCurrAQPartHeight>>1; by++ )
+        const UInt uiNumPixInAQPart = uiCurrAQPartWidth * uiCurrAQPartHeight;
+        UInt64 uiSum[4];
+        UInt64 uiSumSq[4];
+
+        if ( uiNumQuadInWidth > 0 && uiCurrAQPartWidth == uiAQPartWidth && uiCurrAQPartHeight == uiAQPartHeight )
         {
-          UInt bx = 0;
-          for ( ; bx < uiCurrAQPartWidth>>1; bx++, uiNumPixInAQPart++ )
-          {
-            uiSum  [0] += pBlkY[bx];
-            uiSumSq[0] += pBlkY[bx] * pBlkY[bx];
-          }
-          for ( ; bx < uiCurrAQPartWidth; bx++, uiNumPixInAQPart++ )
+          for ( Int i = 0; i < 4; i++ )
           {
-            uiSum  [1] += pBlkY[bx];
-            uiSumSq[1] += pBlkY[bx] * pBlkY[bx];
+            const UInt uiQuadIdx = ( 2 * py + ( i >> 1 ) ) * uiNumQuadInWidth + 2 * px + ( i & 1 );
+            uiSum  [i] = m_auiSum  [d][uiQuadIdx];
+            uiSumSq[i] = m_auiSumSq[d][uiQuadIdx];
           }
-          pBlkY += iStride;
         }
-        for ( ; by < uiCurrAQPartHeight; by++ )
+        else
         {
-          UInt bx = 0;
-          for ( ; bx < uiCurrAQPartWidth>>1; bx++, uiNumPixInAQPart++ )
-          {
-            uiSum  [2] += pBlkY[bx];
-            uiSumSq[2] += pBlkY[bx] * pBlkY[bx];
-          }
-          for ( ; bx < uiCurrAQPartWidth; bx++, uiNumPixInAQPart++ )
-          {
-            uiSum  [3] += pBlkY[bx];
-            uiSumSq[3] += pBlkY[bx] * pBlkY[bx];
-          }
-          pBlkY += iStride;
+          const Pel* pBlkY = &pLineY[x];
+          const UInt uiHalfWidth  = uiCurrAQPartWidth  >> 1;
+          const UInt uiHalfHeight = uiCurrAQPartHeight >> 1;
+          xCalcBlockMoments( pBlkY,                                   iStride, uiHalfWidth,                     uiHalfHeight,                      uiSum[0], uiSumSq[0] );
+          xCalcBlockMoments( pBlkY + uiHalfWidth,                     iStride, uiCurrAQPartWidth - uiHalfWidth, uiHalfHeight,                      uiSum[1], uiSumSq[1] );
+          xCalcBlockMoments( pBlkY + uiHalfHeight * iStride,               iStride, uiHalfWidth,                     uiCurrAQPartHeight - uiHalfHeight, uiSum[2], uiSumSq[2] );
+          xCalcBlockMoments( pBlkY + uiHalfHeight * iStride + uiHalfWidth, iStride, uiCurrAQPartWidth - uiHalfWidth, uiCurrAQPartHeight - uiHalfHeight, uiSum[3], uiSumSq[3] );
         }
 
         Double dMinVar = DBL_MAX;
@@ -137,5 +293,113 @@ Void TEncPreanalyzer::xPreanalyze( TEncPic* pcEPic )
     pcAQLayer->setAvgActivity( dAvgAct );
   }
 }
-//! \}
 
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+/** Compute the sums and sums of squares of all complete AQ part quadrants of every AQ depth
+ * \param pcEPic Picture object to be analyzed
+ *
+ * The quadrants of depth d are the AQ parts of depth d+1, so only the finest depth reads the samples, and every
+ * coarser depth adds up 2x2 quadrants of the next finer one. The arrays of a depth are left empty when its quadrants
+ * cannot be derived this way (odd AQ part sizes).
+ */
+Void TEncPreanalyzer::xCalcQuadrantMoments( TEncPic* pcEPic )
+{
+  TComPicYuv* pcPicYuv = pcEPic->getPicYuvOrg();
+  const Int iWidth  = pcPicYuv->getWidth(COMPONENT_Y);
+  const Int iHeight = pcPicYuv->getHeight(COMPONENT_Y);
+  const Int iStride = pcPicYuv->getStride(COMPONENT_Y);
+  const Int iMaxAQDepth = pcEPic->getMaxAQDepth();
+
+  assert( iMaxAQDepth <= MAX_CU_DEPTH );
+
+  for ( Int d = iMaxAQDepth - 1; d >= 0; d-- )
+  {
+    TEncPicQPAdaptationLayer* pcAQLayer = pcEPic->getAQLayer(d);
+    const UInt uiQuadWidth  = pcAQLayer->getAQPartWidth()  >> 1;
+    const UInt uiQuadHeight = pcAQLayer->getAQPartHeight() >> 1;
+
+    m_auiSum  [d].clear();
+    m_auiSumSq[d].clear();
+
+    if ( uiQuadWidth == 0 || uiQuadHeight == 0 || ( uiQuadWidth << 1 ) != pcAQLayer->getAQPartWidth() || ( uiQuadHeight << 1 ) != pcAQLayer->getAQPartHeight() )
+    {
+      continue;
+    }
+
+    const UInt uiNumQuadInWidth  = iWidth  / uiQuadWidth;
+    const UInt uiNumQuadInHeight = iHeight / uiQuadHeight;
+    m_auiSum  [d].resize( uiNumQuadInWidth * uiNumQuadInHeight );
+    m_auiSumSq[d].resize( uiNumQuadInWidth * uiNumQuadInHeight );
+
+    const Bool bAggregate = d + 1 < iMaxAQDepth && !m_auiSum[d+1].empty()
+                         && pcEPic->getAQLayer(d+1)->getAQPartWidth()  == uiQuadWidth
+                         && pcEPic->getAQLayer(d+1)->getAQPartHeight() == uiQuadHeight;
+
+    if ( !bAggregate )
+    {
+      const Pel* pLineY = pcPicYuv->getAddr(COMPONENT_Y);
+      for ( UInt qy = 0; qy < uiNumQuadInHeight; qy++, pLineY += iStride * uiQuadHeight )
+      {
+        for ( UInt qx = 0; qx < uiNumQuadInWidth; qx++ )
+        {
+          const UInt uiQuadIdx = qy * uiNumQuadInWidth + qx;
+          xCalcBlockMoments( pLineY + qx * uiQuadWidth, iStride, uiQuadWidth, uiQuadHeight, m_auiSum[d][uiQuadIdx], m_auiSumSq[d][uiQuadIdx] );
+        }
+      }
+    }
+    else
+    {
+      const UInt     uiNumFineInWidth = iWidth / ( uiQuadWidth >> 1 );
+      const UInt64*  puiFineSum       = &m_auiSum  [d+1][0];
+      const UInt64*  puiFineSumSq     = &m_auiSumSq[d+1][0];
+      for ( UInt qy = 0; qy < uiNumQuadInHeight; qy++ )
+      {
+        for ( UInt qx = 0; qx < uiNumQuadInWidth; qx++ )
+        {
+          const UInt uiFineIdx = 2 * qy * uiNumFineInWidth + 2 * qx;
+          const UInt uiQuadIdx = qy * uiNumQuadInWidth + qx;
+          m_auiSum  [d][uiQuadIdx] = puiFineSum  [uiFineIdx] + puiFineSum  [uiFineIdx + 1] + puiFineSum  [uiFineIdx + uiNumFineInWidth] + puiFineSum  [uiFineIdx + uiNumFineInWidth + 1];
+          m_auiSumSq[d][uiQuadIdx] = puiFineSumSq[uiFineIdx] + puiFineSumSq[uiFineIdx + 1] + puiFineSumSq[uiFineIdx + uiNumFineInWidth] + puiFineSumSq[uiFineIdx + uiNumFineInWidth + 1];
+        }
+      }
+    }
+  }
+}
+
+#if ENABLE_WORKER_THREADS
+/** Worker thread: analyze the queued pictures in order until destroy() is called
+ */
+Void TEncPreanalyzer::xWorkerLoop()
+{
+  for (;;)
+  {
+    TEncPic* pcEPic = NULL;
+    {
+      std::unique_lock<std::mutex> cLock( m_cMutex );
+      while ( m_cJobs.empty() && !m_bTerminate )
+      {
+        m_cJobAvailable.wait( cLock );
+      }
+      if ( m_cJobs.empty() )
+      {
+        return;
+      }
+      pcEPic = m_cJobs.front();
+      m_cJobs.pop_front();
+      m_bWorkerBusy = true;
+    }
+
+    xPreanalyze( pcEPic );
+
+    {
+      std::lock_guard<std::mutex> cLock( m_cMutex );
+      m_bWorkerBusy = false;
+    }
+    m_cJobsDone.notify_all();
+  }
+}
+#endif
+//! \}
@@ -40,6 +40,14 @@
 
 #include "TEncPic.h"
 
+#include <vector>
+#include <deque>
+#if ENABLE_WORKER_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
 //! \ingroup TLibEncoder
 //! \{
 
@@ -50,11 +58,36 @@
 /// Source picture analyzer class
 class TEncPreanalyzer
 {
+private:
+  std::vector<UInt64>     m_auiSum[MAX_CU_DEPTH];         ///< per depth: sum of the samples of each complete AQ part quadrant
+  std::vector<UInt64>     m_auiSumSq[MAX_CU_DEPTH];       ///< per depth: sum of the squared samples of each complete AQ part quadrant
+
+  Bool                    m_bUseWorkerThread;
+#if ENABLE_WORKER_THREADS
+  std::thread             m_cWorker;
+  std::mutex              m_cMutex;
+  std::condition_variable m_cJobAvailable;
+  std::condition_variable m_cJobsDone;
+  std::deque<TEncPic*>    m_cJobs;
+  Bool                    m_bWorkerBusy;
+  Bool                    m_bTerminate;
+
+  Void xWorkerLoop();
+#endif
+
+  Void xCalcQuadrantMoments( TEncPic* pcEPic );
+
 public:
   TEncPreanalyzer();
   virtual ~TEncPreanalyzer();
 
+  Void create ( Bool bUseWorkerThread );
+  Void destroy();
+
   Void xPreanalyze( TEncPic* pcPic );
+
+  Void preanalyze        ( TEncPic* pcPic );               ///< analyze the picture, on the worker thread if one is used
+  Void waitForCompletion ();                               ///< wait until all pictures handed to preanalyze() are analyzed
 };
 
 //! \}
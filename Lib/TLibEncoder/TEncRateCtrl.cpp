@@ -65,8 +65,13 @@ TEncRCSeq::TEncRCSeq()
   m_framesLeft          = 0;
   m_bitsLeft            = 0;
   m_useLCUSeparateModel = false;
+  m_smoothWindowSize    = g_RCSmoothWindowSize;
+  m_LCUSmoothWindowSize = g_RCLCUSmoothWindowSize;
   m_adaptiveBit         = 0;
   m_lastLambda          = 0.0;
+  m_cpbSize             = 0;
+  m_cpbFullness         = 0;
+  m_cpbBufferingRate    = 0;
 }
 
 TEncRCSeq::~TEncRCSeq()
@@ -87,6 +92,11 @@ Void TEncRCSeq::create( Int totalFrames, Int targetBitrate, Int frameRate, Int G
   m_LCUHeight           = LCUHeight;
   m_numberOfLevel       = numberOfLevel;
   m_useLCUSeparateModel = useLCUSeparateModel;
+  m_smoothWindowSize    = g_RCSmoothWindowSize;
+  m_LCUSmoothWindowSize = g_RCLCUSmoothWindowSize;
+  m_cpbSize             = 0;
+  m_cpbFullness         = 0;
+  m_cpbBufferingRate    = 0;
 
   m_numberOfPixel   = m_picWidth * m_picHeight;
   m_targetBits      = (Int64)m_totalFrames * (Int64)m_targetRate / (Int64)m_frameRate;
@@ -272,6 +282,50 @@ Void TEncRCSeq::updateAfterPic ( Int bits )
   m_framesLeft--;
 }
 
+/** \param smoothWindowSize     number of pictures over which a deviation from the sequence budget is recovered
+ *  \param LCUSmoothWindowSize  number of LCUs (LCU rows with row level control) over which a deviation from the picture budget is recovered
+ *  \param alphaUpdate          learning rate of alpha, 0 to keep the rate derived from the target bpp
+ *  \param betaUpdate           learning rate of beta, 0 to keep the rate derived from the target bpp
+ */
+Void TEncRCSeq::setModelParameters( Int smoothWindowSize, Int LCUSmoothWindowSize, Double alphaUpdate, Double betaUpdate )
+{
+  assert( smoothWindowSize > 0 && LCUSmoothWindowSize > 0 );
+  m_smoothWindowSize    = smoothWindowSize;
+  m_LCUSmoothWindowSize = LCUSmoothWindowSize;
+  if ( alphaUpdate > 0.0 )
+  {
+    m_alphaUpdate = alphaUpdate;
+  }
+  if ( betaUpdate > 0.0 )
+  {
+    m_betaUpdate = betaUpdate;
+  }
+}
+
+/** Start the coded picture buffer model: the buffer is filled at the target bit rate and
+ *  each coded picture is removed from it in decoding order, one picture interval apart.
+ *  \param cpbSize       buffer size in bits, 0 to disable the model
+ *  \param initialDelay  initial removal delay in ms, which sets the fullness before the first picture is removed
+ */
+Void TEncRCSeq::initCpb( Int cpbSize, Int initialDelay )
+{
+  m_cpbSize          = cpbSize;
+  m_cpbBufferingRate = m_targetRate / m_frameRate;
+  m_cpbFullness      = (Int)min<Int64>( cpbSize, (Int64)m_targetRate * initialDelay / 1000 );
+}
+
+/** \param bits  size of the picture just coded
+ *  \returns false if the picture was not completely in the buffer at its removal time (underflow)
+ */
+Bool TEncRCSeq::updateCpbAfterPic( Int bits )
+{
+  m_cpbFullness -= bits;
+  Bool noUnderflow = ( m_cpbFullness >= 0 );
+  m_cpbFullness += m_cpbBufferingRate;
+  m_cpbFullness  = min( m_cpbFullness, m_cpbSize );   // a constant bit rate channel would need filler data here
+  return noUnderflow;
+}
+
 Void TEncRCSeq::setAllBitRatio( Double basicLambda, Double* equaCoeffA, Double* equaCoeffB )
 {
   Int* bitsRatio = new Int[m_GOPSize];
@@ -449,7 +503,7 @@ Void TEncRCGOP::updateAfterPicture( Int bitsCost )
 
 Int TEncRCGOP::xEstGOPTargetBits( TEncRCSeq* encRCSeq, Int GOPSize )
 {
-  Int realInfluencePicture = min( g_RCSmoothWindowSize, encRCSeq->getFramesLeft() );
+  Int realInfluencePicture = min( encRCSeq->getSmoothWindowSize(), encRCSeq->getFramesLeft() );
   Int averageTargetBitsPerPic = (Int)( encRCSeq->getTargetBits() / encRCSeq->getTotalFrames() );
   Int currentTargetBitsPerPic = (Int)( ( encRCSeq->getBitsLeft() - averageTargetBitsPerPic * (encRCSeq->getFramesLeft() - realInfluencePicture) ) / realInfluencePicture );
   Int targetBits = currentTargetBitsPerPic * GOPSize;
@@ -485,6 +539,16 @@ TEncRCPic::TEncRCPic()
   m_picActualBits       = 0;
   m_picQP               = 0;
   m_picLambda           = 0.0;
+
+  m_rowFirstLCU  = 0;
+  m_rowNumLCU    = 0;
+  m_rowCostIntra = 0.0;
+  m_rowIntra     = false;
+  m_rowCpbConstrained = false;
+  m_rowLambda    = -1.0;
+  m_rowQP        = g_RCInvalidQPValue;
+  m_rowAlpha     = 0.0;
+  m_rowBeta      = 0.0;
 }
 
 TEncRCPic::~TEncRCPic()
@@ -518,9 +582,48 @@ Int TEncRCPic::xEstPicTargetBits( TEncRCSeq* encRCSeq, TEncRCGOP* encRCGOP )
     targetBits = Int( g_RCWeightPicRargetBitInBuffer * targetBits + g_RCWeightPicTargetBitInGOP * m_encRCGOP->getTargetBitInGOP( currPicPosition ) );
   }
 
+  return clipTargetBitsToCpb( targetBits );
+}
+
+/** Keep the CPB fullness between the low and high margins after this picture is removed
+ *  and the next picture interval has been buffered. Underflow protection takes precedence.
+ */
+Int TEncRCPic::clipTargetBitsToCpb( Int targetBits )
+{
+  if ( !m_encRCSeq->getUseCpb() )
+  {
+    return targetBits;
+  }
+
+  Int fullness  = m_encRCSeq->getCpbFullness();
+  Int lowLevel  = Int( m_encRCSeq->getCpbSize() * g_RCCpbLowMargin );
+  Int highLevel = Int( m_encRCSeq->getCpbSize() * g_RCCpbHighMargin );
+
+  if ( fullness + m_encRCSeq->getCpbBufferingRate() - targetBits > highLevel )
+  {
+    targetBits = fullness + m_encRCSeq->getCpbBufferingRate() - highLevel;
+  }
+  if ( fullness - targetBits < lowLevel )
+  {
+    targetBits = max( 100, fullness - lowLevel );
+  }
+
   return targetBits;
 }
 
+/** \returns bits left for the rest of the picture, reduced if necessary so that the CPB does not underflow
+ */
+Int TEncRCPic::xGetCpbBoundedBitsLeft()
+{
+  if ( !m_encRCSeq->getUseCpb() )
+  {
+    return m_bitsLeft;
+  }
+
+  Int cpbBitsLeft = m_encRCSeq->getCpbFullness() - Int( m_encRCSeq->getCpbSize() * g_RCCpbLowMargin ) - m_estHeaderBits - getBitsCoded();
+  return min( m_bitsLeft, max( cpbBitsLeft, m_LCULeft ) );
+}
+
 Int TEncRCPic::xEstPicHeaderBits( list<TEncRCPic*>& listPreviousPictures, Int frameLevel )
 {
   Int numPreviousPics   = 0;
@@ -612,6 +715,16 @@ Void TEncRCPic::create( TEncRCSeq* encRCSeq, TEncRCGOP* encRCGOP, Int frameLevel
   m_picActualBits       = 0;
   m_picQP               = 0;
   m_picLambda           = 0.0;
+
+  m_rowFirstLCU  = 0;
+  m_rowNumLCU    = 0;
+  m_rowCostIntra = 0.0;
+  m_rowIntra     = false;
+  m_rowCpbConstrained = false;
+  m_rowLambda    = -1.0;
+  m_rowQP        = g_RCInvalidQPValue;
+  m_rowAlpha     = encRCSeq->getPicPara( frameLevel ).m_alpha;
+  m_rowBeta      = encRCSeq->getPicPara( frameLevel ).m_beta;
 }
 
 Void TEncRCPic::destroy()
@@ -763,21 +876,22 @@ Double TEncRCPic::getLCUTargetBpp(SliceType eSliceType)
   Int   LCUIdx    = getLCUCoded();
   Double bpp      = -1.0;
   Int avgBits     = 0;
+  Int bitsLeft    = xGetCpbBoundedBitsLeft();
 
   if (eSliceType == I_SLICE)
   {
     Int noOfLCUsLeft = m_numberOfLCU - LCUIdx + 1;
-    Int bitrateWindow = min(4,noOfLCUsLeft);
+    Int bitrateWindow = min(m_encRCSeq->getLCUSmoothWindowSize(),noOfLCUsLeft);
     Double MAD      = getLCU(LCUIdx).m_costIntra;
 
     if (m_remainingCostIntra > 0.1 )
     {
-      Double weightedBitsLeft = (m_bitsLeft*bitrateWindow+(m_bitsLeft-getLCU(LCUIdx).m_targetBitsLeft)*noOfLCUsLeft)/(Double)bitrateWindow;
+      Double weightedBitsLeft = (bitsLeft*bitrateWindow+(bitsLeft-getLCU(LCUIdx).m_targetBitsLeft)*noOfLCUsLeft)/(Double)bitrateWindow;
       avgBits = Int( MAD*weightedBitsLeft/m_remainingCostIntra );
     }
     else
     {
-      avgBits = Int( m_bitsLeft / m_LCULeft );
+      avgBits = Int( bitsLeft / m_LCULeft );
     }
     m_remainingCostIntra -= MAD;
   }
@@ -788,8 +902,8 @@ Double TEncRCPic::getLCUTargetBpp(SliceType eSliceType)
     {
       totalWeight += m_LCUs[i].m_bitWeight;
     }
-    Int realInfluenceLCU = min( g_RCLCUSmoothWindowSize, getLCULeft() );
-    avgBits = (Int)( m_LCUs[LCUIdx].m_bitWeight - ( totalWeight - m_bitsLeft ) / realInfluenceLCU + 0.5 );
+    Int realInfluenceLCU = min( m_encRCSeq->getLCUSmoothWindowSize(), getLCULeft() );
+    avgBits = (Int)( m_LCUs[LCUIdx].m_bitWeight - ( totalWeight - bitsLeft ) / realInfluenceLCU + 0.5 );
   }
 
   if ( avgBits < 1 )
@@ -882,6 +996,172 @@ Int TEncRCPic::getLCUEstQP( Double lambda, Int clipPicQP )
   return estQP;
 }
 
+/** Start a CTU row: allocate its bits and return the target bpp of the row.
+ *  A row is the next numLCUInRow LCUs in coding order (the part of a picture row inside the current tile).
+ *  The lambda and QP chosen for the row only depend on rows completed before it.
+ */
+Double TEncRCPic::getCtuRowTargetBpp( Int numLCUInRow, SliceType eSliceType )
+{
+  Int firstIdx  = getLCUCoded();
+  Int lastIdx   = min( firstIdx + numLCUInRow, m_numberOfLCU );
+  Int bitsLeft  = xGetCpbBoundedBitsLeft();
+  Int rowPixels = 0;
+  Double rowBits;
+
+  m_rowCpbConstrained = false;
+
+  m_rowCostIntra = 0.0;
+  for ( Int i=firstIdx; i<lastIdx; i++ )
+  {
+    rowPixels += m_LCUs[i].m_numberOfPixel;
+  }
+
+  if ( eSliceType == I_SLICE )
+  {
+    for ( Int i=firstIdx; i<lastIdx; i++ )
+    {
+      m_rowCostIntra += m_LCUs[i].m_costIntra;
+    }
+    if ( m_remainingCostIntra > 0.1 )
+    {
+      rowBits = bitsLeft * m_rowCostIntra / m_remainingCostIntra;
+
+      // the bits still planned for the picture no longer fit into the CPB
+      m_rowCpbConstrained = m_encRCSeq->getUseCpb() && m_targetBits * m_remainingCostIntra / m_totalCostIntra > bitsLeft;
+    }
+    else
+    {
+      rowBits = (Double)bitsLeft * ( lastIdx - firstIdx ) / m_LCULeft;
+    }
+    m_remainingCostIntra -= m_rowCostIntra;
+  }
+  else
+  {
+    Double totalWeight = 0.0;
+    Double rowWeight   = 0.0;
+    for ( Int i=firstIdx; i<m_numberOfLCU; i++ )
+    {
+      totalWeight += m_LCUs[i].m_bitWeight;
+    }
+    for ( Int i=firstIdx; i<lastIdx; i++ )
+    {
+      rowWeight += m_LCUs[i].m_bitWeight;
+    }
+    Int rowsLeft          = ( m_LCULeft + numLCUInRow - 1 ) / numLCUInRow;
+    Int realInfluenceRows = min( m_encRCSeq->getLCUSmoothWindowSize(), rowsLeft );
+    rowBits = rowWeight - ( totalWeight - bitsLeft ) / realInfluenceRows;
+
+    // the bits still planned for the picture no longer fit into the CPB
+    m_rowCpbConstrained = m_encRCSeq->getUseCpb() && totalWeight > bitsLeft;
+  }
+
+  if ( rowBits < lastIdx - firstIdx )
+  {
+    rowBits = lastIdx - firstIdx;   // at least one bit per LCU
+  }
+
+  for ( Int i=firstIdx; i<lastIdx; i++ )
+  {
+    m_LCUs[i].m_targetBits = Int( rowBits * m_LCUs[i].m_numberOfPixel / rowPixels + 0.5 );
+  }
+
+  m_rowFirstLCU = firstIdx;
+  m_rowNumLCU   = lastIdx - firstIdx;
+  m_rowIntra    = ( eSliceType == I_SLICE );
+
+  return rowBits / rowPixels;
+}
+
+/** Derive lambda and QP of the current CTU row from the row model, clipped against the previous row and the picture
+ */
+Void TEncRCPic::estimateCtuRowLambdaAndQP( Double bpp, Int clipPicQP, SliceType eSliceType )
+{
+  Double estLambda;
+  if ( eSliceType == I_SLICE )
+  {
+    Double rowPixels = 0.0;
+    for ( Int i=m_rowFirstLCU; i<m_rowFirstLCU+m_rowNumLCU; i++ )
+    {
+      rowPixels += m_LCUs[i].m_numberOfPixel;
+    }
+    Double costPerPixel = pow( m_rowCostIntra/rowPixels, BETA1 );
+    estLambda = calculateLambdaIntra( m_encRCSeq->getPicPara( m_frameLevel ).m_alpha, m_encRCSeq->getPicPara( m_frameLevel ).m_beta, costPerPixel, bpp );
+  }
+  else
+  {
+    estLambda = m_rowAlpha * pow( bpp, m_rowBeta );
+  }
+
+  // when the rest of the picture would underflow the CPB, allow larger QP increases
+  Int maxRowStep = m_rowCpbConstrained ? g_RCCpbMaxRowQPStep : 1;
+  Int maxPicDiff = m_rowCpbConstrained ? g_RCCpbMaxPicQPDiff : 2;
+
+  if ( m_rowLambda > 0.0 )
+  {
+    estLambda = Clip3( m_rowLambda * pow( 2.0, -1.0/3.0 ), m_rowLambda * pow( 2.0, maxRowStep/3.0 ), estLambda );
+  }
+  if ( m_estPicLambda > 0.0 )
+  {
+    estLambda = Clip3( m_estPicLambda * pow( 2.0, -2.0/3.0 ), m_estPicLambda * pow( 2.0, maxPicDiff/3.0 ), estLambda );
+  }
+  else
+  {
+    estLambda = Clip3( 10.0, 1000.0, estLambda );
+  }
+  if ( estLambda < 0.1 )
+  {
+    estLambda = 0.1;
+  }
+
+  Int estQP = Int( 4.2005 * log( estLambda ) + 13.7122 + 0.5 );
+  if ( m_rowQP > g_RCInvalidQPValue )
+  {
+    estQP = Clip3( m_rowQP - 1, m_rowQP + maxRowStep, estQP );
+  }
+  estQP = Clip3( clipPicQP - 2, clipPicQP + maxPicDiff, estQP );
+
+  m_rowLambda = estLambda;
+  m_rowQP     = estQP;
+}
+
+/** Refine the picture-local model with the bits spent on the CTU row just completed
+ */
+Void TEncRCPic::xUpdateAfterCtuRow()
+{
+  Int rowBits   = 0;
+  Int rowPixels = 0;
+  for ( Int i=m_rowFirstLCU; i<m_rowFirstLCU+m_rowNumLCU; i++ )
+  {
+    rowBits   += m_LCUs[i].m_actualBits;
+    rowPixels += m_LCUs[i].m_numberOfPixel;
+  }
+  m_rowNumLCU = 0;
+
+  if ( m_rowIntra || m_rowLambda <= 0.0 )
+  {
+    return;
+  }
+
+  Double bpp       = (Double)rowBits / (Double)rowPixels;
+  Double calLambda = m_rowAlpha * pow( bpp, m_rowBeta );
+
+  if ( calLambda < 0.01 || bpp < 0.0001 )
+  {
+    m_rowAlpha *= ( 1.0 - m_encRCSeq->getAlphaUpdate() / 2.0 );
+    m_rowBeta  *= ( 1.0 - m_encRCSeq->getBetaUpdate() / 2.0 );
+  }
+  else
+  {
+    calLambda   = Clip3( m_rowLambda / 10.0, m_rowLambda * 10.0, calLambda );
+    m_rowAlpha += m_encRCSeq->getAlphaUpdate() * ( log( m_rowLambda ) - log( calLambda ) ) * m_rowAlpha;
+    Double lnbpp = Clip3( -5.0, -0.1, log( bpp ) );
+    m_rowBeta  += m_encRCSeq->getBetaUpdate() * ( log( m_rowLambda ) - log( calLambda ) ) * lnbpp;
+  }
+
+  m_rowAlpha = Clip3( g_RCAlphaMinValue, g_RCAlphaMaxValue, m_rowAlpha );
+  m_rowBeta  = Clip3( g_RCBetaMinValue,  g_RCBetaMaxValue,  m_rowBeta  );
+}
+
 Void TEncRCPic::updateAfterLCU( Int LCUIdx, Int bits, Int QP, Double lambda, Bool updateLCUParameter )
 {
   m_LCUs[LCUIdx].m_actualBits = bits;
@@ -892,6 +1172,11 @@ Void TEncRCPic::updateAfterLCU( Int LCUIdx, Int bits, Int QP, Double lambda, Boo
   m_bitsLeft   -= bits;
   m_pixelsLeft -= m_LCUs[LCUIdx].m_numberOfPixel;
 
+  if ( m_rowNumLCU > 0 && LCUIdx == m_rowFirstLCU + m_rowNumLCU - 1 )
+  {
+    xUpdateAfterCtuRow();
+  }
+
   if ( !updateLCUParameter )
   {
     return;
@@ -71,6 +71,10 @@ const Double g_RCAlphaMinValue = 0.05;
 const Double g_RCAlphaMaxValue = 500.0;
 const Double g_RCBetaMinValue  = -3.0;
 const Double g_RCBetaMaxValue  = -0.1;
+const Double g_RCCpbLowMargin  = 0.1;   ///< fraction of the CPB kept filled to protect against underflow
+const Double g_RCCpbHighMargin = 0.9;   ///< fraction of the CPB the fullness should stay below to avoid overflow
+const Int g_RCCpbMaxRowQPStep  = 3;     ///< QP increase allowed from one CTU row to the next when the CPB would underflow
+const Int g_RCCpbMaxPicQPDiff  = 8;     ///< QP increase allowed over the picture QP when the CPB would underflow
 
 #define ALPHA     6.7542;
 #define BETA1     1.2517
@@ -109,6 +113,9 @@ public:
   Void initLCUPara( TRCParameter** LCUPara = NULL );    // NULL to initial with default value
   Void updateAfterPic ( Int bits );
   Void setAllBitRatio( Double basicLambda, Double* equaCoeffA, Double* equaCoeffB );
+  Void setModelParameters( Int smoothWindowSize, Int LCUSmoothWindowSize, Double alphaUpdate, Double betaUpdate );
+  Void initCpb( Int cpbSize, Int initialDelay );
+  Bool updateCpbAfterPic( Int bits );
 
 public:
   Int  getTotalFrames()                 { return m_totalFrames; }
@@ -145,6 +152,13 @@ public:
   Double getSeqBpp()                    { return m_seqTargetBpp; }
   Double getAlphaUpdate()               { return m_alphaUpdate; }
   Double getBetaUpdate()                { return m_betaUpdate; }
+  Int    getSmoothWindowSize()          { return m_smoothWindowSize; }
+  Int    getLCUSmoothWindowSize()       { return m_LCUSmoothWindowSize; }
+
+  Bool   getUseCpb()                    { return m_cpbSize > 0; }
+  Int    getCpbSize()                   { return m_cpbSize; }
+  Int    getCpbFullness()               { return m_cpbFullness; }
+  Int    getCpbBufferingRate()          { return m_cpbBufferingRate; }
 
   Int    getAdaptiveBits()              { return m_adaptiveBit;  }
   Double getLastLambda()                { return m_lastLambda;   }
@@ -176,6 +190,12 @@ private:
   Double m_alphaUpdate;
   Double m_betaUpdate;
   Bool m_useLCUSeparateModel;
+  Int m_smoothWindowSize;       // pictures over which a deviation from the sequence budget is recovered
+  Int m_LCUSmoothWindowSize;    // LCUs (or LCU rows) over which a deviation from the picture budget is recovered
+
+  Int m_cpbSize;                // coded picture buffer size in bits, 0 if the buffer is not modelled
+  Int m_cpbFullness;            // CPB fullness in bits just before the removal of the next picture
+  Int m_cpbBufferingRate;       // bits entering the CPB per picture interval
 
   Int m_adaptiveBit;
   Double m_lastLambda;
@@ -236,6 +256,10 @@ public:
   Double getLCUEstLambda( Double bpp );
   Int    getLCUEstQP( Double lambda, Int clipPicQP );
 
+  Double getCtuRowTargetBpp( Int numLCUInRow, SliceType eSliceType );
+  Void   estimateCtuRowLambdaAndQP( Double bpp, Int clipPicQP, SliceType eSliceType );
+  Int    clipTargetBitsToCpb( Int targetBits );
+
   Void updateAfterLCU( Int LCUIdx, Int bits, Int QP, Double lambda, Bool updateLCUParameter = true );
   Void updateAfterPicture( Int actualHeaderBits, Int actualTotalBits, Double averageQP, Double averageLambda, SliceType eSliceType);
 
@@ -246,6 +270,8 @@ public:
 private:
   Int xEstPicTargetBits( TEncRCSeq* encRCSeq, TEncRCGOP* encRCGOP );
   Int xEstPicHeaderBits( list<TEncRCPic*>& listPreviousPictures, Int frameLevel );
+  Int xGetCpbBoundedBitsLeft();
+  Void xUpdateAfterCtuRow();
 
 public:
   TEncRCSeq*      getRCSequence()                         { return m_encRCSeq; }
@@ -276,6 +302,10 @@ public:
   Double getPicEstLambda()                                { return m_estPicLambda; }
   Void setPicEstLambda( Double lambda )                   { m_picLambda = lambda; }
 
+  Bool   isCtuRowActive()                                 { return m_rowNumLCU > 0; }
+  Double getCtuRowLambda()                                { return m_rowLambda; }
+  Int    getCtuRowQP()                                    { return m_rowQP; }
+
 private:
   TEncRCSeq* m_encRCSeq;
   TEncRCGOP* m_encRCGOP;
@@ -299,6 +329,17 @@ private:
   Int m_picActualBits;          // the whole picture, including header
   Int m_picQP;                  // in integer form
   Double m_picLambda;
+
+  // CTU row level control: one lambda/QP per row, with a picture-local model refined after each row
+  Int m_rowFirstLCU;
+  Int m_rowNumLCU;              // 0 when no row is in progress
+  Double m_rowCostIntra;
+  Bool m_rowIntra;
+  Bool m_rowCpbConstrained;     // the CPB, not the picture budget, limits the bits of the row
+  Double m_rowLambda;
+  Int m_rowQP;
+  Double m_rowAlpha;
+  Double m_rowBeta;
 };
 
 class TEncRateCtrl
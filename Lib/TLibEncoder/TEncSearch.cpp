@@ -138,6 +138,10 @@ TEncSearch::TEncSearch()
 	m_pcEntropyCoder = NULL;
 	m_pTempPel = NULL;
 	setWpScalingDistParam(NULL, -1, REF_PIC_LIST_X);
+	m_dCtuMotionPerPOC = -1.0;
+	resetRefSelectionStats();
+	m_pcAnalysisCtu = NULL;
+	m_bBiPredTargetValid = false;
 }
 
 
@@ -145,56 +149,25 @@ TEncSearch::TEncSearch()
 
 TEncSearch::~TEncSearch()
 {
-	if (m_pTempPel)
-	{
-		delete[] m_pTempPel;
-		m_pTempPel = NULL;
-	}
-
 	if (m_pcEncCfg)
 	{
 		const UInt uiNumLayersAllocated = m_pcEncCfg->getQuadtreeTULog2MaxSize() - m_pcEncCfg->getQuadtreeTULog2MinSize() + 1;
 
-		for (UInt ch = 0; ch < MAX_NUM_COMPONENT; ch++)
-		{
-			for (UInt layer = 0; layer < uiNumLayersAllocated; layer++)
-			{
-				delete[] m_ppcQTTempCoeff[ch][layer];
-#if ADAPTIVE_QP_SELECTION
-				delete[] m_ppcQTTempArlCoeff[ch][layer];
-#endif
-			}
-			delete[] m_ppcQTTempCoeff[ch];
-			delete[] m_pcQTTempCoeff[ch];
-			delete[] m_puhQTTempCbf[ch];
-#if ADAPTIVE_QP_SELECTION
-			delete[] m_ppcQTTempArlCoeff[ch];
-			delete[] m_pcQTTempArlCoeff[ch];
-#endif
-		}
-
 		for (UInt layer = 0; layer < uiNumLayersAllocated; layer++)
 		{
 			m_pcQTTempTComYuv[layer].destroy();
 		}
 	}
 
-	delete[] m_puhQTTempTrIdx;
 	delete[] m_pcQTTempTComYuv;
 
-	for (UInt ch = 0; ch < MAX_NUM_COMPONENT; ch++)
-	{
-		delete[] m_pSharedPredTransformSkip[ch];
-		delete[] m_pcQTTempTUCoeff[ch];
-#if ADAPTIVE_QP_SELECTION
-		delete[] m_ppcQTTempTUArlCoeff[ch];
-#endif
-		delete[] m_phQTTempCrossComponentPredictionAlpha[ch];
-		delete[] m_puhQTTempTransformSkipFlag[ch];
-	}
 	m_pcQTTempTransformSkipTComYuv.destroy();
 
 	m_tmpYuvPred.destroy();
+
+	// everything else lives in the arena
+	m_cArena.destroy();
+	m_pTempPel = NULL;
 }
 
 
@@ -253,46 +226,70 @@ Void TEncSearch::init(TEncCfg*      pcEncCfg,
 	const ChromaFormat cform = pcEncCfg->getChromaFormatIdc();
 	initTempBuff(cform);
 
-	m_pTempPel = new Pel[g_uiMaxCUWidth*g_uiMaxCUHeight];
-
 	const UInt uiNumLayersToAllocate = pcEncCfg->getQuadtreeTULog2MaxSize() - pcEncCfg->getQuadtreeTULog2MinSize() + 1;
 	const UInt uiNumPartitions = 1 << (g_uiMaxCUDepth << 1);
-	for (UInt ch = 0; ch < MAX_NUM_COMPONENT; ch++)
-	{
-		const UInt csx = ::getComponentScaleX(ComponentID(ch), cform);
-		const UInt csy = ::getComponentScaleY(ComponentID(ch), cform);
-		m_ppcQTTempCoeff[ch] = new TCoeff*[uiNumLayersToAllocate];
-		m_pcQTTempCoeff[ch] = new TCoeff[(g_uiMaxCUWidth*g_uiMaxCUHeight) >> (csx + csy)];
+	const UInt uiYuvBufferSize = TComYuv::getBufferSize(g_uiMaxCUWidth, g_uiMaxCUHeight, cform);
 #if ADAPTIVE_QP_SELECTION
-		m_ppcQTTempArlCoeff[ch] = new TCoeff*[uiNumLayersToAllocate];
-		m_pcQTTempArlCoeff[ch] = new TCoeff[(g_uiMaxCUWidth*g_uiMaxCUHeight) >> (csx + csy)];
+	const UInt uiNumCoeffArrays = 2;
+#else
+	const UInt uiNumCoeffArrays = 1;
 #endif
-		m_puhQTTempCbf[ch] = new UChar[uiNumPartitions];
 
-		for (UInt layer = 0; layer < uiNumLayersToAllocate; layer++)
-		{
-			m_ppcQTTempCoeff[ch][layer] = new TCoeff[(g_uiMaxCUWidth*g_uiMaxCUHeight) >> (csx + csy)];
+	// size the arena: the shared buffers, then per transform layer the Yuv and the coefficients of every component
+	size_t arenaSize = TComMemArena::getAlignedSize(sizeof(Pel) * g_uiMaxCUWidth * g_uiMaxCUHeight)
+	                 + TComMemArena::getAlignedSize(uiNumPartitions)
+	                 + TComMemArena::getAlignedSize(uiYuvBufferSize)
+	                 + TComMemArena::getAlignedSize(TComYuv::getBufferSize(MAX_CU_SIZE, MAX_CU_SIZE, cform))
+	                 + uiNumLayersToAllocate * TComMemArena::getAlignedSize(uiYuvBufferSize);
+	for (UInt ch = 0; ch < MAX_NUM_COMPONENT; ch++)
+	{
+		const UInt uiNumCoeff = (g_uiMaxCUWidth*g_uiMaxCUHeight) >> (::getComponentScaleX(ComponentID(ch), cform) + ::getComponentScaleY(ComponentID(ch), cform));
+		arenaSize += uiNumCoeffArrays * TComMemArena::getAlignedSize(sizeof(TCoeff*) * uiNumLayersToAllocate);
+		arenaSize += uiNumCoeffArrays * (uiNumLayersToAllocate + 1) * TComMemArena::getAlignedSize(sizeof(TCoeff) * uiNumCoeff);
+		arenaSize += 3 * TComMemArena::getAlignedSize(uiNumPartitions);
+		arenaSize += TComMemArena::getAlignedSize(sizeof(Pel) * MAX_CU_SIZE * MAX_CU_SIZE);
+		arenaSize += uiNumCoeffArrays * TComMemArena::getAlignedSize(sizeof(TCoeff) * MAX_CU_SIZE * MAX_CU_SIZE);
+	}
+	m_cArena.create(arenaSize);
+
+	m_pTempPel = m_cArena.allocateArray<Pel>(g_uiMaxCUWidth*g_uiMaxCUHeight);
+	m_puhQTTempTrIdx = m_cArena.allocateArray<UChar>(uiNumPartitions);
+	for (UInt ch = 0; ch < MAX_NUM_COMPONENT; ch++)
+	{
+		const UInt uiNumCoeff = (g_uiMaxCUWidth*g_uiMaxCUHeight) >> (::getComponentScaleX(ComponentID(ch), cform) + ::getComponentScaleY(ComponentID(ch), cform));
+		m_ppcQTTempCoeff[ch] = m_cArena.allocateArray<TCoeff*>(uiNumLayersToAllocate);
+		m_pcQTTempCoeff[ch] = m_cArena.allocateArray<TCoeff>(uiNumCoeff);
 #if ADAPTIVE_QP_SELECTION
-			m_ppcQTTempArlCoeff[ch][layer] = new TCoeff[(g_uiMaxCUWidth*g_uiMaxCUHeight) >> (csx + csy)];
+		m_ppcQTTempArlCoeff[ch] = m_cArena.allocateArray<TCoeff*>(uiNumLayersToAllocate);
+		m_pcQTTempArlCoeff[ch] = m_cArena.allocateArray<TCoeff>(uiNumCoeff);
 #endif
-		}
-
-		m_phQTTempCrossComponentPredictionAlpha[ch] = new Char[uiNumPartitions];
-		m_pSharedPredTransformSkip[ch] = new Pel[MAX_CU_SIZE*MAX_CU_SIZE];
-		m_pcQTTempTUCoeff[ch] = new TCoeff[MAX_CU_SIZE*MAX_CU_SIZE];
+		m_puhQTTempCbf[ch] = m_cArena.allocateArray<UChar>(uiNumPartitions);
+		m_phQTTempCrossComponentPredictionAlpha[ch] = m_cArena.allocateArray<Char>(uiNumPartitions);
+		m_puhQTTempTransformSkipFlag[ch] = m_cArena.allocateArray<UChar>(uiNumPartitions);
+		m_pSharedPredTransformSkip[ch] = m_cArena.allocateArray<Pel>(MAX_CU_SIZE*MAX_CU_SIZE);
+		m_pcQTTempTUCoeff[ch] = m_cArena.allocateArray<TCoeff>(MAX_CU_SIZE*MAX_CU_SIZE);
 #if ADAPTIVE_QP_SELECTION
-		m_ppcQTTempTUArlCoeff[ch] = new TCoeff[MAX_CU_SIZE*MAX_CU_SIZE];
+		m_ppcQTTempTUArlCoeff[ch] = m_cArena.allocateArray<TCoeff>(MAX_CU_SIZE*MAX_CU_SIZE);
 #endif
-		m_puhQTTempTransformSkipFlag[ch] = new UChar[uiNumPartitions];
 	}
-	m_puhQTTempTrIdx = new UChar[uiNumPartitions];
+	m_pcQTTempTransformSkipTComYuv.create(g_uiMaxCUWidth, g_uiMaxCUHeight, cform, (Pel*)m_cArena.allocate(uiYuvBufferSize));
+	m_tmpYuvPred.create(MAX_CU_SIZE, MAX_CU_SIZE, cform, (Pel*)m_cArena.allocate(TComYuv::getBufferSize(MAX_CU_SIZE, MAX_CU_SIZE, cform)));
+
+	// the buffers of each transform layer are kept together
 	m_pcQTTempTComYuv = new TComYuv[uiNumLayersToAllocate];
-	for (UInt ui = 0; ui < uiNumLayersToAllocate; ++ui)
+	for (UInt layer = 0; layer < uiNumLayersToAllocate; layer++)
 	{
-		m_pcQTTempTComYuv[ui].create(g_uiMaxCUWidth, g_uiMaxCUHeight, pcEncCfg->getChromaFormatIdc());
+		m_pcQTTempTComYuv[layer].create(g_uiMaxCUWidth, g_uiMaxCUHeight, cform, (Pel*)m_cArena.allocate(uiYuvBufferSize));
+		for (UInt ch = 0; ch < MAX_NUM_COMPONENT; ch++)
+		{
+			const UInt uiNumCoeff = (g_uiMaxCUWidth*g_uiMaxCUHeight) >> (::getComponentScaleX(ComponentID(ch), cform) + ::getComponentScaleY(ComponentID(ch), cform));
+			m_ppcQTTempCoeff[ch][layer] = m_cArena.allocateArray<TCoeff>(uiNumCoeff);
+#if ADAPTIVE_QP_SELECTION
+			m_ppcQTTempArlCoeff[ch][layer] = m_cArena.allocateArray<TCoeff>(uiNumCoeff);
+#endif
+		}
 	}
-	m_pcQTTempTransformSkipTComYuv.create(g_uiMaxCUWidth, g_uiMaxCUHeight, pcEncCfg->getChromaFormatIdc());
-	m_tmpYuvPred.create(MAX_CU_SIZE, MAX_CU_SIZE, pcEncCfg->getChromaFormatIdc());
+	assert(m_cArena.getUsed() == m_cArena.getSize());
 }
 
 #if FASTME_SMOOTHER_MV
@@ -3179,9 +3176,11 @@ Void TEncSearch::predInterSearch(TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*&
 		Distortion   bestBiPDist = std::numeric_limits<Distortion>::max();
 
 		Distortion   uiCostTempL0[MAX_NUM_REF];
+		Bool         abSearchedL0[MAX_NUM_REF];
 		for (Int iNumRef = 0; iNumRef < MAX_NUM_REF; iNumRef++)
 		{
 			uiCostTempL0[iNumRef] = std::numeric_limits<Distortion>::max();
+			abSearchedL0[iNumRef] = false;
 		}
 		UInt         uiBitsTempL0[MAX_NUM_REF];
 
@@ -3213,6 +3212,11 @@ Void TEncSearch::predInterSearch(TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*&
 
 				for (Int iRefIdxTemp = 0; iRefIdxTemp < pcCU->getSlice()->getNumRefIdx(eRefPicList); iRefIdxTemp++)
 				{
+					if (xIsRefPruned(pcCU, eRefPicList, iRefIdxTemp) || xIsRefOutsideAnalysis(pcCU, uiPartAddr, eRefPicList, iRefIdxTemp))
+					{
+						continue;
+					}
+
 					uiBitsTemp = uiMbBits[iRefList];
 					if (pcCU->getSlice()->getNumRefIdx(eRefPicList) > 1)
 					{
@@ -3259,7 +3263,8 @@ Void TEncSearch::predInterSearch(TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*&
 #if GPB_SIMPLE_UNI
 					if (iRefList == 1)    // list 1
 					{
-						if (pcCU->getSlice()->getList1IdxToList0Idx(iRefIdxTemp) >= 0)
+						// the list 0 entry is not searched when AnalysisReuseLevel skips it, the list 1 entry is then searched on its own
+						if (pcCU->getSlice()->getList1IdxToList0Idx(iRefIdxTemp) >= 0 && abSearchedL0[pcCU->getSlice()->getList1IdxToList0Idx(iRefIdxTemp)])
 						{
 							cMvTemp[1][iRefIdxTemp] = cMvTemp[0][pcCU->getSlice()->getList1IdxToList0Idx(iRefIdxTemp)];
 							uiCostTemp = uiCostTempL0[pcCU->getSlice()->getList1IdxToList0Idx(iRefIdxTemp)];
@@ -3294,6 +3299,7 @@ Void TEncSearch::predInterSearch(TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*&
 					{
 						uiCostTempL0[iRefIdxTemp] = uiCostTemp;
 						uiBitsTempL0[iRefIdxTemp] = uiBitsTemp;
+						abSearchedL0[iRefIdxTemp] = true;
 					}
 					if (uiCostTemp < uiCost[iRefList])
 					{
@@ -3318,7 +3324,7 @@ Void TEncSearch::predInterSearch(TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*&
 			}
 
 			//  Bi-directional prediction B֡
-			if ((pcCU->getSlice()->isInterB()) && (pcCU->isBipredRestriction(iPartIdx) == false))
+			if ((pcCU->getSlice()->isInterB()) && (pcCU->isBipredRestriction(iPartIdx) == false) && !xSkipBipredSearch(uiCost[0], uiCost[1]))
 			{
 
 				cMvBi[0] = cMv[0];            cMvBi[1] = cMv[1];
@@ -3376,6 +3382,7 @@ Void TEncSearch::predInterSearch(TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*&
 
 				for (Int iIter = 0; iIter < iNumIter; iIter++)
 				{
+					const Distortion uiCostBiPrev = uiCostBi;
 					Int         iRefList = iIter % 2;
 
 					if (m_pcEncCfg->getUseFastEnc())
@@ -3414,8 +3421,18 @@ Void TEncSearch::predInterSearch(TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*&
 					iRefStart = 0;
 					iRefEnd = pcCU->getSlice()->getNumRefIdx(eRefPicList) - 1;
 
+					// the prediction of the other list is fixed while the reference indices of this list are searched
+					pcOrgYuv->copyPartToPartYuv(&m_cYuvPredTemp, uiPartAddr, iRoiWidth, iRoiHeight);
+					m_cYuvPredTemp.removeHighFreq(&m_acYuvPred[1 - (Int)eRefPicList], uiPartAddr, iRoiWidth, iRoiHeight);
+					m_bBiPredTargetValid = true;
+
 					for (Int iRefIdxTemp = iRefStart; iRefIdxTemp <= iRefEnd; iRefIdxTemp++)
 					{
+						if (xIsRefPruned(pcCU, eRefPicList, iRefIdxTemp) || xIsRefOutsideAnalysis(pcCU, uiPartAddr, eRefPicList, iRefIdxTemp))
+						{
+							continue;
+						}
+
 						uiBitsTemp = uiMbBits[2] + uiMotBits[1 - iRefList];
 						if (pcCU->getSlice()->getNumRefIdx(eRefPicList) > 1)
 						{
@@ -3453,6 +3470,8 @@ Void TEncSearch::predInterSearch(TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*&
 						}
 					} // for loop-iRefIdxTemp
 
+					m_bBiPredTargetValid = false;
+
 					if (!bChanged)
 					{
 						if (uiCostBi <= uiCost[0] && uiCostBi <= uiCost[1])
@@ -3467,6 +3486,12 @@ Void TEncSearch::predInterSearch(TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*&
 						}
 						break;
 					}
+
+					// stop refining when the last iteration hardly improved the cost
+					if (uiCostBiPrev != std::numeric_limits<Distortion>::max() && Double(uiCostBiPrev - uiCostBi) < m_pcEncCfg->getBipredMinGain() * Double(uiCostBiPrev))
+					{
+						break;
+					}
 				} // for loop-iter
 			} // if (B_SLICE)
 #if ZERO_MVD_EST
@@ -4059,6 +4084,10 @@ Void TEncSearch::xMotionEstimation(TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPar
 
 	assert(eRefPicList < MAX_NUM_REF_LIST_ADAPT_SR && iRefIdxPred < Int(MAX_IDX_ADAPT_SR));
 	m_iSearchRange = m_aaiAdaptSR[eRefPicList][iRefIdxPred];
+	if (m_pcEncCfg->getUseCtuSearchControl())
+	{
+		m_iSearchRange = xGetCtuSearchRange(pcCU, eRefPicList, iRefIdxPred, m_iSearchRange);
+	}
 
 	Int           iSrchRng = (bBi ? m_bipredSearchRange : m_iSearchRange);
 	TComPattern   tmpPattern;
@@ -4073,9 +4102,12 @@ Void TEncSearch::xMotionEstimation(TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPar
 		TComYuv*  pcYuvOther = &m_acYuvPred[1 - (Int)eRefPicList];
 		pcYuv = &m_cYuvPredTemp;
 
-		pcYuvOrg->copyPartToPartYuv(pcYuv, uiPartAddr, iRoiWidth, iRoiHeight);
+		if (!m_bBiPredTargetValid)
+		{
+			pcYuvOrg->copyPartToPartYuv(pcYuv, uiPartAddr, iRoiWidth, iRoiHeight);
 
-		pcYuv->removeHighFreq(pcYuvOther, uiPartAddr, iRoiWidth, iRoiHeight);
+			pcYuv->removeHighFreq(pcYuvOther, uiPartAddr, iRoiWidth, iRoiHeight);
+		}
 
 		fWeight = 0.5;
 	}
@@ -4091,7 +4123,17 @@ Void TEncSearch::xMotionEstimation(TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPar
 
 	TComMv      cMvPred = *pcMvPred;
 
+	// the MV of a reference encode for the same reference picture replaces the predictor as search centre
+	TComMv      cMvHint;
+	const Bool  bMvHint = !bBi && xGetAnalysisMv(pcCU, uiPartAddr, eRefPicList, iRefIdxPred, cMvHint);
+	if (bMvHint)
+	{
+		iSrchRng = std::min(iSrchRng, ANALYSIS_MV_REFINE_RANGE);
+		m_iSearchRange = iSrchRng;
+	}
+
 	if (bBi)  xSetSearchRange(pcCU, rcMv, iSrchRng, cMvSrchRngLT, cMvSrchRngRB);
+	else if (bMvHint) xSetSearchRange(pcCU, cMvHint, iSrchRng, cMvSrchRngLT, cMvSrchRngRB);
 	else        xSetSearchRange(pcCU, cMvPred, iSrchRng, cMvSrchRngLT, cMvSrchRngRB);
 
 	m_pcRdCost->getMotionCost(true, 0, pcCU->getCUTransquantBypass(uiPartAddr));
@@ -4117,6 +4159,12 @@ Void TEncSearch::xMotionEstimation(TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPar
 #endif
 				pIntegerMv2Nx2NPred = &(m_integerMv2Nx2N[eRefPicList][iRefIdxPred]);
 		}
+		TComMv cIntegerMvHint = cMvHint;
+		if (bMvHint)
+		{
+			cIntegerMvHint >>= 2;
+			pIntegerMv2Nx2NPred = &cIntegerMvHint;
+		}
 		xPatternSearchFast(pcCU, pcPatternKey, piRefY, iRefStride, &cMvSrchRngLT, &cMvSrchRngRB, rcMv, ruiCost, pIntegerMv2Nx2NPred);
 		if (pcCU->getPartitionSize(0) == SIZE_2Nx2N)
 		{
@@ -4165,6 +4213,237 @@ Void TEncSearch::xSetSearchRange(TComDataCU* pcCU, TComMv& cMvPred, Int iSrchRng
 
 
 
+/** Derive the search range of a CTU from the motion of its neighbouring and co-located CTUs
+ * \param pcCU        CU being searched
+ * \param eRefPicList reference picture list
+ * \param iRefIdx     reference index
+ * \param iSrchRng    configured (or POC-adapted) search range
+ * \returns search range scaled to the POC distance of the reference, limited to a quarter and twice the configured range
+ */
+Int TEncSearch::xGetCtuSearchRange(TComDataCU* pcCU, RefPicList eRefPicList, Int iRefIdx, Int iSrchRng)
+{
+	if (m_dCtuMotionPerPOC < 0.0)
+	{
+		return iSrchRng;
+	}
+
+	const Int iPOCDist = abs(pcCU->getSlice()->getPOC() - pcCU->getSlice()->getRefPOC(eRefPicList, iRefIdx));
+	const Int iMotionRange = Int(ceil(m_dCtuMotionPerPOC * iPOCDist)) + CTU_SR_MARGIN;
+
+	return Clip3(min(iSrchRng, max(iSrchRng >> 2, CTU_SR_MARGIN)), iSrchRng << 1, iMotionRange);
+}
+
+
+
+
+/** Get the MV a reference encode used for a prediction unit
+ * \param pcCU        CU being searched
+ * \param uiPartAddr  first partition of the prediction unit
+ * \param eRefPicList reference picture list
+ * \param iRefIdx     reference index
+ * \param rcMv        returns the MV in quarter samples
+ * \returns false if there are no hints or the reference encode did not predict the partition from this reference picture
+ */
+Bool TEncSearch::xGetAnalysisMv(TComDataCU* pcCU, UInt uiPartAddr, RefPicList eRefPicList, Int iRefIdx, TComMv& rcMv)
+{
+	if (m_pcAnalysisCtu == NULL)
+	{
+		return false;
+	}
+
+	const TEncCuAnalysisUnit& rcUnit = m_pcAnalysisCtu[pcCU->getZorderIdxInCU() + uiPartAddr];
+	if (rcUnit.predMode != MODE_INTER || (rcUnit.interDir & (1 << eRefPicList)) == 0 || rcUnit.refIdx[eRefPicList] != iRefIdx)
+	{
+		return false;
+	}
+
+	rcMv.set(rcUnit.mv[eRefPicList][0], rcUnit.mv[eRefPicList][1]);
+	return true;
+}
+
+/** Check whether a reference picture is skipped because the decisions of a reference encode are reused
+ * \param pcCU        CU being searched
+ * \param uiPartAddr  first partition of the prediction unit
+ * \param eRefPicList reference picture list
+ * \param iRefIdx     reference index
+ * \returns true when AnalysisReuseLevel is set and the reference encode predicted the partition from another
+ *          reference picture of the list; the first reference picture of each list is always searched
+ */
+Bool TEncSearch::xIsRefOutsideAnalysis(TComDataCU* pcCU, UInt uiPartAddr, RefPicList eRefPicList, Int iRefIdx)
+{
+	if (m_pcAnalysisCtu == NULL || m_pcEncCfg->getAnalysisReuseLevel() == 0 || iRefIdx == 0)
+	{
+		return false;
+	}
+
+	const TEncCuAnalysisUnit& rcUnit = m_pcAnalysisCtu[pcCU->getZorderIdxInCU() + uiPartAddr];
+	if (rcUnit.predMode != MODE_INTER)
+	{
+		return false;
+	}
+	return (rcUnit.interDir & (1 << eRefPicList)) == 0 || rcUnit.refIdx[eRefPicList] != iRefIdx;
+}
+
+
+
+
+/** Check whether a reference picture is skipped by the motion search of the current CTU
+ * \param pcCU        CU being searched
+ * \param eRefPicList reference picture list
+ * \param iRefIdx     reference index
+ * \returns true when the reference has been selected for less than RefPruneThreshold of the inter-coded area of the slice
+ *
+ * The first reference picture of each list is never pruned. The decision only depends on the POC of the reference, so
+ * that a list 1 entry that duplicates a list 0 entry is treated in the same way (required by GPB_SIMPLE_UNI).
+ */
+Bool TEncSearch::xIsRefPruned(TComDataCU* pcCU, RefPicList eRefPicList, Int iRefIdx)
+{
+	if (!m_pcEncCfg->getUseCtuSearchControl() || m_uiRefSelTotal < REF_PRUNE_MIN_SAMPLES)
+	{
+		return false;
+	}
+
+	TComSlice* pcSlice = pcCU->getSlice();
+	const Int  iRefPOC = pcSlice->getRefPOC(eRefPicList, iRefIdx);
+	if (iRefPOC == pcSlice->getRefPOC(REF_PIC_LIST_0, 0) || (pcSlice->isInterB() && iRefPOC == pcSlice->getRefPOC(REF_PIC_LIST_1, 0)))
+	{
+		return false;
+	}
+
+	return m_auiRefSelCount[eRefPicList][iRefIdx] < m_pcEncCfg->getRefPruneThreshold() * m_uiRefSelTotal;
+}
+
+
+
+
+/** Check whether the bi-prediction search can be skipped for a PU
+ * \param uiCostL0 best uni-prediction cost of list 0
+ * \param uiCostL1 best uni-prediction cost of list 1
+ * \returns true when BipredSkipRatio is set and one uni-prediction cost exceeds the other by more than this ratio
+ */
+Bool TEncSearch::xSkipBipredSearch(Distortion uiCostL0, Distortion uiCostL1)
+{
+	const Double dRatio = m_pcEncCfg->getBipredSkipRatio();
+	if (dRatio <= 0.0 || uiCostL0 == std::numeric_limits<Distortion>::max() || uiCostL1 == std::numeric_limits<Distortion>::max())
+	{
+		return false;
+	}
+
+	return Double(max(uiCostL0, uiCostL1)) > dRatio * Double(min(uiCostL0, uiCostL1));
+}
+
+
+
+
+Void TEncSearch::resetRefSelectionStats()
+{
+	::memset(m_auiRefSelCount, 0, sizeof(m_auiRefSelCount));
+	m_uiRefSelTotal = 0;
+}
+
+
+
+
+/** Gather the largest motion per POC distance of the neighbouring and co-located CTUs
+ * \param pcCtu CTU about to be compressed
+ */
+Void TEncSearch::initCtuSearchControl(TComDataCU* pcCtu)
+{
+	TComDataCU* apcNeighbours[] = { pcCtu->getCULeft(), pcCtu->getCUAbove(), pcCtu->getCUAboveLeft(), pcCtu->getCUAboveRight(),
+	                                pcCtu->getCUColocated(REF_PIC_LIST_0), pcCtu->getCUColocated(REF_PIC_LIST_1) };
+
+	const Int   iNumNeighbours = Int(sizeof(apcNeighbours) / sizeof(apcNeighbours[0]));
+
+	m_dCtuMotionPerPOC = -1.0;
+	for (Int i = 0; i < iNumNeighbours; i++)
+	{
+		if (apcNeighbours[i] != NULL && apcNeighbours[i]->getSlice() != NULL)
+		{
+			xAccumulateCtuMotion(apcNeighbours[i]);
+		}
+	}
+}
+
+
+
+
+Void TEncSearch::xAccumulateCtuMotion(TComDataCU* pcCU)
+{
+	TComSlice* pcSlice = pcCU->getSlice();
+	const Int  iPOC = pcSlice->getPOC();
+
+	for (UInt uiPartIdx = 0; uiPartIdx < pcCU->getTotalNumPart(); uiPartIdx++)
+	{
+		if (!pcCU->isInter(uiPartIdx))
+		{
+			continue;
+		}
+		for (UInt uiRefList = 0; uiRefList < NUM_REF_PIC_LIST_01; uiRefList++)
+		{
+			const RefPicList eRefPicList = RefPicList(uiRefList);
+			const Int        iRefIdx = pcCU->getCUMvField(eRefPicList)->getRefIdx(uiPartIdx);
+			if (!(pcCU->getInterDir(uiPartIdx) & (1 << uiRefList)) || iRefIdx < 0)
+			{
+				continue;
+			}
+			const Int iPOCDist = abs(iPOC - pcSlice->getRefPOC(eRefPicList, iRefIdx));
+			if (iPOCDist > 0)
+			{
+				const TComMv cMv = pcCU->getCUMvField(eRefPicList)->getMv(uiPartIdx);
+				const Int    iMvMax = max(abs(cMv.getHor()), abs(cMv.getVer()));
+				m_dCtuMotionPerPOC = max(m_dCtuMotionPerPOC, Double(iMvMax) / (4 * iPOCDist));
+			}
+		}
+	}
+}
+
+
+
+
+/** Count the reference pictures selected by the inter-coded 4x4 units of a coded CTU
+ * \param pcCtu CTU after mode decision
+ */
+Void TEncSearch::updateRefSelectionStats(TComDataCU* pcCtu)
+{
+	TComSlice* pcSlice = pcCtu->getSlice();
+	const Int  iNumPredDir = pcSlice->isInterP() ? 1 : 2;
+
+	for (UInt uiPartIdx = 0; uiPartIdx < pcCtu->getTotalNumPart(); uiPartIdx++)
+	{
+		if (!pcCtu->isInter(uiPartIdx))
+		{
+			continue;
+		}
+
+		Int aiSelPOC[NUM_REF_PIC_LIST_01] = { MAX_INT, MAX_INT };
+		for (Int iRefList = 0; iRefList < iNumPredDir; iRefList++)
+		{
+			const Int iRefIdx = pcCtu->getCUMvField(RefPicList(iRefList))->getRefIdx(uiPartIdx);
+			if ((pcCtu->getInterDir(uiPartIdx) & (1 << iRefList)) && iRefIdx >= 0)
+			{
+				aiSelPOC[iRefList] = pcSlice->getRefPOC(RefPicList(iRefList), iRefIdx);
+			}
+		}
+
+		m_uiRefSelTotal++;
+		for (Int iRefList = 0; iRefList < iNumPredDir; iRefList++)
+		{
+			const RefPicList eRefPicList = RefPicList(iRefList);
+			for (Int iRefIdx = 0; iRefIdx < pcSlice->getNumRefIdx(eRefPicList); iRefIdx++)
+			{
+				const Int iRefPOC = pcSlice->getRefPOC(eRefPicList, iRefIdx);
+				if (iRefPOC == aiSelPOC[0] || iRefPOC == aiSelPOC[1])
+				{
+					m_auiRefSelCount[eRefPicList][iRefIdx]++;
+				}
+			}
+		}
+	}
+}
+
+
+
+
 Void TEncSearch::xPatternSearch(TComPattern* pcPatternKey, Pel* piRefY, Int iRefStride, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB, TComMv& rcMv, Distortion& ruiSAD)
 {
 	Int   iSrchRngHorLeft = pcMvSrchRngLT->getHor();
@@ -46,9 +46,11 @@
 #include "TLibCommon/TComTrQuant.h"
 #include "TLibCommon/TComPic.h"
 #include "TLibCommon/TComRectangle.h"
+#include "TLibCommon/TComMemArena.h"
 #include "TEncEntropy.h"
 #include "TEncSbac.h"
 #include "TEncCfg.h"
+#include "TEncCuAnalysis.h"
 
 
 //! \ingroup TLibEncoder
@@ -89,6 +91,8 @@ private:
   TCoeff*         m_ppcQTTempTUArlCoeff[MAX_NUM_COMPONENT];
 #endif
 
+  TComMemArena    m_cArena;       ///< holds all the temporary buffers above and m_pTempPel
+
 protected:
   // interface to option
   TEncCfg*        m_pcEncCfg;
@@ -107,6 +111,15 @@ protected:
   TComMv          m_cSrchRngRB;
   TComMv          m_acMvPredictors[NUM_MV_PREDICTORS]; // Left, Above, AboveRight. enum MVP_DIR first NUM_MV_PREDICTORS entries are suitable for accessing.
 
+  // per-CTU search control
+  Double          m_dCtuMotionPerPOC;                              ///< largest neighbouring MV component per POC distance in integer samples, negative if unknown
+  UInt            m_auiRefSelCount[NUM_REF_PIC_LIST_01][MAX_NUM_REF]; ///< inter-coded 4x4 units of the current slice predicted from each reference picture
+  UInt            m_uiRefSelTotal;                                 ///< inter-coded 4x4 units of the current slice
+
+  const TEncCuAnalysisUnit* m_pcAnalysisCtu;                       ///< decisions of a reference encode for the current CTU, NULL if none
+
+  Bool            m_bBiPredTargetValid;                            ///< m_cYuvPredTemp already holds the bi-prediction search target
+
   // RD computation
   TEncSbac***     m_pppcRDSbacCoder;
   TEncSbac*       m_pcRDGoOnSbacCoder;
@@ -216,6 +229,16 @@ public:
   /// set ME search range
   Void setAdaptiveSearchRange   ( Int iDir, Int iRefIdx, Int iSearchRange) { assert(iDir < MAX_NUM_REF_LIST_ADAPT_SR && iRefIdx<Int(MAX_IDX_ADAPT_SR)); m_aaiAdaptSR[iDir][iRefIdx] = iSearchRange; }
 
+  /// per-CTU search control: reset the reference selection statistics at the start of a slice
+  Void resetRefSelectionStats   ();
+  /// per-CTU search control: gather the motion of the neighbouring and co-located CTUs before the CTU is searched
+  Void initCtuSearchControl     ( TComDataCU* pcCtu );
+  /// per-CTU search control: count the reference pictures selected in a coded CTU
+  Void updateRefSelectionStats  ( TComDataCU* pcCtu );
+
+  /// set the decisions of a reference encode for the CTU to be searched (NULL for none): their MVs become search centres
+  Void setAnalysisCtu           ( const TEncCuAnalysisUnit* pcAnalysisCtu ) { m_pcAnalysisCtu = pcAnalysisCtu; }
+
   Void xEncPCM    (TComDataCU* pcCU, UInt uiAbsPartIdx, Pel* piOrg, Pel* piPCM, Pel* piPred, Pel* piResi, Pel* piReco, UInt uiStride, UInt uiWidth, UInt uiHeight, const ComponentID compID );
   Void IPCMSearch (TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*& rpcPredYuv, TComYuv*& rpcResiYuv, TComYuv*& rpcRecoYuv );
 protected:
@@ -415,6 +438,31 @@ protected:
                                     TComMv&      rcMvSrchRngLT,
                                     TComMv&      rcMvSrchRngRB );
 
+  Int  xGetCtuSearchRange         ( TComDataCU*  pcCU,
+                                    RefPicList   eRefPicList,
+                                    Int          iRefIdx,
+                                    Int          iSrchRng );
+
+  Bool xSkipBipredSearch          ( Distortion   uiCostL0,
+                                    Distortion   uiCostL1 );
+
+  Bool xIsRefPruned               ( TComDataCU*  pcCU,
+                                    RefPicList   eRefPicList,
+                                    Int          iRefIdx );
+
+  Void xAccumulateCtuMotion       ( TComDataCU*  pcCU );
+
+  Bool xGetAnalysisMv             ( TComDataCU*  pcCU,
+                                    UInt         uiPartAddr,
+                                    RefPicList   eRefPicList,
+                                    Int          iRefIdx,
+                                    TComMv&      rcMv );
+
+  Bool xIsRefOutsideAnalysis      ( TComDataCU*  pcCU,
+                                    UInt         uiPartAddr,
+                                    RefPicList   eRefPicList,
+                                    Int          iRefIdx );
+
   Void xPatternSearchFast         ( TComDataCU*  pcCU,
                                     TComPattern* pcPatternKey,
                                     Pel*         piRefY,
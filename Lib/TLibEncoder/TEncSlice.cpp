@@ -214,6 +214,7 @@ Void TEncSlice::initEncSlice( TComPic* pcPic, Int pocLast, Int pocCurr, Int iNum
 {
   Double dQP;
   Double dLambda;
+  const Int iSceneCutPOC = m_pcGOPEncoder->getLastSceneCutPOC(); // the coding structure restarts at a scene cut
 
   rpcSlice = pcPic->getSlice(0);
   rpcSlice->setSPS( pSPS );
@@ -235,7 +236,7 @@ Void TEncSlice::initEncSlice( TComPic* pcPic, Int pocLast, Int pocCurr, Int iNum
     }
     else
     {
-      poc = poc % m_pcCfg->getGOPSize();   
+      poc = (poc - iSceneCutPOC) % m_pcCfg->getGOPSize();   
     }
 #else
     Int poc = rpcSlice->getPOC()%m_pcCfg->getGOPSize();
@@ -290,12 +291,12 @@ Void TEncSlice::initEncSlice( TComPic* pcPic, Int pocLast, Int pocCurr, Int iNum
 #if ALLOW_RECOVERY_POINT_AS_RAP
     if(m_pcCfg->getDecodingRefreshType() == 3)
     {
-      eSliceType = (pocLast == 0 || pocCurr % m_pcCfg->getIntraPeriod() == 0             || m_pcGOPEncoder->getGOPSize() == 0) ? I_SLICE : eSliceType;
+      eSliceType = (pocLast == iSceneCutPOC || (pocCurr - iSceneCutPOC) % m_pcCfg->getIntraPeriod() == 0 || m_pcGOPEncoder->getGOPSize() == 0) ? I_SLICE : eSliceType;
     }
     else
     {
 #endif
-      eSliceType = (pocLast == 0 || (pocCurr - (isField ? 1 : 0)) % m_pcCfg->getIntraPeriod() == 0 || m_pcGOPEncoder->getGOPSize() == 0) ? I_SLICE : eSliceType;
+      eSliceType = (pocLast == iSceneCutPOC || (pocCurr - iSceneCutPOC - (isField ? 1 : 0)) % m_pcCfg->getIntraPeriod() == 0 || m_pcGOPEncoder->getGOPSize() == 0) ? I_SLICE : eSliceType;
 #if ALLOW_RECOVERY_POINT_AS_RAP
     }
 #endif
@@ -309,7 +310,7 @@ Void TEncSlice::initEncSlice( TComPic* pcPic, Int pocLast, Int pocCurr, Int iNum
   // Non-referenced frame marking
   // ------------------------------------------------------------------------------------------------------------------
 
-  if(pocLast == 0)
+  if(pocLast == iSceneCutPOC)
   {
     rpcSlice->setTemporalLayerNonReferenceFlag(false);
   }
@@ -425,12 +426,12 @@ Void TEncSlice::initEncSlice( TComPic* pcPic, Int pocLast, Int pocCurr, Int iNum
 #if ALLOW_RECOVERY_POINT_AS_RAP
     if(m_pcCfg->getDecodingRefreshType() == 3)
     {
-      eSliceType = (pocLast == 0 || (pocCurr)                     % m_pcCfg->getIntraPeriod() == 0 || m_pcGOPEncoder->getGOPSize() == 0) ? I_SLICE : eSliceType;
+      eSliceType = (pocLast == iSceneCutPOC || (pocCurr - iSceneCutPOC) % m_pcCfg->getIntraPeriod() == 0 || m_pcGOPEncoder->getGOPSize() == 0) ? I_SLICE : eSliceType;
     }
     else
     {
 #endif
-      eSliceType = (pocLast == 0 || (pocCurr - (isField ? 1 : 0)) % m_pcCfg->getIntraPeriod() == 0 || m_pcGOPEncoder->getGOPSize() == 0) ? I_SLICE : eSliceType;
+      eSliceType = (pocLast == iSceneCutPOC || (pocCurr - iSceneCutPOC - (isField ? 1 : 0)) % m_pcCfg->getIntraPeriod() == 0 || m_pcGOPEncoder->getGOPSize() == 0) ? I_SLICE : eSliceType;
 #if ALLOW_RECOVERY_POINT_AS_RAP
     }
 #endif
@@ -693,6 +694,11 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
   pppcRDSbacCoder->setBinCountingEnableFlag( false );
   pppcRDSbacCoder->setBinsCoded( 0 );
 
+  if ( m_pcCfg->getUseCtuSearchControl() )
+  {
+    m_pcPredSearch->resetRefSelectionStats();
+  }
+
   //------------------------------------------------------------------------------
   //  Weighted Prediction parameters estimation.
   //------------------------------------------------------------------------------
@@ -714,7 +720,7 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
       printf("Weighted Prediction is not supported with slice mode determined by max number of bins.\n"); exit(0);
     }
 
-    xEstimateWPParamSlice( pcSlice );
+    xEstimateWPParamSlice( pcSlice, m_pcCfg->getUseWPFastSelect() );
     pcSlice->initWpScaling();
 
     // check WP on/off
@@ -882,15 +888,31 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
       }
       else
       {
-        bpp = m_pcRateCtrl->getRCPic()->getLCUTargetBpp(pcSlice->getSliceType());
-        if ( rpcPic->getSlice( 0 )->getSliceType() == I_SLICE)
+        if ( m_pcCfg->getRCCtuRowLevelRC() )
         {
-          estLambda = m_pcRateCtrl->getRCPic()->getLCUEstLambdaAndQP(bpp, pcSlice->getSliceQp(), &estQP);
+          // one lambda and QP for the whole CTU row (within the current tile)
+          TEncRCPic* pcRCPic = m_pcRateCtrl->getRCPic();
+          if ( !pcRCPic->isCtuRowActive() )
+          {
+            TComTile* pcTile = rpcPic->getPicSym()->getTComTile( rpcPic->getPicSym()->getTileIdxMap( uiCUAddr ) );
+            bpp = pcRCPic->getCtuRowTargetBpp( uiTileLCUX + pcTile->getTileWidth() - uiCol, pcSlice->getSliceType() );
+            pcRCPic->estimateCtuRowLambdaAndQP( bpp, pcSlice->getSliceQp(), pcSlice->getSliceType() );
+          }
+          estLambda = pcRCPic->getCtuRowLambda();
+          estQP     = pcRCPic->getCtuRowQP();
         }
         else
         {
-          estLambda = m_pcRateCtrl->getRCPic()->getLCUEstLambda( bpp );
-          estQP     = m_pcRateCtrl->getRCPic()->getLCUEstQP    ( estLambda, pcSlice->getSliceQp() );
+          bpp = m_pcRateCtrl->getRCPic()->getLCUTargetBpp(pcSlice->getSliceType());
+          if ( rpcPic->getSlice( 0 )->getSliceType() == I_SLICE)
+          {
+            estLambda = m_pcRateCtrl->getRCPic()->getLCUEstLambdaAndQP(bpp, pcSlice->getSliceQp(), &estQP);
+          }
+          else
+          {
+            estLambda = m_pcRateCtrl->getRCPic()->getLCUEstLambda( bpp );
+            estQP     = m_pcRateCtrl->getRCPic()->getLCUEstQP    ( estLambda, pcSlice->getSliceQp() );
+          }
         }
 
         estQP     = Clip3( -pcSlice->getSPS()->getQpBDOffset(CHANNEL_TYPE_LUMA), MAX_QP, estQP );
@@ -914,7 +936,15 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
     }
 
     // run CU encoder
+    if ( m_pcCfg->getUseCtuSearchControl() && !pcSlice->isIntra() )
+    {
+      m_pcPredSearch->initCtuSearchControl( pcCU );
+    }
     m_pcCuEncoder->compressCU( pcCU );
+    if ( m_pcCfg->getUseCtuSearchControl() && !pcSlice->isIntra() )
+    {
+      m_pcPredSearch->updateRefSelectionStats( pcCU );
+    }
 
     // restore entropy coder to an initial stage
     m_pcEntropyCoder->setEntropyCoder ( m_pppcRDSbacCoder[0][CI_CURR_BEST], pcSlice );
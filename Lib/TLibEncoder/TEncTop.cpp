@@ -57,6 +57,10 @@ TEncTop::TEncTop()
   m_uiNumAllPicCoded  =  0;
   m_pppcRDSbacCoder   =  NULL;
   m_pppcBinCoderCABAC =  NULL;
+  m_sceneCutLastDiff  =  0;
+  m_pcAccessUnitSink  = NULL;
+  m_pcCuAnalysisOutput = NULL;
+  m_pcCuAnalysisInput  = NULL;
   m_cRDGoOnSbacCoder.init( &m_cRDGoOnBinCoderCABAC );
 #if ENC_DEC_TRACE
   if (g_hTrace == NULL)
@@ -119,11 +123,14 @@ Void TEncTop::create ()
 #endif
 
   m_cLoopFilter.create( g_uiMaxCUDepth );
+  m_cPreanalyzer.create( m_bUseAdaptiveQP && m_bUseAdaptiveQPThread );
 
   if ( m_RCEnableRateControl )
   {
     m_cRateCtrl.init( m_framesToBeEncoded, m_RCTargetBitrate, m_iFrameRate, m_iGOPSize, m_iSourceWidth, m_iSourceHeight,
                       g_uiMaxCUWidth, g_uiMaxCUHeight, m_RCKeepHierarchicalBit, m_RCUseLCUSeparateModel, m_GOPList );
+    m_cRateCtrl.getRCSeq()->setModelParameters( m_RCSmoothWindowSize, m_RCCtuSmoothWindowSize, m_RCAlphaUpdate, m_RCBetaUpdate );
+    m_cRateCtrl.getRCSeq()->initCpb( m_RCCpbSize, m_RCCpbInitialDelay );
   }
 
   m_pppcRDSbacCoder = new TEncSbac** [g_uiMaxCUDepth+1];
@@ -215,6 +222,7 @@ Void TEncTop::destroy ()
   }
   m_cLoopFilter.        destroy();
   m_cRateCtrl.          destroy();
+  m_cPreanalyzer.       destroy();
   Int iDepth;
   for ( iDepth = 0; iDepth < g_uiMaxCUDepth+1; iDepth++ )
   {
@@ -342,6 +350,8 @@ Void TEncTop::deletePicBuffer()
  */
 Void TEncTop::encode( Bool flush, TComPicYuv* pcPicYuvOrg, TComPicYuv* pcPicYuvTrueOrg, const InputColourSpaceConversion snrCSC, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsOut, Int& iNumEncoded )
 {
+  Bool bSceneCut = false;
+
   if (pcPicYuvOrg != NULL)
   {
     // get original YUV
@@ -354,10 +364,58 @@ Void TEncTop::encode( Bool flush, TComPicYuv* pcPicYuvOrg, TComPicYuv* pcPicYuvT
     // compute image characteristics
     if ( getUseAdaptiveQP() )
     {
-      m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcPicCurr ) );
+      m_cPreanalyzer.preanalyze( dynamic_cast<TEncPic*>( pcPicCurr ) );
+    }
+
+    if ( m_sceneCutDetection && m_uiIntraPeriod != 1 )
+    {
+      bSceneCut = xDetectSceneCut( pcPicCurr->getPicYuvOrg() ) && m_iPOCLast > 0;
     }
   }
 
+  if ( bSceneCut )
+  {
+    // the pictures received before the cut are coded as a shortened GOP, then the cut picture is coded on its own as
+    // a random access point, and the GOP structure restarts from it in the same way as at the start of the sequence
+    iNumEncoded = 0;
+    m_cPreanalyzer.waitForCompletion();
+    if ( m_iNumPicRcvd > 1 )
+    {
+      // the reconstruction buffer of the cut picture is the last one in the list and is not part of the shortened GOP
+      TComPicYuv* pcPicYuvRecCut = rcListPicYuvRecOut.popBack();
+
+      if ( m_RCEnableRateControl )
+      {
+        m_cRateCtrl.initRCGOP( m_iNumPicRcvd - 1 );
+      }
+      m_cGOPEncoder.compressGOP(m_iPOCLast - 1, m_iNumPicRcvd - 1, m_cListPic, rcListPicYuvRecOut, accessUnitsOut, false, false, snrCSC, m_printFrameMSE);
+      if ( m_RCEnableRateControl )
+      {
+        m_cRateCtrl.destroyRCGOP();
+      }
+
+      rcListPicYuvRecOut.pushBack( pcPicYuvRecCut );
+      iNumEncoded = m_iNumPicRcvd - 1;
+    }
+
+    m_cGOPEncoder.setLastSceneCutPOC( m_iPOCLast );
+
+    if ( m_RCEnableRateControl )
+    {
+      m_cRateCtrl.initRCGOP( 1 );
+    }
+    m_cGOPEncoder.compressGOP(m_iPOCLast, 1, m_cListPic, rcListPicYuvRecOut, accessUnitsOut, false, false, snrCSC, m_printFrameMSE);
+    if ( m_RCEnableRateControl )
+    {
+      m_cRateCtrl.destroyRCGOP();
+    }
+
+    iNumEncoded        += 1;
+    m_iNumPicRcvd       = 0;
+    m_uiNumAllPicCoded += iNumEncoded;
+    return;
+  }
+
   if ((m_iNumPicRcvd == 0) || (!flush && (m_iPOCLast != 0) && (m_iNumPicRcvd != m_iGOPSize) && (m_iGOPSize != 0)))
   {
     iNumEncoded = 0;
@@ -370,6 +428,7 @@ Void TEncTop::encode( Bool flush, TComPicYuv* pcPicYuvOrg, TComPicYuv* pcPicYuvT
   }
 
   // compress GOP
+  m_cPreanalyzer.waitForCompletion();
   m_cGOPEncoder.compressGOP(m_iPOCLast, m_iNumPicRcvd, m_cListPic, rcListPicYuvRecOut, accessUnitsOut, false, false, snrCSC, m_printFrameMSE);
 
   if ( m_RCEnableRateControl )
@@ -465,13 +524,14 @@ Void TEncTop::encode(Bool flush, TComPicYuv* pcPicYuvOrg, TComPicYuv* pcPicYuvTr
       // compute image characteristics
       if ( getUseAdaptiveQP() )
       {
-        m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcField ) );
+        m_cPreanalyzer.preanalyze( dynamic_cast<TEncPic*>( pcField ) );
       }
     }
 
     if ( m_iNumPicRcvd && ((flush&&fieldNum==1) || (m_iPOCLast/2)==0 || m_iNumPicRcvd==m_iGOPSize ) )
     {
       // compress GOP
+      m_cPreanalyzer.waitForCompletion();
       m_cGOPEncoder.compressGOP(m_iPOCLast, m_iNumPicRcvd, m_cListPic, rcListPicYuvRecOut, accessUnitsOut, true, isTff, snrCSC, m_printFrameMSE);
 
       iNumEncoded += m_iNumPicRcvd;
@@ -535,6 +595,68 @@ Void TEncTop::xGetNewPicBuffer ( TComPic*& rpcPic )
   rpcPic->getPicYuvRec()->setBorderExtension(false);
 }
 
+/**
+ - compute the average of every 8x8 luma block of the original picture
+ - compare it with the block averages of the previous original picture
+ - a scene cut is signalled when the mean absolute block difference increases by more than the configured threshold
+   with respect to the difference between the two previous pictures, so that fast but continuous motion is not
+   mistaken for a cut
+ .
+ \param  pcPicYuvOrg original picture
+ \retval true if the picture starts a new scene
+ */
+Bool TEncTop::xDetectSceneCut( TComPicYuv* pcPicYuvOrg )
+{
+  const Int  iBlkSizeLog2 = 3;
+  const Int  iStride      = pcPicYuvOrg->getStride(COMPONENT_Y);
+  const Int  iNumBlkX     = pcPicYuvOrg->getWidth (COMPONENT_Y) >> iBlkSizeLog2;
+  const Int  iNumBlkY     = pcPicYuvOrg->getHeight(COMPONENT_Y) >> iBlkSizeLog2;
+  const Int  iShift       = 2 * iBlkSizeLog2 + g_bitDepth[CHANNEL_TYPE_LUMA] - 8;   // block average in 8-bit units
+
+  if ( iNumBlkX == 0 || iNumBlkY == 0 )
+  {
+    return false;
+  }
+
+  std::vector<Int> blockMean( iNumBlkX * iNumBlkY );
+  const Pel* pOrg = pcPicYuvOrg->getAddr(COMPONENT_Y);
+
+  for ( Int by = 0; by < iNumBlkY; by++ )
+  {
+    for ( Int bx = 0; bx < iNumBlkX; bx++ )
+    {
+      const Pel* pBlk = pOrg + ( by << iBlkSizeLog2 ) * iStride + ( bx << iBlkSizeLog2 );
+      Int iSum = 0;
+      for ( Int y = 0; y < ( 1 << iBlkSizeLog2 ); y++ )
+      {
+        for ( Int x = 0; x < ( 1 << iBlkSizeLog2 ); x++ )
+        {
+          iSum += pBlk[x];
+        }
+        pBlk += iStride;
+      }
+      blockMean[by * iNumBlkX + bx] = ( iSum + ( 1 << ( iShift - 1 ) ) ) >> iShift;
+    }
+  }
+
+  Bool bSceneCut = false;
+  if ( m_sceneCutBlockMean.size() == blockMean.size() )
+  {
+    Int64 iSad = 0;
+    for ( UInt i = 0; i < blockMean.size(); i++ )
+    {
+      iSad += abs( blockMean[i] - m_sceneCutBlockMean[i] );
+    }
+    const Double dDiff = Double( iSad ) / blockMean.size();
+
+    bSceneCut          = ( dDiff - m_sceneCutLastDiff ) > m_sceneCutThreshold;
+    m_sceneCutLastDiff = dDiff;
+  }
+  m_sceneCutBlockMean.swap( blockMean );
+
+  return bSceneCut;
+}
+
 Void TEncTop::xInitSPS()
 {
   ProfileTierLevel& profileTierLevel = *m_cSPS.getPTL()->getGeneralPTL();
@@ -1010,7 +1132,7 @@ Void TEncTop::selectReferencePictureSet(TComSlice* slice, Int POCCurr, Int GOPid
   {
     if(m_uiIntraPeriod > 0 && getDecodingRefreshType() > 0)
     {
-      Int POCIndex = POCCurr%m_uiIntraPeriod;
+      Int POCIndex = (POCCurr - m_cGOPEncoder.getLastSceneCutPOC())%m_uiIntraPeriod;
       if(POCIndex == 0)
       {
         POCIndex = m_uiIntraPeriod;
@@ -1022,7 +1144,7 @@ Void TEncTop::selectReferencePictureSet(TComSlice* slice, Int POCCurr, Int GOPid
     }
     else
     {
-      if(POCCurr==m_GOPList[extraNum].m_POC)
+      if(POCCurr - m_cGOPEncoder.getLastSceneCutPOC()==m_GOPList[extraNum].m_POC)
       {
         slice->setRPSidx(extraNum);
       }
@@ -1046,7 +1168,7 @@ Int TEncTop::getReferencePictureSetIdxForSOP(TComSlice* slice, Int POCCurr, Int
   {
     if(m_uiIntraPeriod > 0 && getDecodingRefreshType() > 0)
     {
-      Int POCIndex = POCCurr%m_uiIntraPeriod;
+      Int POCIndex = (POCCurr - m_cGOPEncoder.getLastSceneCutPOC())%m_uiIntraPeriod;
       if(POCIndex == 0)
       {
         POCIndex = m_uiIntraPeriod;
@@ -1058,7 +1180,7 @@ Int TEncTop::getReferencePictureSetIdxForSOP(TComSlice* slice, Int POCCurr, Int
     }
     else
     {
-      if(POCCurr==m_GOPList[extraNum].m_POC)
+      if(POCCurr - m_cGOPEncoder.getLastSceneCutPOC()==m_GOPList[extraNum].m_POC)
       {
         rpsIdx = extraNum;
       }
@@ -57,6 +57,8 @@
 #include "TEncSampleAdaptiveOffset.h"
 #include "TEncPreanalyzer.h"
 #include "TEncRateCtrl.h"
+#include "TEncAccessUnitSink.h"
+#include "TEncCuAnalysis.h"
 //! \ingroup TLibEncoder
 //! \{
 
@@ -122,6 +124,16 @@ private:
   TComScalingList         m_scalingList;                 ///< quantization matrix information
   TEncRateCtrl            m_cRateCtrl;                    ///< Rate control class
 
+  // scene cut detection
+  std::vector<Int>        m_sceneCutBlockMean;            ///< 8x8 luma block averages of the previous original picture
+  Double                  m_sceneCutLastDiff;             ///< block difference between the two previous original pictures
+
+  TEncAccessUnitSink*     m_pcAccessUnitSink;             ///< receiver of finished access units, NULL to return them from encode()
+
+  // CU decisions shared with other encodes of the same source
+  TEncCuAnalysis*         m_pcCuAnalysisOutput;           ///< receives the final CU decisions of each coded picture, NULL if not stored
+  TEncCuAnalysis*         m_pcCuAnalysisInput;            ///< CU decisions of a reference encode used as search hints, NULL for a full search
+
 protected:
   Void  xGetNewPicBuffer  ( TComPic*& rpcPic );           ///< get picture buffer which will be processed
   Void  xInitSPS          ();                             ///< initialize SPS from encoder options
@@ -129,6 +141,7 @@ protected:
 
   Void  xInitPPSforTiles  ();
   Void  xInitRPS          (Bool isFieldCoding);           ///< initialize PPS from encoder options
+  Bool  xDetectSceneCut   ( TComPicYuv* pcPicYuvOrg );    ///< check whether a new scene starts with the given original picture
 
 public:
   TEncTop();
@@ -175,6 +188,12 @@ public:
   Void selectReferencePictureSet(TComSlice* slice, Int POCCurr, Int GOPid );
   Int getReferencePictureSetIdxForSOP(TComSlice* slice, Int POCCurr, Int GOPid );
   TComScalingList*        getScalingList        () { return  &m_scalingList;         }
+  TEncAccessUnitSink*     getAccessUnitSink     () { return  m_pcAccessUnitSink;      }
+  Void                    setAccessUnitSink     ( TEncAccessUnitSink* p ) { m_pcAccessUnitSink = p; }
+  TEncCuAnalysis*         getCuAnalysisOutput   () { return  m_pcCuAnalysisOutput;    }
+  Void                    setCuAnalysisOutput   ( TEncCuAnalysis* p ) { m_pcCuAnalysisOutput = p; }   ///< set before init()
+  TEncCuAnalysis*         getCuAnalysisInput    () { return  m_pcCuAnalysisInput;     }
+  Void                    setCuAnalysisInput    ( TEncCuAnalysis* p ) { m_pcCuAnalysisInput = p; }    ///< set before init()
   // -------------------------------------------------------------------------------------------------------------------
   // encoder function
   // -------------------------------------------------------------------------------------------------------------------
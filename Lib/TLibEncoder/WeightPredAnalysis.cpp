@@ -41,13 +41,134 @@
 #include "../TLibCommon/TComPicYuv.h"
 #include "WeightPredAnalysis.h"
 
+#if SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
 #define ABS(a)    ((a) < 0 ? - (a) : (a))
 #define DTHRESH (0.99)
 
+// ====================================================================================================================
+// Local functions
+// ====================================================================================================================
+
+/** Sum of the samples of a plane
+ * \param pPel    top-left sample
+ * \param iStride plane stride
+ * \param iWidth  plane width
+ * \param iHeight plane height
+ * \returns sum of the samples
+ */
+static Int64 xCalcPlaneSum( const Pel* pPel, Int iStride, Int iWidth, Int iHeight )
+{
+  Int64 iSum = 0;
+  Int   x0   = 0;
+
+#if SIMD_SSE2 && !RExt__HIGH_BIT_DEPTH_SUPPORT
+  // the 32-bit lanes are emptied after each row
+  const __m128i vOne  = _mm_set1_epi16( 1 );
+  const __m128i vZero = _mm_setzero_si128();
+  __m128i       vSum  = vZero;
+  x0 = iWidth & ~7;
+
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    const Pel* pRow = pPel + y * iStride;
+    __m128i    vRow = vZero;
+    for ( Int x = 0; x < x0; x += 8 )
+    {
+      vRow = _mm_add_epi32( vRow, _mm_madd_epi16( _mm_loadu_si128( (const __m128i*)( pRow + x ) ), vOne ) );
+    }
+    vSum = _mm_add_epi64( vSum, _mm_unpacklo_epi32( vRow, vZero ) );
+    vSum = _mm_add_epi64( vSum, _mm_unpackhi_epi32( vRow, vZero ) );
+  }
+
+  vSum = _mm_add_epi64( vSum, _mm_unpackhi_epi64( vSum, vSum ) );
+  _mm_storel_epi64( (__m128i*)&iSum, vSum );
+#endif
+
+  for ( Int y = 0; y < iHeight; y++, pPel += iStride )
+  {
+    for ( Int x = x0; x < iWidth; x++ )
+    {
+      iSum += pPel[x];
+    }
+  }
+  return iSum;
+}
+
+/** Sum of the absolute deviations of the samples of a plane from a value
+ * \param pPel    top-left sample
+ * \param iStride plane stride
+ * \param iWidth  plane width
+ * \param iHeight plane height
+ * \param iMean   value the deviations are measured from
+ * \returns sum of the absolute deviations
+ */
+static Int64 xCalcPlaneAbsDev( const Pel* pPel, Int iStride, Int iWidth, Int iHeight, Int iMean )
+{
+  Int64 iAbsDev = 0;
+  Int   x0      = 0;
+
+#if SIMD_SSE2 && !RExt__HIGH_BIT_DEPTH_SUPPORT
+  // the deviations of up to 14-bit data fit into 16 bits
+  if ( g_bitDepth[CHANNEL_TYPE_LUMA] <= 14 && g_bitDepth[CHANNEL_TYPE_CHROMA] <= 14 )
+  {
+    const __m128i vOne  = _mm_set1_epi16( 1 );
+    const __m128i vZero = _mm_setzero_si128();
+    const __m128i vMean = _mm_set1_epi16( Short( iMean ) );
+    __m128i       vSum  = vZero;
+    x0 = iWidth & ~7;
+
+    for ( Int y = 0; y < iHeight; y++ )
+    {
+      const Pel* pRow = pPel + y * iStride;
+      __m128i    vRow = vZero;
+      for ( Int x = 0; x < x0; x += 8 )
+      {
+        const __m128i vDev = _mm_sub_epi16( _mm_loadu_si128( (const __m128i*)( pRow + x ) ), vMean );
+        vRow = _mm_add_epi32( vRow, _mm_madd_epi16( _mm_max_epi16( vDev, _mm_sub_epi16( vZero, vDev ) ), vOne ) );
+      }
+      vSum = _mm_add_epi64( vSum, _mm_unpacklo_epi32( vRow, vZero ) );
+      vSum = _mm_add_epi64( vSum, _mm_unpackhi_epi32( vRow, vZero ) );
+    }
+
+    vSum = _mm_add_epi64( vSum, _mm_unpackhi_epi64( vSum, vSum ) );
+    _mm_storel_epi64( (__m128i*)&iAbsDev, vSum );
+  }
+#endif
+
+  for ( Int y = 0; y < iHeight; y++, pPel += iStride )
+  {
+    for ( Int x = x0; x < iWidth; x++ )
+    {
+      iAbsDev += abs( (Int)pPel[x] - iMean );
+    }
+  }
+  return iAbsDev;
+}
+
+#if SIMD_SSE2 && !RExt__HIGH_BIT_DEPTH_SUPPORT
+/** |(org << log2Denom) - (ref * weight + offsetTerm)| of four samples held in the low halves of 32-bit lanes
+ */
+static inline __m128i xAbsDiffWP( __m128i vOrg, __m128i vRef, __m128i vLog2Denom, __m128i vWeight, __m128i vOffsetTerm )
+{
+  const __m128i vDiff = _mm_sub_epi32( _mm_sub_epi32( _mm_sll_epi32( vOrg, vLog2Denom ), _mm_madd_epi16( vRef, vWeight ) ), vOffsetTerm );
+  const __m128i vSign = _mm_srai_epi32( vDiff, 31 );
+  return _mm_sub_epi32( _mm_xor_si128( vDiff, vSign ), vSign );
+}
+#endif
+
+// ====================================================================================================================
+// Class member functions
+// ====================================================================================================================
+
 WeightPredAnalysis::WeightPredAnalysis()
 {
   m_weighted_pred_flag = false;
   m_weighted_bipred_flag = false;
+  m_pcAcDcPicYuv = NULL;
+  m_iAcDcPOC = 0;
 
   for ( UInt lst =0 ; lst<NUM_REF_PIC_LIST_01 ; lst++ )
   {
@@ -69,12 +190,20 @@ WeightPredAnalysis::WeightPredAnalysis()
 /** calculate AC and DC values for current original image
  * \param TComSlice *slice
  * \returns Void
+ *
+ * The values of the last picture are kept, so that they are computed once for all slices of a picture.
  */
 Void WeightPredAnalysis::xCalcACDCParamSlice(TComSlice *const slice)
 {
   //===== calculate AC/DC value =====
   TComPicYuv*   pPic = slice->getPic()->getPicYuvOrg();
 
+  if (pPic == m_pcAcDcPicYuv && slice->getPOC() == m_iAcDcPOC)
+  {
+    slice->setWpAcDcParam(m_acDcParam);
+    return;
+  }
+
   WPACDCParam weightACDCParam[MAX_NUM_COMPONENT];
 
   for(Int componentIndex = 0; componentIndex < pPic->getNumberValidComponents(); componentIndex++)
@@ -89,25 +218,9 @@ Void WeightPredAnalysis::xCalcACDCParamSlice(TComSlice *const slice)
 
     const Int iSample = iWidth*iHeight;
 
-    Int64 iOrgDC = 0;
-    {
-      const Pel *pPel = pPic->getAddr(compID);
-
-      for(Int y = 0; y < iHeight; y++, pPel+=iStride )
-        for(Int x = 0; x < iWidth; x++ )
-          iOrgDC += (Int)( pPel[x] );
-    }
-
+    const Int64 iOrgDC     = xCalcPlaneSum(pPic->getAddr(compID), iStride, iWidth, iHeight);
     const Int64 iOrgNormDC = ((iOrgDC+(iSample>>1)) / iSample);
-
-    Int64 iOrgAC = 0;
-    {
-      const Pel *pPel = pPic->getAddr(compID);
-
-      for(Int y = 0; y < iHeight; y++, pPel += iStride )
-        for(Int x = 0; x < iWidth; x++ )
-          iOrgAC += abs( (Int)pPel[x] - (Int)iOrgNormDC );
-    }
+    const Int64 iOrgAC     = xCalcPlaneAbsDev(pPic->getAddr(compID), iStride, iWidth, iHeight, (Int)iOrgNormDC);
 
     const Int fixedBitShift = (slice->getSPS()->getUseHighPrecisionPredictionWeighting())?RExt__PREDICTION_WEIGHTING_ANALYSIS_DC_PRECISION:0;
     weightACDCParam[compID].iDC = (((iOrgDC<<fixedBitShift)+(iSample>>1)) / iSample);
@@ -115,6 +228,10 @@ Void WeightPredAnalysis::xCalcACDCParamSlice(TComSlice *const slice)
   }
 
   slice->setWpAcDcParam(weightACDCParam);
+
+  memcpy(m_acDcParam, weightACDCParam, sizeof(m_acDcParam));
+  m_pcAcDcPicYuv = pPic;
+  m_iAcDcPOC     = slice->getPOC();
 }
 
 
@@ -189,8 +306,9 @@ Void  WeightPredAnalysis::xCheckWPEnable(TComSlice *const slice)
 
 /** estimate wp tables for explicit wp
  * \param TComSlice *slice
+ * \param bFastSelect estimate the SADs of the WP decision on every second sample of every second row
  */
-Void WeightPredAnalysis::xEstimateWPParamSlice(TComSlice *const slice)
+Void WeightPredAnalysis::xEstimateWPParamSlice(TComSlice *const slice, const Bool bFastSelect)
 {
   Int  iDenom         = 6;
   Bool validRangeFlag = false;
@@ -210,7 +328,7 @@ Void WeightPredAnalysis::xEstimateWPParamSlice(TComSlice *const slice)
   } while (validRangeFlag == false);
 
   // selecting whether WP is used, or not
-  xSelectWP(slice, iDenom);
+  xSelectWP(slice, iDenom, bFastSelect);
 
   slice->setWpScaling( m_wp );
 }
@@ -291,14 +409,16 @@ Bool WeightPredAnalysis::xUpdatingWPParameters(TComSlice *const slice, const Int
 /** select whether weighted pred enables or not.
  * \param TComSlice *slice
  * \param log2Denom
+ * \param bFastSelect estimate the SADs on every second sample of every second row
  * \returns Bool
  */
-Bool WeightPredAnalysis::xSelectWP(TComSlice *const slice, const Int log2Denom)
+Bool WeightPredAnalysis::xSelectWP(TComSlice *const slice, const Int log2Denom, const Bool bFastSelect)
 {
         TComPicYuv *const pPic                                = slice->getPic()->getPicYuvOrg();
   const Int               iDefaultWeight                      = ((Int)1<<log2Denom);
   const Int               iNumPredDir                         = slice->isInterP() ? 1 : 2;
   const Bool              useHighPrecisionPredictionWeighting = slice->getSPS()->getUseHighPrecisionPredictionWeighting();
+  const Int               iStep                               = bFastSelect ? 2 : 1;
 
   assert (iNumPredDir <= Int(NUM_REF_PIC_LIST_01));
 
@@ -322,8 +442,8 @@ Bool WeightPredAnalysis::xSelectWP(TComSlice *const slice, const Int log2Denom)
         const Int          bitDepth   = g_bitDepth[toChannelType(compID)];
 
         // calculate SAD costs with/without wp for luma
-        iSADWP   += xCalcSADvalueWP(bitDepth, pOrg, pRef, iWidth, iHeight, iOrgStride, iRefStride, log2Denom, m_wp[iRefList][iRefIdxTemp][compID].iWeight, m_wp[iRefList][iRefIdxTemp][compID].iOffset, useHighPrecisionPredictionWeighting);
-        iSADnoWP += xCalcSADvalueWP(bitDepth, pOrg, pRef, iWidth, iHeight, iOrgStride, iRefStride, log2Denom, iDefaultWeight, 0, useHighPrecisionPredictionWeighting);
+        iSADWP   += xCalcSADvalueWP(bitDepth, pOrg, pRef, iWidth, iHeight, iOrgStride, iRefStride, log2Denom, m_wp[iRefList][iRefIdxTemp][compID].iWeight, m_wp[iRefList][iRefIdxTemp][compID].iOffset, useHighPrecisionPredictionWeighting, iStep);
+        iSADnoWP += xCalcSADvalueWP(bitDepth, pOrg, pRef, iWidth, iHeight, iOrgStride, iRefStride, log2Denom, iDefaultWeight, 0, useHighPrecisionPredictionWeighting, iStep);
       }
 
       const Double dRatio = ((Double)iSADWP / (Double)iSADnoWP);
@@ -354,7 +474,8 @@ Bool WeightPredAnalysis::xSelectWP(TComSlice *const slice, const Int log2Denom)
  * \param Int iLog2Denom
  * \param Int iWeight
  * \param Int iOffset
- * \returns Int64
+ * \param Int iStep    1: all samples, 2: every second sample of every second row
+ * \returns Int64     mean absolute difference
  */
 Int64 WeightPredAnalysis::xCalcSADvalueWP(const Int   bitDepth,
                                           const Pel  *pOrgPel,
@@ -366,20 +487,69 @@ Int64 WeightPredAnalysis::xCalcSADvalueWP(const Int   bitDepth,
                                           const Int   iLog2Denom,
                                           const Int   iWeight,
                                           const Int   iOffset,
-                                          const Bool  useHighPrecisionPredictionWeighting)
+                                          const Bool  useHighPrecisionPredictionWeighting,
+                                          const Int   iStep)
 {
-  const Int64 iSize          = iWidth*iHeight;
   const Int64 iRealLog2Denom = useHighPrecisionPredictionWeighting ? iLog2Denom : (iLog2Denom + (bitDepth - 8));
+  const Int64 iOffsetTerm    = (Int64)iOffset << iRealLog2Denom;
+
+  Int64 iSAD  = 0;
+  Int64 iSize = 0;
+  Int   x0    = 0;
+
+#if SIMD_SSE2 && !RExt__HIGH_BIT_DEPTH_SUPPORT
+  // all terms of up to 12-bit data fit into 32 bits; the differences are accumulated in 64 bits
+  if ( bitDepth <= 12 && iWeight >= -32768 && iWeight <= 32767 )
+  {
+    const __m128i vZero       = _mm_setzero_si128();
+    const __m128i vEvenMask   = _mm_set1_epi32( 0xffff );
+    const __m128i vLog2Denom  = _mm_cvtsi32_si128( iLog2Denom );
+    const __m128i vWeight     = _mm_set1_epi32( iWeight & 0xffff );
+    const __m128i vOffsetTerm = _mm_set1_epi32( (Int)iOffsetTerm );
+    __m128i       vSAD        = vZero;
+    x0 = iWidth & ~7;
+
+    for ( Int y = 0; y < iHeight; y += iStep )
+    {
+      const Pel* pOrgRow = pOrgPel + y * iOrgStride;
+      const Pel* pRefRow = pRefPel + y * iRefStride;
+      for ( Int x = 0; x < x0; x += 8 )
+      {
+        const __m128i vOrg = _mm_loadu_si128( (const __m128i*)( pOrgRow + x ) );
+        const __m128i vRef = _mm_loadu_si128( (const __m128i*)( pRefRow + x ) );
+        if ( iStep == 1 )
+        {
+          const __m128i vLo = xAbsDiffWP( _mm_unpacklo_epi16( vOrg, vZero ), _mm_unpacklo_epi16( vRef, vZero ), vLog2Denom, vWeight, vOffsetTerm );
+          const __m128i vHi = xAbsDiffWP( _mm_unpackhi_epi16( vOrg, vZero ), _mm_unpackhi_epi16( vRef, vZero ), vLog2Denom, vWeight, vOffsetTerm );
+          vSAD = _mm_add_epi64( vSAD, _mm_unpacklo_epi32( vLo, vZero ) );
+          vSAD = _mm_add_epi64( vSAD, _mm_unpackhi_epi32( vLo, vZero ) );
+          vSAD = _mm_add_epi64( vSAD, _mm_unpacklo_epi32( vHi, vZero ) );
+          vSAD = _mm_add_epi64( vSAD, _mm_unpackhi_epi32( vHi, vZero ) );
+        }
+        else
+        {
+          const __m128i vEven = xAbsDiffWP( _mm_and_si128( vOrg, vEvenMask ), _mm_and_si128( vRef, vEvenMask ), vLog2Denom, vWeight, vOffsetTerm );
+          vSAD = _mm_add_epi64( vSAD, _mm_unpacklo_epi32( vEven, vZero ) );
+          vSAD = _mm_add_epi64( vSAD, _mm_unpackhi_epi32( vEven, vZero ) );
+        }
+      }
+      iSize += x0 / iStep;
+    }
+
+    vSAD = _mm_add_epi64( vSAD, _mm_unpackhi_epi64( vSAD, vSAD ) );
+    _mm_storel_epi64( (__m128i*)&iSAD, vSAD );
+  }
+#endif
 
-  Int64 iSAD = 0;
-  for( Int y = 0; y < iHeight; y++ )
+  for( Int y = 0; y < iHeight; y += iStep )
   {
-    for( Int x = 0; x < iWidth; x++ )
+    for( Int x = x0; x < iWidth; x += iStep )
     {
-      iSAD += ABS(( ((Int64)pOrgPel[x]<<(Int64)iLog2Denom) - ( (Int64)pRefPel[x] * (Int64)iWeight + ((Int64)iOffset<<iRealLog2Denom) ) ) );
+      iSAD += ABS(( ((Int64)pOrgPel[x]<<(Int64)iLog2Denom) - ( (Int64)pRefPel[x] * (Int64)iWeight + iOffsetTerm ) ) );
+      iSize++;
     }
-    pOrgPel += iOrgStride;
-    pRefPel += iRefStride;
+    pOrgPel += iOrgStride * iStep;
+    pRefPel += iRefStride * iStep;
   }
 
   return (iSAD/iSize);
@@ -50,9 +50,14 @@ private:
   Bool            m_weighted_bipred_flag;
   WPScalingParam  m_wp[NUM_REF_PIC_LIST_01][MAX_NUM_REF][MAX_NUM_COMPONENT];
 
+  // AC/DC values of the last original picture, shared by all of its slices
+  const TComPicYuv* m_pcAcDcPicYuv;
+  Int             m_iAcDcPOC;
+  WPACDCParam     m_acDcParam[MAX_NUM_COMPONENT];
+
   // member functions
 
-  Bool  xSelectWP            (TComSlice *const slice, const Int log2Denom);
+  Bool  xSelectWP            (TComSlice *const slice, const Int log2Denom, const Bool bFastSelect);
   Bool  xUpdatingWPParameters(TComSlice *const slice, const Int log2Denom);
 
   Int64 xCalcSADvalueWP      (const Int   bitDepth,
@@ -65,7 +70,8 @@ private:
                               const Int   iLog2Denom,
                               const Int   iWeight,
                               const Int   iOffset,
-                              const Bool  useHighPrecisionPredictionWeighting);
+                              const Bool  useHighPrecisionPredictionWeighting,
+                              const Int   iStep);
 
 public:
 
@@ -73,7 +79,7 @@ public:
 
   // WP analysis :
   Void  xCalcACDCParamSlice  (TComSlice *const slice);
-  Void  xEstimateWPParamSlice(TComSlice *const slice);
+  Void  xEstimateWPParamSlice(TComSlice *const slice, const Bool bFastSelect);
   Void  xStoreWPparam        (const Bool weighted_pred_flag, const Bool weighted_bipred_flag);
   Void  xRestoreWPparam      (TComSlice *const slice);
   Void  xCheckWPEnable       (TComSlice *const slice);
@@ -36,12 +36,16 @@
 */
 
 #include <cstdlib>
+#include <cstring>
 #include <fcntl.h>
 #include <assert.h>
 #include <sys/stat.h>
 #include <fstream>
 #include <iostream>
 #include <memory.h>
+#ifdef _WIN32
+#include <io.h>
+#endif
 
 #include "TLibCommon/TComRom.h"
 #include "TVideoIOYuv.h"
@@ -101,7 +105,7 @@ static Void scalePlane(Pel* img, const UInt stride, const UInt width, const UInt
  * (See scalePlane(), TVideoIOYuv::read() and TVideoIOYuv::write() for
  * further details).
  *
- * \param pchFile          file name string
+ * \param pchFile          file name string, in read mode "-" reads from the standard input (e.g. a pipe)
  * \param bWriteMode       file open mode: true=read, false=write
  * \param fileBitDepth     bit-depth array of input/output file data.
  * \param internalBitDepth bit-depth array to scale image data to/from when reading/writing.
@@ -139,6 +143,14 @@ Void TVideoIOYuv::open( Char* pchFile, Bool bWriteMode, const Int fileBitDepth[M
       exit(0);
     }
   }
+  else if ( !strcmp( pchFile, "-" ) )
+  {
+#ifdef _WIN32
+    // the standard input is opened in text mode on Windows
+    _setmode( _fileno( stdin ), _O_BINARY );
+#endif
+    m_pcInput = &std::cin;
+  }
   else
   {
     m_cHandle.open( pchFile, ios::binary | ios::in );
@@ -148,6 +160,7 @@ Void TVideoIOYuv::open( Char* pchFile, Bool bWriteMode, const Int fileBitDepth[M
       printf("\nfailed to open Input YUV file\n");
       exit(0);
     }
+    m_pcInput = &m_cHandle;
   }
 
   return;
@@ -155,17 +168,21 @@ Void TVideoIOYuv::open( Char* pchFile, Bool bWriteMode, const Int fileBitDepth[M
 
 Void TVideoIOYuv::close()
 {
-  m_cHandle.close();
+  if ( m_cHandle.is_open() )
+  {
+    m_cHandle.close();
+  }
+  m_pcInput = NULL;
 }
 
 Bool TVideoIOYuv::isEof()
 {
-  return m_cHandle.eof();
+  return m_pcInput ? m_pcInput->eof() : m_cHandle.eof();
 }
 
 Bool TVideoIOYuv::isFail()
 {
-  return m_cHandle.fail();
+  return m_pcInput ? m_pcInput->fail() : m_cHandle.fail();
 }
 
 /**
@@ -195,18 +212,18 @@ Void TVideoIOYuv::skipFrames(UInt numFrames, UInt width, UInt height, ChromaForm
   const streamoff offset = frameSize * numFrames;
 
   /* attempt to seek */
-  if (!!m_cHandle.seekg(offset, ios::cur))
+  if (!!m_pcInput->seekg(offset, ios::cur))
     return; /* success */
-  m_cHandle.clear();
+  m_pcInput->clear();
 
   /* fall back to consuming the input */
   Char buf[512];
   const UInt offset_mod_bufsize = offset % sizeof(buf);
   for (streamoff i = 0; i < offset - offset_mod_bufsize; i += sizeof(buf))
   {
-    m_cHandle.read(buf, sizeof(buf));
+    m_pcInput->read(buf, sizeof(buf));
   }
-  m_cHandle.read(buf, offset_mod_bufsize);
+  m_pcInput->read(buf, offset_mod_bufsize);
 }
 
 /**
@@ -269,7 +286,11 @@ static Bool readPlane(Pel* dst,
     if (fileFormat!=CHROMA_400)
     {
       const UInt height_file      = height444>>csy_file;
-      fd.seekg(height_file*stride_file, ios::cur);
+      // read and discard the unused chroma, as the input may be a pipe
+      for (UInt y = 0; y < height_file; y++)
+      {
+        fd.read(reinterpret_cast<Char*>(buf), stride_file);
+      }
       if (fd.eof() || fd.fail() )
       {
         delete[] buf;
@@ -672,7 +693,7 @@ Bool TVideoIOYuv::read ( TComPicYuv*  pPicYuvUser, TComPicYuv* pPicYuvTrueOrg, c
     const Pel maxval = b709Compliance? ((0xff << (desired_bitdepth - 8)) -1) : (1 << desired_bitdepth) - 1;
 #endif
 
-    if (! readPlane(pPicYuv->getAddr(compID), m_cHandle, is16bit, stride444, width444, height444, pad_h444, pad_v444, compID, pPicYuv->getChromaFormat(), format, m_fileBitdepth[chType]))
+    if (! readPlane(pPicYuv->getAddr(compID), *m_pcInput, is16bit, stride444, width444, height444, pad_h444, pad_v444, compID, pPicYuv->getChromaFormat(), format, m_fileBitdepth[chType]))
     {
       return false;
     }